@@ -8,7 +8,9 @@
 
 #ifdef __cplusplus
 
+#include <chrono>
 #include <functional>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
@@ -33,6 +35,28 @@ namespace egihash
 		*/
 		static constexpr uint64_t DAG_FILE_MINIMUM_SIZE = 1090516864;
 
+		/** \brief CACHE_MAGIC_BYTES is the starting sequence of a cache file, used for identification.
+		*/
+		static constexpr char CACHE_MAGIC_BYTES[] = "EGIHASH_CACHE";
+
+		/** \brief CACHE_FILE_HEADER_SIZE is the expected size of a cache file header.
+		*
+		*	The cache data directly follows the header, so it is suitably aligned when the file is memory mapped.
+		*/
+		static constexpr uint32_t CACHE_FILE_HEADER_SIZE = 128u;
+
+		/** \brief DAG_TRAILER_MAGIC_BYTES is the starting sequence of the optional checksum trailer following the DAG data in a DAG file.
+		*/
+		static constexpr char DAG_TRAILER_MAGIC_BYTES[] = "EGIHASH_SUM";
+
+		/** \brief DAG_FILE_TRAILER_SIZE is the expected size of a DAG file checksum trailer.
+		*/
+		static constexpr uint32_t DAG_FILE_TRAILER_SIZE = 24u;
+
+		/** \brief VERIFY_SAMPLE_COUNT is the default number of DAG items recomputed by sampled verification.
+		*/
+		static constexpr uint32_t VERIFY_SAMPLE_COUNT = 1024u;
+
 		/** \brief CALLBACK_FREQUENCY determines how often callbacks will be called.
 		*
 		*	1 means every iteration, 10 means every 10th iteration, and so on...
@@ -89,6 +113,16 @@ namespace egihash
 		*/
 		static constexpr uint32_t HASH_BYTES = 64u;
 
+		/** \brief The number of hash words in a cache or DAG item.
+		*/
+		static constexpr uint32_t HASH_WORDS = HASH_BYTES / WORD_BYTES;
+
+		/** \brief The number of bytes transferred at a time when loading or saving a cache or DAG.
+		*
+		*	This is a whole number of items, chosen so progress callbacks are called every constants::CALLBACK_FREQUENCY items.
+		*/
+		static constexpr uint32_t IO_CHUNK_BYTES = HASH_BYTES * CALLBACK_FREQUENCY;
+
 		/** \brief The number of parents for each element in the DAG.
 		*/
 		static constexpr uint32_t DATASET_PARENTS = 256u;
@@ -100,6 +134,14 @@ namespace egihash
 		/** \brief The number of DAG lookups to compute an egihash.
 		*/
 		static constexpr uint32_t ACCESSES = 64u;
+
+		/** \brief The number of hashes full::hash_batch interleaves, and so the number of DAG reads it keeps in flight at once.
+		*/
+		static constexpr uint32_t HASH_BATCH_LANES = 16u;
+
+		/** \brief The number of epochs cache_t::get_epoch() searches for a seedhash it has not seen yet.
+		*/
+		static constexpr uint32_t SEEDHASH_SEARCH_EPOCHS = 2048u;
 	}
 
 	/** \brief node union is used instead of the native integer to allow both bytes level access and as a 4 byte hash word
@@ -125,6 +167,79 @@ namespace egihash
 	#pragma pack(pop)
 	static_assert(sizeof(node) == sizeof(uint32_t), "Invalid hash node size");
 
+	/** \brief data_view_t is a read only view of the items stored contiguously by a cache_t or dag_t.
+	*
+	*	Each item is constants::HASH_BYTES bytes, or constants::HASH_WORDS nodes, long.
+	*/
+	class data_view_t
+	{
+	public:
+		/** \brief size_type represents sizes and indices used by a data_view_t.
+		*/
+		using size_type = ::std::size_t;
+
+		/** \brief Construct an empty data_view_t.
+		*/
+		data_view_t() noexcept
+		: items(nullptr)
+		, count(0)
+		{
+		}
+
+		/** \brief Construct a data_view_t over existing items.
+		*
+		*	\param items points to the first node of the first item.
+		*	\param count is the number of items (not nodes) in the view.
+		*/
+		data_view_t(node const * items, size_type count) noexcept
+		: items(items)
+		, count(count)
+		{
+		}
+
+		/** \brief Get an item.
+		*
+		*	\param index is the index of the item to get.
+		*	\return pointer to the constants::HASH_WORDS nodes of the item.
+		*/
+		node const * operator[](size_type index) const noexcept
+		{
+			return items + (index * constants::HASH_WORDS);
+		}
+
+		/** \brief Get the number of items in this view.
+		*/
+		size_type size() const noexcept
+		{
+			return count;
+		}
+
+		/** \brief Get the number of bytes in this view.
+		*/
+		size_type size_bytes() const noexcept
+		{
+			return count * constants::HASH_BYTES;
+		}
+
+		/** \brief Test if this view contains no items.
+		*/
+		bool empty() const noexcept
+		{
+			return count == 0;
+		}
+
+		/** \brief Get a pointer to the first node in this view.
+		*/
+		node const * data() const noexcept
+		{
+			return items;
+		}
+
+	private:
+		node const * items;
+		size_type count;
+	};
+
 
 	/** \brief hash_exception indicates an error or cancellation when performing a task within egihash.
 	*
@@ -338,6 +453,15 @@ namespace egihash
 	*/
 	static constexpr result_t empty_result;
 
+	/** \brief Determine whether a hash meets a boundary.
+	*
+	*	Both are compared as 256-bit big endian numbers, 64 bits at a time.
+	*	\param hash is the hash to check, typically result_t::value.
+	*	\param boundary is the largest acceptable hash, typically 2^256 / difficulty.
+	*	\return bool true if hash is less than or equal to boundary, false otherwise.
+	*/
+	bool meets_boundary(h256_t const & hash, h256_t const & boundary) noexcept;
+
 	/** \brief progress_callback_phase values represent different stages at which a progress callback may be called.
 	*/
 	enum progress_callback_phase
@@ -348,7 +472,8 @@ namespace egihash
 		cache_loading,		/**< cache_loading is loading the cache from disk */
 		dag_generation,		/**< dag_generation is computing the DAG for a given epoch (block_number) */
 		dag_saving,			/**< dag_saving is saving the DAG to disk */
-		dag_loading			/**< dag_loading is loading the DAG from disk */
+		dag_loading,		/**< dag_loading is loading the DAG from disk */
+		dag_verification	/**< dag_verification is checking the DAG against its cache or checksum */
 	};
 
 	/** \brief progress_callback_type is a function which may be passed to any phase of DAG/cache or generation to receive progress updates.
@@ -360,272 +485,1487 @@ namespace egihash
 	*/
 	using progress_callback_type = ::std::function<bool (::std::size_t step, ::std::size_t max, progress_callback_phase phase)>;
 
-	/** \brief read_function_type is a function which passed to various objects which perform loading of a file, such as the cache and DAG.
-	*
-	*	Note that this function will own whatever data it needs to perform the read, i.e. the filestream.
-	*	\param dst points to the memory location that should be read into.
-	*	\param count represents the number of bytes to read.
-	*	\throws hash_exception if the read failed
-	*/
-	using read_function_type = ::std::function<void(void * dst, ::std::size_t count)>;
-
-	/** \brief cache_t is the cache used to compute a DAG for a given epoch.
+	/** \brief cancel_token_t asks work in progress to stop, and is checked cooperatively by every thread doing the work.
 	*
-	* Each DAG owns a cache_t and the size of the cache grows linearly in time.
+	*	Copies of a cancel_token_t share the same state, so a token may be handed to the work and cancelled from any thread.
 	*/
-	struct cache_t
+	struct cancel_token_t
 	{
-		/** \brief size_type represents sizes used by a cache.
-		*/
-		using size_type = uint64_t;
-
-		/** \brief data_type is the underlying data store which stores a cache.
-		*/
-		using data_type = ::std::vector<::std::vector<node>>;
-
-		/** \brief default copy constructor.
+		/** \brief create a token which has not been cancelled.
 		*/
-		cache_t(const cache_t &) = default;
+		cancel_token_t();
 
-		/** \brief default copy assignment operator.
+		/** \brief Ask the work checking this token to stop, it then throws hash_exception at its next check.
 		*/
-		cache_t & operator=(cache_t const &) = default;
+		void cancel() const noexcept;
 
-		/** \brief default move constructor.
+		/** \brief Determine whether cancel() was called on this token or a copy of it.
+		*
+		*	\return bool true if the work should stop, false otherwise.
 		*/
-		cache_t(cache_t &&) = default;
+		bool is_cancelled() const noexcept;
 
-		/** \brief default move assignment operator.
+		/** \brief cancel_token_t private implementation.
 		*/
-		cache_t & operator=(cache_t &&) = default;
+		struct impl_t;
 
-		/** \brief default destructor.
+		/** \brief shared_ptr to impl allows copies of a token to share whether it was cancelled.
 		*/
-		~cache_t() = default;
+		::std::shared_ptr<impl_t> impl;
+	};
 
-		/** \brief explicitly deleted default constructor.
+	/** \brief progress_t is the progress of caches and DAGs being generated, loaded, saved or verified, which may be polled from any thread.
+	*
+	*	The step and max of each progress_callback_phase are kept in atomic counters, so a monitor can read them at any time without
+	*	the work calling back into it. A progress_t is itself a progress_callback_type, so it is passed wherever a callback is taken.
+	*	Work which is spread across threads recognizes a progress_t and has every thread report to it and check its cancel_token_t.
+	*	Copies of a progress_t share the same counters.
+	*/
+	struct progress_t
+	{
+		/** \brief create progress with its own cancel_token_t.
 		*/
-		cache_t() = delete;
+		progress_t();
 
-		/** \brief Construct a cache_t given a block number and a progress callback function.
+		/** \brief create progress which stops the work once token is cancelled.
 		*
-		*	\param block_number is the block number for which this cache_t is to be constructed.
-		*	\param callback (optional) may be used to monitor the progress of cache generation. Return false to cancel, true to continue.
+		*	\param token is the cancel_token_t checked by the work.
+		*	\param observer (optional) is called with each report, from one reporting thread at a time. Returning false cancels token.
+		*	If another thread is in the observer, a report skips it rather than waiting.
 		*/
-		cache_t(uint64_t block_number, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+		explicit progress_t(cancel_token_t const & token, progress_callback_type observer = nullptr);
 
-		/** \brief Get the epoch number for which this cache is valid.
+		/** \brief Record that step of max steps of a phase are done.
 		*
-		*	\returns uint64_t representing the epoch number (block_number / constants::EPOCH_LENGTH)
+		*	\param step is the count of steps done.
+		*	\param max is the count of steps the phase will take.
+		*	\param phase is the progress_callback_phase which is running.
+		*	\return bool false if the work has been cancelled, true to continue.
 		*/
-		uint64_t epoch() const;
+		bool operator()(::std::size_t step, ::std::size_t max, progress_callback_phase phase) const;
 
-		/** \brief Get the size of the cache data in bytes.
+		/** \brief Record that count more steps of a phase are done, for work spread across threads.
 		*
-		*	\returns size_type representing the size of the cache data in bytes.
+		*	\param count is the count of steps just done by the calling thread.
+		*	\param max is the count of steps the phase will take.
+		*	\param phase is the progress_callback_phase which is running.
+		*	\return bool false if the work has been cancelled, true to continue.
 		*/
-		size_type size() const;
+		bool advance(::std::size_t count, ::std::size_t max, progress_callback_phase phase) const;
 
-		/** \brief Get the data the cache contains.
-		*
-		*	\returns data_type const & to the actual cache data.
+		/** \brief Get the count of steps done in a phase.
 		*/
-		data_type const & data() const;
+		::std::size_t step(progress_callback_phase phase) const noexcept;
 
-		/** \brief Get the seedhash for this cache.
-		*
-		*	/returns h256_t seed hash for this cache.
+		/** \brief Get the count of steps a phase will take, or 0 if it has not been reported.
 		*/
-		h256_t seedhash() const;
+		::std::size_t max(progress_callback_phase phase) const noexcept;
 
-		/** \brief Unload cache.
-		*
-		*	To actually free a cache from memory, call this function on a cache.
-		*	The cache will then be released from the internal cache.
-		*	Once all references to the cache for this epoch are destroyed, it will be freed.
+		/** \brief Get the phase which was reported last.
 		*/
-		void unload() const;
+		progress_callback_phase phase() const noexcept;
 
-		/** \brief Get the size of the cache data in bytes.
-		*
-		*	\param block_number is the block number for which cache size to compute.
-		*	\returns size_type representing the size of the cache data in bytes.
+		/** \brief Get the cancel_token_t which stops the work.
 		*/
-		static size_type get_cache_size(uint64_t const block_number) noexcept;
+		cancel_token_t get_cancel_token() const;
 
-		/** \brief get_seedhash(uint64_t) will compute the seedhash for a given block number.
-		*
-		*	\param block_number An unsigned 64-bit integer representing the block number for which to compute the seed hash.
-		*	\return An h256_t keccak-256 seed hash for the given block number.
+		/** \brief Ask the work to stop, the same as cancelling the token.
 		*/
-		static h256_t get_seedhash(uint64_t const block_number);
+		void cancel() const noexcept;
 
-		/** \brief Determine whether the cache_t for this epoch is already loaded
-		*
-		*	\param epoch is the epoch number for which to determine if a cache_t is already loaded.
-		*	\return bool true if we have this cache_t epoch loaded, false otherwise.
+		/** \brief Determine whether the work has been cancelled.
 		*/
-		static bool is_loaded(uint64_t const epoch);
+		bool is_cancelled() const noexcept;
 
-		/** \brief Get the epoch numbers for which we already have a cache_t loaded.
+		/** \brief Get the progress a callback reports to.
 		*
-		*	\return ::std::vector containing epoch numbers for cache_t's that are already loaded.
+		*	\param callback is a progress_callback_type.
+		*	\return progress_t sharing the counters of callback if it holds a progress_t, otherwise new progress observed by callback.
 		*/
-		static ::std::vector<uint64_t> get_loaded();
+		static progress_t from_callback(progress_callback_type const & callback);
 
-		/** \brief cache_t internal implementation.
+		/** \brief progress_t private implementation.
 		*/
 		struct impl_t;
 
-	private:
-		friend struct dag_t;
-
-		/** \brief Construct a cache_t by loading from disk.
-		*
-		*	\param epoch is the number of the epoch for the cache we are loading.
-		*	\param size is the size in bytes of the cache we are loading.
-		*	\param read A function which will read cache data from disk.
-		*	\param callback (optional) may be used to monitor the progress of cache loading. Return false to cancel, true to continue.
+		/** \brief shared_ptr to impl allows copies of progress to share its counters.
 		*/
-		cache_t(uint64_t epoch, uint64_t size, read_function_type read, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+		::std::shared_ptr<impl_t> impl;
+	};
 
-		/** \brief Load a cache from disk.
-		*
-		*	\param read A function which will read cache data from disk.
-		*	\param callback (optional) may be used to monitor the progress of cache loading. Return false to cancel, true to continue.
+	/** \brief verify_mode values select how thoroughly a DAG is checked for corruption.
+	*/
+	enum verify_mode
+	{
+		verify_none,		/**< verify_none performs no verification */
+		verify_checksum,	/**< verify_checksum compares the DAG data to the checksum stored in the DAG file (falls back to verify_sampled if there is none) */
+		verify_sampled,		/**< verify_sampled recomputes a number of randomly chosen DAG items from the cache and compares them */
+		verify_full			/**< verify_full recomputes every DAG item from the cache in parallel and compares them */
+	};
+
+	/** \brief verify_policy_t determines the verification which is performed automatically whenever a DAG is loaded from a file.
+	*/
+	struct verify_policy_t
+	{
+		/** \brief The verification mode to run after loading.
 		*/
-		void load(read_function_type read, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+		verify_mode mode;
 
-		/** \brief shared_ptr to impl allows default moving/copying of cache. Internally, only one cache_t::impl_t per epoch will exist.
+		/** \brief The number of items to recompute when mode is verify_sampled.
 		*/
-		::std::shared_ptr<impl_t> impl;
+		uint32_t sample_count;
 	};
 
-	/** \brief dag_t is the DAG which is used by full nodes and miners to compute egihashes.
+	/** \brief page_mode values select the pages a DAG or cache is allocated in.
+	*/
+	enum page_mode
+	{
+		pages_normal,		/**< pages_normal allocates regular pages */
+		pages_huge			/**< pages_huge prefers 1 GiB then 2 MiB hugetlbfs pages, then transparent huge pages, then regular pages */
+	};
+
+	/** \brief page_backing values describe the pages a DAG or cache was actually allocated in.
 	*
-	*	The DAG gives egihash it's ASIC resistance, ensuring that this hashing function is memory bound not compute bound.
-	*	The DAG must be updated once per constants::EPOCH_LENGTH block numbers.
-	*	The DAG for epoch 0 is 1073739904 bytes in size and will grow linearly with each following epoch.
-	*	The DAG can take a long time to generate. It is recommended to save the DAG to disk to avoid having to regenerate it each time.
-	*	It makes sense to pre-compute the DAG for the next epoch, so generating it does not interrupt mining / operation of a full node.
-	*	Whether by generation or by loading, the DAG will own a cache_t which corresponds to cache for the same epoch.
+	*	Hashing makes random reads across the whole DAG, so huge pages avoid a TLB miss on nearly every read.
 	*/
-	struct dag_t
+	enum page_backing
 	{
-		/** \brief size_type represents sizes used by a cache.
-		*/
-		using size_type = ::std::size_t;
+		page_backing_normal,		/**< page_backing_normal is regular pages */
+		page_backing_transparent,	/**< page_backing_transparent is regular pages which the kernel was advised to back with transparent huge pages */
+		page_backing_huge_2m,		/**< page_backing_huge_2m is explicit 2 MiB hugetlbfs pages */
+		page_backing_huge_1g		/**< page_backing_huge_1g is explicit 1 GiB hugetlbfs pages */
+	};
+
+	/** \brief memory_lock_mode values select whether a DAG or cache is locked in RAM, so it can not be swapped out or reclaimed.
+	*
+	*	Locking is limited by RLIMIT_MEMLOCK unless the process has CAP_IPC_LOCK. The soft limit is raised to the hard limit when needed.
+	*/
+	enum memory_lock_mode
+	{
+		lock_none,			/**< lock_none leaves the pages to the kernel */
+		lock_preferred,		/**< lock_preferred locks the pages if the limits allow it and leaves them unlocked otherwise */
+		lock_required		/**< lock_required locks the pages, generating or loading throws hash_exception if they can not be locked */
+	};
 
-		/** \brief data_type is the underlying data store which stores a cache.
+	/** \brief residency_t describes how much of a DAG or cache is in RAM.
+	*/
+	struct residency_t
+	{
+		/** \brief The bytes of the data which are in RAM, counted in whole pages.
 		*/
-		using data_type = ::std::vector<::std::vector<node>>;
+		::std::size_t resident_bytes;
 
-		/** \brief default copy constructor.
+		/** \brief The size of the data in bytes.
 		*/
-		dag_t(dag_t const &) = default;
+		::std::size_t total_bytes;
 
-		/** \brief default copy assignment operator.
+		/** \brief Whether the data is locked in RAM.
 		*/
-		dag_t & operator=(dag_t const &) = default;
+		bool locked;
+	};
 
-		/** \brief default move constructor.
+	/** \brief numa_mode values select how a DAG is placed across the NUMA nodes of the system.
+	*/
+	enum numa_mode
+	{
+		numa_local,			/**< numa_local leaves each page of the DAG on whichever node first wrote it */
+		numa_replicate,		/**< numa_replicate keeps a copy of the DAG on every node, and full hashes read the copy on the node of the calling thread */
+		numa_interleave		/**< numa_interleave spreads the pages of the DAG evenly across every node, for when there is not enough memory to replicate */
+	};
+
+	/** \brief numa_policy_t determines how DAGs are placed across NUMA nodes when they are generated or loaded.
+	*/
+	struct numa_policy_t
+	{
+		/** \brief How the DAG is placed.
 		*/
-		dag_t(dag_t &&) = default;
+		numa_mode mode;
 
-		/** \brief default move assignment operator.
+		/** \brief If non-zero, the number of nodes to pretend the system has, so the placement logic can be exercised on a single node machine.
+		*
+		*	The CPUs are dealt round robin to the pretend nodes and memory is never bound to a node.
 		*/
-		dag_t & operator=(dag_t &&) = default;
+		uint32_t fake_nodes;
+	};
 
-		/** \brief default destructor.
+	/** \brief read_function_type is a function which passed to various objects which perform loading of a file, such as the cache and DAG.
+	*
+	*	Note that this function will own whatever data it needs to perform the read, i.e. the filestream.
+	*	\param dst points to the memory location that should be read into.
+	*	\param count represents the number of bytes to read.
+	*	\throws hash_exception if the read failed
+	*/
+	using read_function_type = ::std::function<void(void * dst, ::std::size_t count)>;
+
+	/** \brief write_function_type is a function which is passed to objects which perform saving of a file, such as the cache and DAG.
+	*
+	*	\param src points to the memory location that should be written.
+	*	\param count represents the number of bytes to write.
+	*	\throws hash_exception if the write failed
+	*/
+	using write_function_type = ::std::function<void(void const * src, ::std::size_t count)>;
+
+	/** \brief release_function_type is called once memory handed over to a DAG is no longer used.
+	*
+	*	\param memory points to the memory which was handed over.
+	*	\param bytes is the size of the memory which was handed over.
+	*/
+	using release_function_type = ::std::function<void(void * memory, ::std::size_t bytes)>;
+
+	/** \brief allocator_t provides the memory caches and DAGs store their items in.
+	*
+	*	Implement this to place caches and DAGs in memory of your choosing, such as huge page arenas, shared segments or pinned pools.
+	*	An allocator may be used from several threads at once.
+	*/
+	struct allocator_t
+	{
+		/** \brief default virtual destructor.
 		*/
-		~dag_t() = default;
+		virtual ~allocator_t() = default;
 
-		/** \brief explicitly deleted default constructor.
+		/** \brief Allocate memory for items.
+		*
+		*	The memory need not be initialized, but it must be aligned to at least sizeof(node), ideally to a cache line or page.
+		*	\param bytes is the size of the memory to allocate.
+		*	\param mode is the page_mode requested through dag_t::set_page_mode() or cache_t::set_page_mode(), which may be ignored.
+		*	\param backing receives the pages the memory was actually allocated in.
+		*	\return pointer to the memory.
+		*	\throws std::bad_alloc if the memory could not be allocated.
 		*/
-		dag_t() = delete;
+		virtual void * allocate(::std::size_t bytes, page_mode mode, page_backing & backing) = 0;
 
-		/** \brief generate a DAG for a given block_number.
+		/** \brief Free memory returned by allocate().
 		*
-		*	DAG's are cached in a singleton per epoch. If this DAG is already loaded in memory it will be returned quickly.
-		*	If this DAG is not yet loaded, this will take a long time.
-		*	\param block_number is the block number for which to generate a DAG.
-		*	\param callback (optional) may be used to monitor the progress of DAG generation. Return false to cancel, true to continue.
+		*	\param memory is the pointer allocate() returned.
+		*	\param bytes is the size which was passed to allocate().
+		*	\param backing is the page_backing which allocate() reported.
 		*/
-		dag_t(uint64_t const block_number, progress_callback_type = [](size_type, size_type, int){ return true; });
+		virtual void deallocate(void * memory, ::std::size_t bytes, page_backing backing) noexcept = 0;
 
-		/** \brief load a DAG from a file.
+		/** \brief Get the default allocator, which maps anonymous pages and honours page_mode.
 		*
-		*	DAG's are cached in a singleton per epoch. If this DAG is already loaded in memory it will be returned quickly.
-		*	\param file_path is the path to the file the DAG should be loaded from.
-		*	\param callback (optional) may be used to monitor the progress of DAG loading. Return false to cancel, true to continue.
+		*	\return ::std::shared_ptr to the default allocator.
 		*/
-		dag_t(::std::string const & file_path, progress_callback_type = [](size_type, size_type, int){ return true; });
+		static ::std::shared_ptr<allocator_t> get_page_allocator();
+	};
 
-		/** \brief Get the epoch number for which this DAG is valid.
+	/** \brief source_t is a source of bulk data from which a cache or DAG can be loaded.
+	*
+	*	Caches and DAGs are read in spans of constants::IO_CHUNK_BYTES or more straight into their storage,
+	*	so implementations are called once per span rather than once per item.
+	*/
+	class source_t
+	{
+	public:
+		/** \brief size_type represents sizes used by a source_t.
+		*/
+		using size_type = ::std::size_t;
+
+		/** \brief unknown_size is returned by remaining() when the size of a source is not known.
+		*/
+		static constexpr size_type unknown_size = static_cast<size_type>(-1);
+
+		/** \brief default destructor.
+		*/
+		virtual ~source_t() = default;
+
+		/** \brief Read exactly count bytes.
 		*
-		*	\returns uint64_t representing the epoch number (block_number / constants::EPOCH_LENGTH)
+		*	\param dst points to the memory location that should be read into.
+		*	\param count represents the number of bytes to read.
+		*	\throws hash_exception if the read failed or fewer than count bytes are available.
 		*/
-		uint64_t epoch() const;
+		virtual void read(void * dst, size_type count) = 0;
 
-		/** \brief Get the size of the DAG data in bytes.
+		/** \brief View the next count bytes where the source holds them, rather than copying them out with read().
 		*
-		*	\returns size_type representing the size of the DAG data in bytes.
+		*	The bytes are consumed as if they had been read. Sources which do not hold their data contiguously in memory consume nothing.
+		*	\param count represents the number of bytes to view.
+		*	\return pointer to the bytes, valid for as long as the source exists or view_owner() is held, or nullptr if they can not be viewed.
+		*	\throws hash_exception if fewer than count bytes are available.
 		*/
-		size_type size() const;
+		virtual void const * view(size_type count);
 
-		/** \brief Get the data the DAG contains.
+		/** \brief Get an owner which keeps the memory returned by view() valid after the source has been destroyed.
 		*
-		*	\returns data_type const & to the actual DAG data.
+		*	Caches and DAGs loaded from a source with an owner point at its memory rather than copying it, unless their page mode or
+		*	allocator asks for memory of their own.
+		*	\return shared_ptr which keeps the memory valid, or nullptr if it is only valid for as long as the source exists.
 		*/
-		data_type const & data() const;
+		virtual ::std::shared_ptr<void const> view_owner() const;
 
-		/** \brief Save the DAG to a file fur future loading.
+		/** \brief Skip over count bytes without reading them.
 		*
+		*	\param count represents the number of bytes to skip.
+		*	\throws hash_exception if the skip failed or fewer than count bytes are available.
+		*/
+		virtual void skip(size_type count);
+
+		/** \brief Get the number of bytes left to read.
+		*
+		*	\return the number of bytes left, or unknown_size if it can not be determined.
+		*/
+		virtual size_type remaining() const;
+	};
+
+	/** \brief sink_t is a destination for bulk data to which a cache or DAG can be saved.
+	*/
+	class sink_t
+	{
+	public:
+		/** \brief size_type represents sizes used by a sink_t.
+		*/
+		using size_type = ::std::size_t;
+
+		/** \brief default destructor.
+		*/
+		virtual ~sink_t() = default;
+
+		/** \brief Write exactly count bytes.
+		*
+		*	\param src points to the memory location that should be written.
+		*	\param count represents the number of bytes to write.
+		*	\throws hash_exception if the write failed.
+		*/
+		virtual void write(void const * src, size_type count) = 0;
+
+		/** \brief Flush any buffered data to the underlying destination.
+		*
+		*	\throws hash_exception if the flush failed.
+		*/
+		virtual void flush();
+	};
+
+	/** \brief fd_source reads from a file descriptor.
+	*/
+	class fd_source : public source_t
+	{
+	public:
+		/** \brief Read from an already open file descriptor, which remains owned by the caller.
+		*/
+		explicit fd_source(int fd);
+
+		/** \brief Open a file for reading. The file is closed when the fd_source is destroyed.
+		*
+		*	\throws hash_exception if the file could not be opened.
+		*/
+		explicit fd_source(::std::string const & file_path);
+
+		fd_source(fd_source const &) = delete;
+		fd_source & operator=(fd_source const &) = delete;
+		~fd_source();
+
+		void read(void * dst, size_type count) override;
+		void skip(size_type count) override;
+		size_type remaining() const override;
+
+	private:
+		int fd;
+		bool owned;
+		size_type size;
+		size_type position;
+	};
+
+	/** \brief fd_sink writes to a file descriptor.
+	*/
+	class fd_sink : public sink_t
+	{
+	public:
+		/** \brief Write to an already open file descriptor, which remains owned by the caller.
+		*/
+		explicit fd_sink(int fd);
+
+		/** \brief Create or truncate a file for writing. The file is closed when the fd_sink is destroyed.
+		*
+		*	\throws hash_exception if the file could not be opened.
+		*/
+		explicit fd_sink(::std::string const & file_path);
+
+		fd_sink(fd_sink const &) = delete;
+		fd_sink & operator=(fd_sink const &) = delete;
+		~fd_sink();
+
+		void write(void const * src, size_type count) override;
+		void flush() override;
+
+	private:
+		int fd;
+		bool owned;
+	};
+
+	/** \brief memory_source reads from memory which is owned by the caller, such as a shared memory segment.
+	*/
+	class memory_source : public source_t
+	{
+	public:
+		/** \brief Read from size bytes starting at data. The memory must outlive the memory_source.
+		*
+		*	\param data points to the memory to read.
+		*	\param size is the number of bytes to read.
+		*	\param owner (optional) keeps the memory valid, so caches and DAGs loaded from it may point at it rather than copy it.
+		*/
+		memory_source(void const * data, size_type size, ::std::shared_ptr<void const> owner = nullptr) noexcept;
+
+		void read(void * dst, size_type count) override;
+		void const * view(size_type count) override;
+		::std::shared_ptr<void const> view_owner() const override;
+		void skip(size_type count) override;
+		size_type remaining() const override;
+
+	protected:
+		uint8_t const * begin;
+		uint8_t const * end;
+		::std::shared_ptr<void const> owner;
+	};
+
+	/** \brief mmap_source reads from a private memory mapping of a file.
+	*
+	*	Caches and DAGs loaded from it copy the file's pages unless the mapping is lent to them. A lent mapping is its own view_owner(),
+	*	so they share the file's pages instead, and the file must then not be truncated or rewritten in place while they are loaded.
+	*/
+	class mmap_source : public memory_source
+	{
+	public:
+		/** \brief Map a file for reading. The mapping is released once neither the mmap_source nor anything loaded from it uses it.
+		*
+		*	\param file_path is the path of the file to map.
+		*	\param lend (optional) lets caches and DAGs loaded from the mapping point at it rather than copy it.
+		*	\throws hash_exception if the file could not be mapped.
+		*/
+		explicit mmap_source(::std::string const & file_path, bool lend = false);
+
+		mmap_source(mmap_source const &) = delete;
+		mmap_source & operator=(mmap_source const &) = delete;
+
+		void const * view(size_type count) override;
+		::std::shared_ptr<void const> view_owner() const override;
+
+	private:
+		bool lend;
+	};
+
+	/** \brief memory_sink writes into memory which is owned by the caller.
+	*/
+	class memory_sink : public sink_t
+	{
+	public:
+		/** \brief Write into at most size bytes starting at data. The memory must outlive the memory_sink.
+		*/
+		memory_sink(void * data, size_type size) noexcept;
+
+		void write(void const * src, size_type count) override;
+
+		/** \brief Get the number of bytes written so far.
+		*/
+		size_type written() const noexcept;
+
+	private:
+		uint8_t * begin;
+		uint8_t * position;
+		uint8_t * end;
+	};
+
+	/** \brief callback_source reads through a user supplied read_function_type.
+	*/
+	class callback_source : public source_t
+	{
+	public:
+		/** \brief Read through read, optionally limited to size bytes.
+		*/
+		explicit callback_source(read_function_type read, size_type size = unknown_size);
+
+		void read(void * dst, size_type count) override;
+		size_type remaining() const override;
+
+	private:
+		read_function_type read_function;
+		size_type size;
+	};
+
+	/** \brief callback_sink writes through a user supplied write_function_type.
+	*/
+	class callback_sink : public sink_t
+	{
+	public:
+		/** \brief Write through write.
+		*/
+		explicit callback_sink(write_function_type write);
+
+		void write(void const * src, size_type count) override;
+
+	private:
+		write_function_type write_function;
+	};
+
+	/** \brief task_priority values are the priority classes of work run on a thread_pool_t.
+	*/
+	enum task_priority
+	{
+		priority_foreground,	/**< priority_foreground is latency sensitive work such as hashing, searching and verification */
+		priority_background		/**< priority_background is work which may be deferred, such as preparing the next epoch ahead of time, run by separate threads of lower scheduling priority */
+	};
+
+	/** \brief smt_mode values select which hardware threads of each core a thread_pool_t runs on.
+	*/
+	enum smt_mode
+	{
+		smt_all,			/**< smt_all runs on every hardware thread */
+		smt_one_per_core	/**< smt_one_per_core runs on the first hardware thread of each core only, leaving its siblings idle */
+	};
+
+	/** \brief thread_pool_options_t configures a thread_pool_t.
+	*/
+	struct thread_pool_options_t
+	{
+		/** \brief The number of foreground threads, or 0 for one per CPU the pool may run on.
+		*/
+		unsigned threads;
+
+		/** \brief The number of background threads, or 0 to run background tasks on the foreground threads.
+		*/
+		unsigned background_threads;
+
+		/** \brief The CPUs the foreground threads are pinned to, one CPU per thread in turn.
+		*
+		*	If this is empty, the threads are only pinned when smt is smt_one_per_core, to the CPUs the process may run on.
+		*/
+		::std::vector<unsigned> cpus;
+
+		/** \brief Which hardware threads of each core of cpus are used.
+		*/
+		smt_mode smt;
+	};
+
+	/** \brief thread_pool_t is a work stealing thread pool shared by the parallel parts of egihash, so they don't oversubscribe the CPUs.
+	*
+	*	Each foreground thread has its own queue of tasks, and steals from the other queues when its own is empty. Tasks submitted from
+	*	a foreground thread go to its own queue. Background tasks have a separate queue, served by background threads which run at a
+	*	lower scheduling priority, so they yield the CPUs to foreground work. Copies of a thread_pool_t share the same threads,
+	*	which run every remaining task and exit once the last copy is destroyed.
+	*/
+	struct thread_pool_t
+	{
+		/** \brief task_type is a task run by a thread pool.
+		*/
+		using task_type = ::std::function<void()>;
+
+		/** \brief start a thread pool with one foreground thread per CPU and two background threads.
+		*
+		*	Background tasks such as building a DAG may run for a long time, so with two of them a DAG can be loaded from a file
+		*	while another one is being generated.
+		*/
+		thread_pool_t();
+
+		/** \brief start a thread pool.
+		*
+		*	\param options is the thread_pool_options_t configuring the pool.
+		*/
+		explicit thread_pool_t(thread_pool_options_t const & options);
+
+		/** \brief Get the number of foreground threads.
+		*/
+		unsigned size() const;
+
+		/** \brief Run a task on the pool without waiting for it.
+		*
+		*	\param task is the task to run. Any exception it throws is discarded.
+		*	\param priority is the priority class of the task.
+		*/
+		void submit(task_type const & task, task_priority priority = priority_foreground) const;
+
+		/** \brief Run body for every index in [0, count) on the foreground threads and the calling thread, and wait for them all.
+		*
+		*	The calling thread takes part, so this may be called from a task running on the pool.
+		*	If body throws, no further indices are started and the first exception is rethrown once the running ones have finished.
+		*	\param count is the number of indices.
+		*	\param body is called once with each index, from any of the threads.
+		*/
+		void parallel_for(::std::size_t count, ::std::function<void(::std::size_t index)> const & body) const;
+
+		/** \brief Get the pool the parallel parts of egihash use unless they are given one.
+		*
+		*	\return thread_pool_t sharing the threads of the default pool, which is started on first use.
+		*/
+		static thread_pool_t get_default();
+
+		/** \brief Replace the default pool, tasks already submitted to the previous default pool still run on it.
+		*
+		*	\param pool is the thread_pool_t to use by default.
+		*/
+		static void set_default(thread_pool_t const & pool);
+
+		/** \brief thread_pool_t private implementation.
+		*/
+		struct impl_t;
+
+		/** \brief shared_ptr to impl allows copies of a pool to share its threads.
+		*/
+		::std::shared_ptr<impl_t> impl;
+	};
+
+	/** \brief cache_t is the cache used to compute a DAG for a given epoch.
+	*
+	* Each DAG owns a cache_t and the size of the cache grows linearly in time.
+	*/
+	struct cache_t
+	{
+		/** \brief size_type represents sizes used by a cache.
+		*/
+		using size_type = uint64_t;
+
+		/** \brief data_type is a view of the underlying data store which stores a cache.
+		*/
+		using data_type = data_view_t;
+
+		/** \brief item_cache_stats_t reports how effective the item cache of a cache has been.
+		*/
+		struct item_cache_stats_t
+		{
+			uint64_t hits;
+			uint64_t misses;
+			size_type capacity;
+		};
+
+		/** \brief default copy constructor.
+		*/
+		cache_t(const cache_t &) = default;
+
+		/** \brief default copy assignment operator.
+		*/
+		cache_t & operator=(cache_t const &) = default;
+
+		/** \brief default move constructor.
+		*/
+		cache_t(cache_t &&) = default;
+
+		/** \brief default move assignment operator.
+		*/
+		cache_t & operator=(cache_t &&) = default;
+
+		/** \brief default destructor.
+		*/
+		~cache_t() = default;
+
+		/** \brief explicitly deleted default constructor.
+		*/
+		cache_t() = delete;
+
+		/** \brief Construct a cache_t given a block number and a progress callback function.
+		*
+		*	\param block_number is the block number for which this cache_t is to be constructed.
+		*	\param callback (optional) may be used to monitor the progress of cache generation. Return false to cancel, true to continue.
+		*/
+		cache_t(uint64_t block_number, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Load a cache_t from a cache file.
+		*
+		*	cache_t's are cached in a singleton per epoch. If this cache is already loaded in memory it will be returned quickly.
+		*	\param file_path is the path to the cache file written by save().
+		*	\param callback (optional) may be used to monitor the progress of cache loading. Return false to cancel, true to continue.
+		*	\throws hash_exception if the file is not a valid cache file.
+		*/
+		cache_t(::std::string const & file_path, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Load a cache_t in the cache file format from a source.
+		*
+		*	cache_t's are cached in a singleton per epoch. If this cache is already loaded in memory it will be returned quickly.
+		*	\param source is the source_t to read the cache file from.
+		*	\param callback (optional) may be used to monitor the progress of cache loading. Return false to cancel, true to continue.
+		*	\throws hash_exception if the data is not a valid cache file.
+		*/
+		cache_t(source_t & source, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Get the epoch number for which this cache is valid.
+		*
+		*	\returns uint64_t representing the epoch number (block_number / constants::EPOCH_LENGTH)
+		*/
+		uint64_t epoch() const;
+
+		/** \brief Get the size of the cache data in bytes.
+		*
+		*	\returns size_type representing the size of the cache data in bytes.
+		*/
+		size_type size() const;
+
+		/** \brief Get the size of the DAG data in bytes for the epoch of this cache.
+		*
+		*	This is computed once when the cache is constructed, so it is cheap to call for every hash.
+		*	\returns size_type representing the size of the DAG data in bytes.
+		*/
+		size_type full_size() const;
+
+		/** \brief Get the pages this cache was actually allocated in.
+		*
+		*	\return page_backing of the cache data.
+		*/
+		page_backing backing() const;
+
+		/** \brief Find out how much of the cache is in RAM, using mincore.
+		*
+		*	\return residency_t of the cache data.
+		*/
+		residency_t residency() const;
+
+		/** \brief Get the data the cache contains.
+		*
+		*	\returns data_type viewing the actual cache data, valid for as long as this cache is loaded.
+		*/
+		data_type data() const;
+
+		/** \brief Get the seedhash for this cache.
+		*
+		*	/returns h256_t seed hash for this cache.
+		*/
+		h256_t seedhash() const;
+
+		/** \brief Compute an item of the DAG for this epoch from the cache.
+		*
+		*	If the item cache is enabled, the item is taken from it when present and added to it otherwise.
+		*	\param index is the index of the DAG item to compute.
+		*	\param out receives the constants::HASH_WORDS words of the DAG item.
+		*/
+		void dataset_item(uint32_t index, node * out) const;
+
+		/** \brief Set the size of the item cache, which memoizes DAG items computed for light hashes.
+		*
+		*	Light hashes of the same epoch often need the same DAG items, e.g. when a pool validates many shares.
+		*	The item cache is direct mapped, shared by every copy of this cache, and safe to use from several threads.
+		*	Resizing the item cache empties it and resets its statistics.
+		*	\param megabytes is the memory to use for the item cache in MiB, or 0 to disable it (the default).
+		*/
+		void set_item_cache_size(size_type megabytes) const;
+
+		/** \brief Get the hit statistics of the item cache.
+		*
+		*	\return item_cache_stats_t containing the hits and misses since the item cache was sized, and its capacity in items.
+		*/
+		item_cache_stats_t get_item_cache_stats() const;
+
+		/** \brief Save the cache to a cache file for fast future loading.
+		*
+		*	The file is written under a temporary name and then renamed over file_path, so an existing file is replaced in a single step.
+		*	\param file_path is the path to the file the cache should be saved to.
+		*	\param callback (optional) may be used to monitor the progress of cache saving. Return false to cancel, true to continue.
+		*/
+		void save(::std::string const & file_path, progress_callback_type callback = [](size_type, size_type, int){ return true; }) const;
+
+		/** \brief Save the cache in the cache file format to a sink.
+		*
+		*	\param sink is the sink_t to write the cache file to.
+		*	\param callback (optional) may be used to monitor the progress of cache saving. Return false to cancel, true to continue.
+		*/
+		void save(sink_t & sink, progress_callback_type callback = [](size_type, size_type, int){ return true; }) const;
+
+		/** \brief Unload cache.
+		*
+		*	To actually free a cache from memory, call this function on a cache.
+		*	The cache will then be released from the internal cache.
+		*	Once all references to the cache for this epoch are destroyed, it will be freed.
+		*/
+		void unload() const;
+
+		/** \brief Get the size of the cache data in bytes.
+		*
+		*	\param block_number is the block number for which cache size to compute.
+		*	\returns size_type representing the size of the cache data in bytes.
+		*/
+		static size_type get_cache_size(uint64_t const block_number) noexcept;
+
+		/** \brief get_seedhash(uint64_t) will compute the seedhash for a given block number.
+		*
+		*	Seedhashes are remembered once computed, so only the epochs beyond the latest one seen so far need to be hashed.
+		*	\param block_number An unsigned 64-bit integer representing the block number for which to compute the seed hash.
+		*	\return An h256_t keccak-256 seed hash for the given block number.
+		*/
+		static h256_t get_seedhash(uint64_t const block_number);
+
+		/** \brief Find the epoch which has a given seedhash, as work packages identify epochs by seedhash.
+		*
+		*	\param seedhash is the seedhash to look up.
+		*	\throws hash_exception if seedhash is not the seedhash of any of the first constants::SEEDHASH_SEARCH_EPOCHS epochs,
+		*	or of any later epoch whose seedhash has already been computed.
+		*	\return uint64_t representing the epoch number.
+		*/
+		static uint64_t get_epoch(h256_t const & seedhash);
+
+		/** \brief Compute the seedhashes of the first epoch_count epochs ahead of time.
+		*
+		*	\param epoch_count is the number of epochs, starting from epoch 0, whose seedhashes are computed.
+		*/
+		static void precompute_seedhashes(uint64_t epoch_count);
+
+		/** \brief Generate the caches of a range of epochs at once, adding them to the cache cache.
+		*
+		*	Each cache is generated serially, but the caches of different epochs are independent, so several are generated at once.
+		*	The seedhashes of the range are computed once up front rather than by each cache. Epochs which are already loaded are skipped.
+		*	Epochs are prepared in order while they fit in what remains of the memory budget, so preparing never unloads other caches.
+		*	\param first_epoch is the first epoch to prepare.
+		*	\param last_epoch is the last epoch to prepare, inclusive.
+		*	\param threads (optional) is the most caches to generate at once, or 0 for one per thread of the pool.
+		*	\param pool (optional) is the thread_pool_t to generate on.
+		*	\throws hash_exception if a cache could not be generated.
+		*	\return ::std::vector of the epochs of the range which were prepared, in order, stopping short of last_epoch if the budget ran out.
+		*/
+		static ::std::vector<uint64_t> prepare_range(uint64_t first_epoch, uint64_t last_epoch, unsigned threads = 0, thread_pool_t const & pool = thread_pool_t::get_default());
+
+		/** \brief Set the most bytes of caches which the cache cache holds.
+		*
+		*	The default is unlimited. When a cache takes the cache cache over budget, the least recently used other caches are unloaded
+		*	until it fits again. Unloaded caches which are still referenced, e.g. by a DAG, stay in memory until they are released.
+		*	\param budget_bytes is the budget in bytes, or 0 for unlimited.
+		*/
+		static void set_memory_budget(size_type budget_bytes);
+
+		/** \brief Get the most bytes of caches which the cache cache holds.
+		*
+		*	\return size_type of the budget in bytes, 0 if unlimited.
+		*/
+		static size_type get_memory_budget();
+
+		/** \brief Set the pages which caches are allocated in when they are subsequently generated or loaded.
+		*
+		*	The default is pages_normal.
+		*	\param mode is the page_mode to allocate with.
+		*/
+		static void set_page_mode(page_mode mode);
+
+		/** \brief Get the pages which caches are allocated in.
+		*
+		*	\return page_mode currently applied to new caches.
+		*/
+		static page_mode get_page_mode();
+
+		/** \brief Set the allocator which caches are stored in when they are subsequently generated or loaded.
+		*
+		*	\param allocator is the allocator_t to use, or nullptr to restore allocator_t::get_page_allocator().
+		*/
+		static void set_allocator(::std::shared_ptr<allocator_t> const & allocator);
+
+		/** \brief Get the allocator which caches are stored in.
+		*
+		*	\return ::std::shared_ptr to the allocator_t currently applied to new caches.
+		*/
+		static ::std::shared_ptr<allocator_t> get_allocator();
+
+		/** \brief Set whether caches are locked in RAM when they are subsequently generated or loaded.
+		*
+		*	The default is lock_none.
+		*	\param mode is the memory_lock_mode to apply.
+		*/
+		static void set_lock_mode(memory_lock_mode mode);
+
+		/** \brief Get whether caches are locked in RAM.
+		*
+		*	\return memory_lock_mode currently applied to new caches.
+		*/
+		static memory_lock_mode get_lock_mode();
+
+		/** \brief Determine whether the cache_t for this epoch is already loaded
+		*
+		*	\param epoch is the epoch number for which to determine if a cache_t is already loaded.
+		*	\return bool true if we have this cache_t epoch loaded, false otherwise.
+		*/
+		static bool is_loaded(uint64_t const epoch);
+
+		/** \brief Get the epoch numbers for which we already have a cache_t loaded.
+		*
+		*	\return ::std::vector containing epoch numbers for cache_t's that are already loaded.
+		*/
+		static ::std::vector<uint64_t> get_loaded();
+
+		/** \brief cache_t internal implementation.
+		*/
+		struct impl_t;
+
+	private:
+		friend struct dag_t;
+
+		/** \brief Construct a cache_t by loading the cache embedded in a DAG file.
+		*
+		*	If a cache for this epoch is already loaded, it is reused and the cache data is skipped in the source.
+		*
+		*	\param epoch is the number of the epoch for the cache we are loading.
+		*	\param size is the size in bytes of the cache we are loading.
+		*	\param source The source_t which cache data will be read from.
+		*	\param callback (optional) may be used to monitor the progress of cache loading. Return false to cancel, true to continue.
+		*/
+		cache_t(uint64_t epoch, uint64_t size, source_t & source, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Load a cache from disk.
+		*
+		*	\param source The source_t which cache data will be read from.
+		*	\param callback (optional) may be used to monitor the progress of cache loading. Return false to cancel, true to continue.
+		*/
+		void load(source_t & source, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief shared_ptr to impl allows default moving/copying of cache. Internally, only one cache_t::impl_t per epoch will exist.
+		*/
+		::std::shared_ptr<impl_t> impl;
+	};
+
+	/** \brief dag_t is the DAG which is used by full nodes and miners to compute egihashes.
+	*
+	*	The DAG gives egihash it's ASIC resistance, ensuring that this hashing function is memory bound not compute bound.
+	*	The DAG must be updated once per constants::EPOCH_LENGTH block numbers.
+	*	The DAG for epoch 0 is 1073739904 bytes in size and will grow linearly with each following epoch.
+	*	The DAG can take a long time to generate. It is recommended to save the DAG to disk to avoid having to regenerate it each time.
+	*	It makes sense to pre-compute the DAG for the next epoch, so generating it does not interrupt mining / operation of a full node.
+	*	Whether by generation or by loading, the DAG will own a cache_t which corresponds to cache for the same epoch.
+	*/
+	struct dag_t
+	{
+		/** \brief size_type represents sizes used by a cache.
+		*/
+		using size_type = ::std::size_t;
+
+		/** \brief data_type is a view of the underlying data store which stores a DAG.
+		*/
+		using data_type = data_view_t;
+
+		/** \brief default copy constructor.
+		*/
+		dag_t(dag_t const &) = default;
+
+		/** \brief default copy assignment operator.
+		*/
+		dag_t & operator=(dag_t const &) = default;
+
+		/** \brief default move constructor.
+		*/
+		dag_t(dag_t &&) = default;
+
+		/** \brief default move assignment operator.
+		*/
+		dag_t & operator=(dag_t &&) = default;
+
+		/** \brief default destructor.
+		*/
+		~dag_t() = default;
+
+		/** \brief explicitly deleted default constructor.
+		*/
+		dag_t() = delete;
+
+		/** \brief generate a DAG for a given block_number.
+		*
+		*	DAG's are cached in a singleton per epoch. If this DAG is already loaded in memory it will be returned quickly.
+		*	If this DAG is not yet loaded, this will take a long time.
+		*	\param block_number is the block number for which to generate a DAG.
+		*	\param callback (optional) may be used to monitor the progress of DAG generation. Return false to cancel, true to continue.
+		*/
+		dag_t(uint64_t const block_number, progress_callback_type = [](size_type, size_type, int){ return true; });
+
+		/** \brief load a DAG from a file.
+		*
+		*	DAG's are cached in a singleton per epoch. If this DAG is already loaded in memory it will be returned quickly.
+		*	\param file_path is the path to the file the DAG should be loaded from.
+		*	\param callback (optional) may be used to monitor the progress of DAG loading. Return false to cancel, true to continue.
+		*/
+		dag_t(::std::string const & file_path, progress_callback_type = [](size_type, size_type, int){ return true; });
+
+		/** \brief load a DAG in the DAG file format from a source.
+		*
+		*	DAG's are cached in a singleton per epoch. If this DAG is already loaded in memory it will be returned quickly.
+		*	\param source is the source_t the DAG should be loaded from, such as an mmap_source or memory_source.
+		*	\param callback (optional) may be used to monitor the progress of DAG loading. Return false to cancel, true to continue.
+		*/
+		dag_t(source_t & source, progress_callback_type = [](size_type, size_type, int){ return true; });
+
+		/** \brief adopt DAG data which was computed elsewhere, without copying it.
+		*
+		*	The items are owned by the DAG from the moment this is called, even if it throws, and release is called once they are no longer used.
+		*	If the DAG for this epoch is already loaded, the loaded DAG is returned and the items are released straight away.
+		*	The items are checked according to the verify policy, see set_verify_policy().
+		*	\param block_number is a block number of the epoch the items belong to.
+		*	\param items points to the DAG items, which must not be changed while the DAG is loaded.
+		*	\param size is the size of the items in bytes, which must be get_full_size(block_number).
+		*	\param release is called with items and size once the items are no longer used.
+		*	\param callback (optional) may be used to monitor the progress of cache generation and verification. Return false to cancel, true to continue.
+		*/
+		dag_t(uint64_t const block_number, void * items, size_type size, release_function_type release, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Get the epoch number for which this DAG is valid.
+		*
+		*	\returns uint64_t representing the epoch number (block_number / constants::EPOCH_LENGTH)
+		*/
+		uint64_t epoch() const;
+
+		/** \brief Get the size of the DAG data in bytes.
+		*
+		*	\returns size_type representing the size of the DAG data in bytes.
+		*/
+		size_type size() const;
+
+		/** \brief Get the data the DAG contains.
+		*
+		*	\returns data_type viewing the actual DAG data, valid for as long as this DAG is loaded.
+		*/
+		data_type data() const;
+
+		/** \brief Get the pages this DAG was actually allocated in.
+		*
+		*	\return page_backing of the DAG data.
+		*/
+		page_backing backing() const;
+
+		/** \brief Find out how much of the DAG is in RAM, using mincore.
+		*
+		*	\return residency_t of the DAG data, counting every copy when it is replicated.
+		*/
+		residency_t residency() const;
+
+		/** \brief Get the number of copies of the DAG data which are held, one per NUMA node when the DAG is replicated.
+		*
+		*	\return uint32_t count of copies, 1 unless the DAG was replicated, see set_numa_policy().
+		*/
+		uint32_t replica_count() const;
+
+		/** \brief Save the DAG to a file fur future loading.
+		*
+		*	The file is written under a temporary name and then renamed over file_path, so an existing file is replaced in a single step.
 		*	\param file_path is the path to the file the DAG should be saved to.
 		*	\param callback (optional) may be used to monitor the progress of DAG saving. Return false to cancel, true to continue.
 		*/
-		void save(::std::string const & file_path, progress_callback_type callback = [](size_type, size_type, int){ return true; }) const;
+		void save(::std::string const & file_path, progress_callback_type callback = [](size_type, size_type, int){ return true; }) const;
+
+		/** \brief Save the DAG in the DAG file format to a sink.
+		*
+		*	\param sink is the sink_t the DAG should be saved to.
+		*	\param callback (optional) may be used to monitor the progress of DAG saving. Return false to cancel, true to continue.
+		*/
+		void save(sink_t & sink, progress_callback_type callback = [](size_type, size_type, int){ return true; }) const;
+
+		/** \brief Get the cache for this DAG.
+		*
+		*	\return cache_t of the cache for this DAG.
+		*/
+		cache_t get_cache() const;
+
+		/** \brief Check the DAG data for corruption.
+		*
+		*	\param mode determines how thoroughly the DAG is checked, see verify_mode.
+		*	\param sample_count is the number of items to recompute when mode is verify_sampled.
+		*	\param callback (optional) may be used to monitor the progress of verification. Return false to cancel, true to continue.
+		*	Full verification runs on the default thread pool, and if callback is a progress_t every thread reports to it and checks its token.
+		*	\return true if the DAG passed verification, false if it is corrupt.
+		*/
+		bool verify(verify_mode mode, uint32_t sample_count = constants::VERIFY_SAMPLE_COUNT, progress_callback_type callback = [](size_type, size_type, int){ return true; }) const;
+
+		/** \brief Unload a DAG.
+		*
+		*	To actually free a DAG from memory, call this function on a DAG. The DAG will then be released from the internal cache.
+		*	Once all references to the DAG for this epoch are destroyed, it will be freed.
+		*/
+		void unload() const;
+
+		/** \brief Get the size of the DAG data in bytes.
+		*
+		*	\param block_number is the block number for which DAG size to compute.
+		*	\return size_type representing the size of the DAG data in bytes.
+		*/
+		static size_type get_full_size(uint64_t const block_number) noexcept;
+
+		/** \brief Determine whether the DAG for this epoch is already loaded
+		*
+		*	\param epoch is the epoch number for which to determine if a DAG is already loaded.
+		*	\return bool true if we have this DAG epoch loaded, false otherwise.
+		*/
+		static bool is_loaded(uint64_t const epoch);
+
+		/** \brief Get the epoch numbers for which we already have a DAG loaded.
+		*
+		*	\return ::std::vector containing epoch numbers for DAGs that are already loaded.
+		*/
+		static ::std::vector<uint64_t> get_loaded();
+
+		/** \brief Set the verification which is performed whenever a DAG is loaded from a file.
+		*
+		*	DAG files which fail verification are not loaded and a hash_exception is thrown instead.
+		*	The default policy is verify_sampled with constants::VERIFY_SAMPLE_COUNT samples.
+		*	\param policy is the verify_policy_t to apply to subsequent loads.
+		*/
+		static void set_verify_policy(verify_policy_t const & policy);
+
+		/** \brief Get the verification which is performed whenever a DAG is loaded from a file.
+		*
+		*	\return verify_policy_t currently applied to DAG loads.
+		*/
+		static verify_policy_t get_verify_policy();
+
+		/** \brief Set the pages which DAGs are allocated in when they are subsequently generated or loaded.
+		*
+		*	The default is pages_normal. Explicit hugetlbfs pages must be reserved by the system administrator beforehand,
+		*	e.g. through /sys/kernel/mm/hugepages, otherwise transparent huge pages or regular pages are used instead.
+		*	\param mode is the page_mode to allocate with.
+		*/
+		static void set_page_mode(page_mode mode);
+
+		/** \brief Get the pages which DAGs are allocated in.
+		*
+		*	\return page_mode currently applied to new DAGs.
+		*/
+		static page_mode get_page_mode();
+
+		/** \brief Set the allocator which DAGs are stored in when they are subsequently generated or loaded.
+		*
+		*	\param allocator is the allocator_t to use, or nullptr to restore allocator_t::get_page_allocator().
+		*/
+		static void set_allocator(::std::shared_ptr<allocator_t> const & allocator);
+
+		/** \brief Get the allocator which DAGs are stored in.
+		*
+		*	\return ::std::shared_ptr to the allocator_t currently applied to new DAGs.
+		*/
+		static ::std::shared_ptr<allocator_t> get_allocator();
+
+		/** \brief Set whether DAGs are locked in RAM when they are subsequently generated or loaded.
+		*
+		*	The default is lock_none.
+		*	\param mode is the memory_lock_mode to apply.
+		*/
+		static void set_lock_mode(memory_lock_mode mode);
+
+		/** \brief Get whether DAGs are locked in RAM.
+		*
+		*	\return memory_lock_mode currently applied to new DAGs.
+		*/
+		static memory_lock_mode get_lock_mode();
+
+		/** \brief Set how DAGs are placed across NUMA nodes when they are subsequently generated or loaded.
+		*
+		*	The default is numa_local. Replicas are copied by a thread pinned to each node once the DAG is complete.
+		*	If any replica can not be allocated the DAG is kept as a single copy.
+		*	\param policy is the numa_policy_t to apply to new DAGs.
+		*/
+		static void set_numa_policy(numa_policy_t const & policy);
+
+		/** \brief Get how DAGs are placed across NUMA nodes.
+		*
+		*	\return numa_policy_t currently applied to new DAGs.
+		*/
+		static numa_policy_t get_numa_policy();
+
+		/** \brief Share DAGs between processes through POSIX shared memory segments, named with this prefix followed by "-" and the epoch.
+		*
+		*	When a prefix is set, a DAG which is not loaded in this process is looked for in shared memory before it is generated or loaded.
+		*	The first process to need an epoch generates or loads the DAG into a new segment, every other process waits for it to be
+		*	ready and maps it read only. Each process holds a reference on the segment while it has the DAG loaded, and the last
+		*	reference removes the segment. References of processes which exited without releasing them are reclaimed whenever a process
+		*	maps or releases the segment. If the creating process fails or exits before the DAG is ready, another process takes over.
+		*	Liveness is checked by process id, so processes sharing DAGs must be in the same pid namespace.
+		*	\param prefix is a name such as "/egihash", or an empty string to keep DAGs private to this process, which is the default.
+		*/
+		static void set_shared_memory_prefix(::std::string const & prefix);
+
+		/** \brief Get the prefix of the POSIX shared memory segments DAGs are shared through.
+		*
+		*	\return ::std::string prefix, empty if DAGs are private to this process.
+		*/
+		static ::std::string get_shared_memory_prefix();
+
+		/** \brief Get the number of NUMA nodes DAGs are placed across, which is the number of fake nodes if the policy sets one.
+		*
+		*	\return uint32_t count of nodes, at least 1.
+		*/
+		static uint32_t get_numa_node_count();
+
+		/** \brief dag_t private implementation.
+		*/
+		struct impl_t;
+
+		/** \brief shared_ptr to impl allows default moving/copying of cache. Internally, only one dag_t::impl_t per epoch will exist.
+		*
+		*	Since DAGs consume a large amount of memory, it is important that they are cached.
+		*/
+		::std::shared_ptr<impl_t> impl;
+
+	private:
+		/** \brief progressive_dag_t hands out the DAG it finished building.
+		*/
+		friend struct progressive_dag_t;
+
+		/** \brief Construct a dag_t sharing an implementation which is already in the DAG cache.
+		*/
+		explicit dag_t(::std::shared_ptr<impl_t> const & impl);
+	};
+
+	/** \brief lazy_dag_t is a DAG whose items are computed from the cache on first access, within a memory budget.
+	*
+	*	The dataset is reserved as address space only. An item is computed the first time it is read, stored in place and
+	*	marked in a presence bitmap, so later reads of it cost the same as reads of a full DAG.
+	*	Once more than the budget is resident, the least recently used pages of items are released again.
+	*	This lets machines which can't hold a full DAG approach full hashing speed with whatever memory they can afford.
+	*/
+	struct lazy_dag_t
+	{
+		/** \brief size_type represents sizes used by a lazy DAG.
+		*/
+		using size_type = ::std::size_t;
+
+		/** \brief stats_t describes how well the lazy DAG is serving reads.
+		*/
+		struct stats_t
+		{
+			uint64_t hits;            /**< reads of items which were resident */
+			uint64_t misses;          /**< reads of items which had to be computed */
+			uint64_t evictions;       /**< pages released to stay within the budget */
+			size_type resident_bytes; /**< bytes of the dataset currently resident */
+			size_type budget_bytes;   /**< the most bytes of the dataset which may be resident */
+		};
+
+		/** \brief default copy constructor.
+		*/
+		lazy_dag_t(lazy_dag_t const &) = default;
+
+		/** \brief default copy assignment operator.
+		*/
+		lazy_dag_t & operator=(lazy_dag_t const &) = default;
+
+		/** \brief default move constructor.
+		*/
+		lazy_dag_t(lazy_dag_t &&) = default;
+
+		/** \brief default move assignment operator.
+		*/
+		lazy_dag_t & operator=(lazy_dag_t &&) = default;
+
+		/** \brief default destructor.
+		*/
+		~lazy_dag_t() = default;
+
+		/** \brief explicitly deleted default constructor.
+		*/
+		lazy_dag_t() = delete;
+
+		/** \brief Construct a lazy DAG for a given block_number.
+		*
+		*	Only the cache is generated (or shared, if already loaded), so this is as quick as constructing a cache_t.
+		*	\param block_number is the block number for which to construct a lazy DAG.
+		*	\param budget_bytes is the most bytes of the dataset which may be resident at once.
+		*	\param callback (optional) may be used to monitor the progress of cache generation. Return false to cancel, true to continue.
+		*	\throws hash_exception if the dataset address space could not be reserved.
+		*/
+		lazy_dag_t(uint64_t const block_number, size_type budget_bytes, progress_callback_type = [](size_type, size_type, int){ return true; });
+
+		/** \brief Get the epoch number for which this lazy DAG is valid.
+		*
+		*	\returns uint64_t representing the epoch number (block_number / constants::EPOCH_LENGTH)
+		*/
+		uint64_t epoch() const;
+
+		/** \brief Get the size of the DAG data in bytes, resident or not.
+		*
+		*	\returns size_type representing the size of the DAG data in bytes.
+		*/
+		size_type size() const;
+
+		/** \brief Get the cache items are computed from.
+		*
+		*	\return cache_t of the cache for this DAG.
+		*/
+		cache_t get_cache() const;
+
+		/** \brief Read an item of the dataset, computing it if it is not resident.
+		*
+		*	\param index is the index of the item in the dataset.
+		*	\param out points to constants::HASH_WORDS nodes which receive the item.
+		*/
+		void dataset_item(uint32_t index, node * out) const;
+
+		/** \brief Change the most bytes of the dataset which may be resident, releasing pages if it shrinks.
+		*
+		*	\param budget_bytes is the new budget.
+		*/
+		void set_budget(size_type budget_bytes) const;
+
+		/** \brief Get statistics about reads and residency.
+		*
+		*	\return stats_t of this lazy DAG.
+		*/
+		stats_t get_stats() const;
+
+		/** \brief lazy_dag_t private implementation.
+		*/
+		struct impl_t;
+
+		/** \brief shared_ptr to impl allows default moving/copying of a lazy DAG, copies share resident items.
+		*/
+		::std::shared_ptr<impl_t> impl;
+	};
+
+	/** \brief throttle_mode values select how fast background DAG generation may run.
+	*/
+	enum throttle_mode
+	{
+		throttle_none,					/**< throttle_none generates as fast as the background thread can */
+		throttle_items_per_second,		/**< throttle_items_per_second caps generation at throttle_policy_t::items_per_second */
+		throttle_bandwidth_fraction		/**< throttle_bandwidth_fraction caps generation at a fraction of the rate it measures when running flat out */
+	};
+
+	/** \brief throttle_policy_t determines how background DAG generation shares memory bandwidth with foreground hashing.
+	*
+	*	Each DAG item reads constants::DATASET_PARENTS random cache items, so generation is bound by memory bandwidth and
+	*	competes with full hashes for it. Generation is paced in slices of constants::CALLBACK_FREQUENCY items, sleeping
+	*	between slices to keep to the target rate.
+	*/
+	struct throttle_policy_t
+	{
+		/** \brief How the generation rate is capped.
+		*/
+		throttle_mode mode;
 
-		/** \brief Get the cache for this DAG.
+		/** \brief The most items to generate per second, for throttle_items_per_second.
+		*/
+		double items_per_second;
+
+		/** \brief The fraction of the measured flat out rate to generate at, between 0 and 1, for throttle_bandwidth_fraction.
+		*
+		*	The first slices are generated flat out to measure the rate, so it reflects the memory bandwidth available at the time.
+		*/
+		double bandwidth_fraction;
+
+		/** \brief How far the full hash rate of the process may fall below its recent peak before generation backs off, e.g. 0.05 for 5%.
+		*
+		*	Generation halves its rate each slice the hash rate is below this, and recovers gradually once it is not.
+		*	0 disables adapting to the hash rate.
+		*/
+		double foreground_tolerance;
+	};
+
+	/** \brief throttle_stats_t reports how background DAG generation has been paced.
+	*/
+	struct throttle_stats_t
+	{
+		/** \brief The fraction of the time since generation started which was spent generating rather than paused, between 0 and 1.
+		*/
+		double duty_cycle;
+
+		/** \brief The average number of items generated per second since generation started.
+		*/
+		double items_per_second;
+
+		/** \brief The average memory bandwidth used by generation since it started, in bytes per second.
+		*/
+		double bytes_per_second;
+
+		/** \brief The rate generation is currently held to in items per second, or 0 if it is not held back.
+		*/
+		double target_items_per_second;
+	};
+
+	/** \brief progressive_dag_t is a DAG which is generated or loaded in the background, and may be hashed with meanwhile.
+	*
+	*	The cache is available long before the DAG is, so items which are not yet ready are computed from the cache instead.
+	*	A watermark of how many items are ready is published as the DAG is filled in, in order, and hashes read the items below
+	*	it from the DAG. Hashing starts at light speed and reaches full speed once the DAG is complete.
+	*	Once complete, the DAG is added to the DAG cache as if it had been constructed by dag_t.
+	*/
+	struct progressive_dag_t
+	{
+		/** \brief size_type represents sizes used by a DAG.
+		*/
+		using size_type = dag_t::size_type;
+
+		/** \brief default copy constructor.
+		*/
+		progressive_dag_t(progressive_dag_t const &) = default;
+
+		/** \brief default copy assignment operator.
+		*/
+		progressive_dag_t & operator=(progressive_dag_t const &) = default;
+
+		/** \brief default move constructor.
+		*/
+		progressive_dag_t(progressive_dag_t &&) = default;
+
+		/** \brief default move assignment operator.
+		*/
+		progressive_dag_t & operator=(progressive_dag_t &&) = default;
+
+		/** \brief default destructor, the DAG is cancelled if it is not complete when the last copy is destroyed.
+		*/
+		~progressive_dag_t() = default;
+
+		/** \brief explicitly deleted default constructor.
+		*/
+		progressive_dag_t() = delete;
+
+		/** \brief Start generating a DAG for a given block_number in the background.
+		*
+		*	If this DAG is already loaded in memory it is complete straight away.
+		*	\param block_number is the block number for which to generate a DAG.
+		*	\param callback (optional) is called from the background thread to monitor progress. Return false to cancel, true to continue.
+		*	\param pool (optional) is the thread_pool_t the DAG is generated on, as a priority_background task.
+		*/
+		progressive_dag_t(uint64_t const block_number, progress_callback_type = [](size_type, size_type, int){ return true; }, thread_pool_t const & pool = thread_pool_t::get_default());
+
+		/** \brief Start loading a DAG from a file in the background.
+		*
+		*	If this DAG is already loaded in memory it is complete straight away. The verify policy is applied once the file is read,
+		*	and a DAG which fails it stops being read from, so hashes fall back to the cache.
+		*	\param file_path is the path to the file the DAG should be loaded from.
+		*	\param callback (optional) is called from the background thread to monitor progress. Return false to cancel, true to continue.
+		*	\param pool (optional) is the thread_pool_t the DAG is loaded on, as a priority_background task.
+		*/
+		progressive_dag_t(::std::string const & file_path, progress_callback_type = [](size_type, size_type, int){ return true; }, thread_pool_t const & pool = thread_pool_t::get_default());
+
+		/** \brief Get the epoch number for which this DAG is valid, waiting for the cache if necessary.
+		*
+		*	\throws hash_exception if the cache could not be generated or loaded.
+		*	\returns uint64_t representing the epoch number (block_number / constants::EPOCH_LENGTH)
+		*/
+		uint64_t epoch() const;
+
+		/** \brief Get the cache for this DAG, waiting for it if necessary.
 		*
+		*	\throws hash_exception if the cache could not be generated or loaded.
 		*	\return cache_t of the cache for this DAG.
 		*/
 		cache_t get_cache() const;
 
-		/** \brief Unload a DAG.
+		/** \brief Get the number of items at the start of the DAG which are ready to be read.
 		*
-		*	To actually free a DAG from memory, call this function on a DAG. The DAG will then be released from the internal cache.
-		*	Once all references to the DAG for this epoch are destroyed, it will be freed.
+		*	\return uint32_t count of ready items, 0 until the cache is available.
 		*/
-		void unload() const;
+		uint32_t ready_items() const;
 
-		/** \brief Get the size of the DAG data in bytes.
+		/** \brief Determine whether the DAG is complete.
 		*
-		*	\param block_number is the block number for which DAG size to compute.
-		*	\return size_type representing the size of the DAG data in bytes.
+		*	\return bool true if the DAG was built successfully, false if it is still being built or failed.
 		*/
-		static size_type get_full_size(uint64_t const block_number) noexcept;
+		bool is_ready() const;
 
-		/** \brief Determine whether the DAG for this epoch is already loaded
+		/** \brief Wait for the DAG to be complete.
 		*
-		*	\param epoch is the epoch number for which to determine if a DAG is already loaded.
-		*	\return bool true if we have this DAG epoch loaded, false otherwise.
+		*	\throws hash_exception if the DAG could not be generated or loaded, or failed verification.
+		*	\return dag_t of the complete DAG.
 		*/
-		static bool is_loaded(uint64_t const epoch);
+		dag_t wait() const;
 
-		/** \brief Get the epoch numbers for which we already have a DAG loaded.
+		/** \brief Get how generation of this DAG has been paced so far.
 		*
-		*	\return ::std::vector containing epoch numbers for DAGs that are already loaded.
+		*	\return throttle_stats_t of the generation, all zero for a DAG which is loaded from a file or was already in memory.
 		*/
-		static ::std::vector<uint64_t> get_loaded();
+		throttle_stats_t throttle_stats() const;
 
-		/** \brief dag_t private implementation.
+		/** \brief Set how DAGs which are subsequently generated in the background are paced.
+		*
+		*	The default is throttle_none. Loading a DAG from a file is not paced.
+		*	\param policy is the throttle_policy_t to apply to new progressive DAGs.
 		*/
-		struct impl_t;
+		static void set_throttle_policy(throttle_policy_t const & policy);
 
-		/** \brief shared_ptr to impl allows default moving/copying of cache. Internally, only one dag_t::impl_t per epoch will exist.
+		/** \brief Get how DAGs generated in the background are paced.
 		*
-		*	Since DAGs consume a large amount of memory, it is important that they are cached.
+		*	\return throttle_policy_t currently applied to new progressive DAGs.
+		*/
+		static throttle_policy_t get_throttle_policy();
+
+		/** \brief progressive_dag_t private implementation.
+		*/
+		struct impl_t;
+
+		/** \brief shared_ptr to impl allows default moving/copying of a progressive DAG, copies share the background work.
 		*/
 		::std::shared_ptr<impl_t> impl;
 	};
@@ -666,6 +2006,162 @@ namespace egihash
 		*	\return result_t containing hashed data
 		*/
 		result_t hash(dag_t const & dag, h256_t const & header_hash, uint64_t const nonce);
+
+		/** \brief Compute the full Egihash of many nonces for the same header.
+		*
+		*	Up to constants::HASH_BATCH_LANES hashes are computed in lockstep, so that the DAG reads of every lane are prefetched
+		*	before any of them is mixed. This keeps many DAG reads in flight at once, instead of one at a time.
+		*	\param dag A const reference to the DAG for the current epoch.
+		*	\param header_hash A h256_t (Keccak-256) hash of the truncated block header.
+		*	\param nonces points to count nonces to hash.
+		*	\param count is the number of nonces to hash.
+		*	\param results points to count result_t which receive the result of each nonce.
+		*	\throws hash_exception on error
+		*/
+		void hash_batch(dag_t const & dag, h256_t const & header_hash, uint64_t const * nonces, ::std::size_t count, result_t * results);
+
+		/** \brief The full Egihash function, reading items from a lazy DAG.
+		*
+		*	\param dag A const reference to the lazy DAG for the current epoch
+		*	\param input_data A pointer to the start of the data to be hashed
+		*	\param input_size The number of bytes of input data to hash
+		*	\throws hash_exception on error
+		*	\return result_t containing hashed data
+		*/
+		result_t hash(lazy_dag_t const & dag, void const * input_data, lazy_dag_t::size_type input_size);
+
+		/** \brief The full Egihash function, reading items from a lazy DAG.
+		*
+		*	\param dag A const reference to the lazy DAG for the current epoch
+		*	\param header_hash A h256_t (Keccak-256) hash of the truncated block header
+		*	\param nonce An unsigned 64-bit integer stored in little endian byte order
+		*	\throws hash_exception on error
+		*	\return result_t containing hashed data
+		*/
+		result_t hash(lazy_dag_t const & dag, h256_t const & header_hash, uint64_t const nonce);
+
+		/** \brief The full Egihash function, reading ready items from a DAG being built and computing the rest from its cache.
+		*
+		*	\param dag A const reference to the progressive DAG for the current epoch
+		*	\param input_data A pointer to the start of the data to be hashed
+		*	\param input_size The number of bytes of input data to hash
+		*	\throws hash_exception on error, or if the cache could not be generated or loaded
+		*	\return result_t containing hashed data
+		*/
+		result_t hash(progressive_dag_t const & dag, void const * input_data, progressive_dag_t::size_type input_size);
+
+		/** \brief The full Egihash function, reading ready items from a DAG being built and computing the rest from its cache.
+		*
+		*	\param dag A const reference to the progressive DAG for the current epoch
+		*	\param header_hash A h256_t (Keccak-256) hash of the truncated block header
+		*	\param nonce An unsigned 64-bit integer stored in little endian byte order
+		*	\throws hash_exception on error, or if the cache could not be generated or loaded
+		*	\return result_t containing hashed data
+		*/
+		result_t hash(progressive_dag_t const & dag, h256_t const & header_hash, uint64_t const nonce);
+
+		/** \brief solution_t is a nonce found by a search whose hash meets the boundary.
+		*/
+		struct solution_t
+		{
+			h256_t header_hash;
+			uint64_t nonce;
+			result_t result;
+		};
+
+		/** \brief search_t is a multi-threaded nonce search over a DAG, suitable for use as a CPU mining backend.
+		*
+		*	Each job runs as a number of worker tasks on a thread_pool_t, and setting a new job takes effect within one batch of constants::HASH_BATCH_LANES hashes.
+		*	The nonce range of a job is split across the workers, and workers which finish early steal work from the others.
+		*	Solutions are passed back through a bounded lock-free queue, workers pause while the queue is full.
+		*/
+		struct search_t
+		{
+			/** \brief explicitly deleted copy constructor.
+			*/
+			search_t(search_t const &) = delete;
+
+			/** \brief explicitly deleted copy assignment operator.
+			*/
+			search_t & operator=(search_t const &) = delete;
+
+			/** \brief explicitly deleted default constructor.
+			*/
+			search_t() = delete;
+
+			/** \brief prepare a search.
+			*
+			*	\param dag is the DAG to search, which is kept loaded for as long as the search exists.
+			*	\param threads (optional) is the number of workers, or 0 for one per thread of the pool.
+			*	\param pool (optional) is the thread_pool_t the workers run on.
+			*/
+			explicit search_t(dag_t const & dag, unsigned threads = 0, thread_pool_t const & pool = thread_pool_t::get_default());
+
+			/** \brief abandon the current job and wait for its workers to return.
+			*/
+			~search_t();
+
+			/** \brief Replace the current job, abandoning any work left on the previous job.
+			*
+			*	\param header_hash is the header hash to search nonces for.
+			*	\param start_nonce is the first nonce to try.
+			*	\param count is the number of nonces to try.
+			*	\param boundary is the largest acceptable result value, see meets_boundary().
+			*/
+			void set_job(h256_t const & header_hash, uint64_t start_nonce, uint64_t count, h256_t const & boundary);
+
+			/** \brief Abandon the current job, leaving the workers idle.
+			*/
+			void stop();
+
+			/** \brief Wait until every nonce of the current job has been tried, or the search is stopped.
+			*/
+			void wait();
+
+			/** \brief Wait for a limited time until every nonce of the current job has been tried, or the search is stopped.
+			*
+			*	\param timeout is the longest time to wait.
+			*	\return bool true if the job is finished, false if the timeout expired first.
+			*/
+			bool wait_for(::std::chrono::microseconds timeout);
+
+			/** \brief Take a solution from the solution queue without blocking.
+			*
+			*	\param solution receives the solution, if there is one.
+			*	\return bool true if a solution was taken, false if the queue is empty.
+			*/
+			bool pop(solution_t & solution);
+
+			/** \brief Get the number of hashes computed by this search so far.
+			*/
+			uint64_t hash_count() const;
+
+			/** \brief Get the number of workers.
+			*/
+			unsigned threads() const;
+
+			/** \brief search_t private implementation.
+			*/
+			struct impl_t;
+
+			/** \brief the implementation is referred to by the workers of running jobs, so a search may not be copied.
+			*/
+			::std::unique_ptr<impl_t> impl;
+		};
+
+		/** \brief Search a range of nonces for solutions using several threads.
+		*
+		*	\param dag A const reference to the DAG for the current epoch.
+		*	\param header_hash A h256_t (Keccak-256) hash of the truncated block header.
+		*	\param start_nonce is the first nonce to try.
+		*	\param count is the number of nonces to try.
+		*	\param boundary is the largest acceptable result value, see meets_boundary().
+		*	\param threads (optional) is the number of workers, or 0 for one per thread of the pool.
+		*	\param pool (optional) is the thread_pool_t the workers run on.
+		*	\throws hash_exception on error
+		*	\return ::std::vector of every solution in the range, ordered by nonce.
+		*/
+		::std::vector<solution_t> search(dag_t const & dag, h256_t const & header_hash, uint64_t start_nonce, uint64_t count, h256_t const & boundary, unsigned threads = 0, thread_pool_t const & pool = thread_pool_t::get_default());
 	}
 
 	namespace light
@@ -705,6 +2201,286 @@ namespace egihash
 		*/
 		result_t hash(cache_t const & cache, h256_t const & header_hash, uint64_t const nonce);
 	}
+
+	/** \brief Cheaply check whether a claimed mixhash can meet a boundary.
+	*
+	*	The result value of a hash depends only on the header hash, the nonce and the mixhash, so it can be computed from a
+	*	claimed mixhash with two Keccak hashes and no DAG or cache reads. A submission which fails this check is certainly invalid.
+	*	A submission which passes it still needs a full or light hash to confirm that the claimed mixhash is correct.
+	*	\param header_hash A h256_t (Keccak-256) hash of the truncated block header.
+	*	\param nonce An unsigned 64-bit integer stored in little endian byte order.
+	*	\param mixhash is the claimed mixhash.
+	*	\param boundary is the largest acceptable result value, see meets_boundary().
+	*	\throws hash_exception on error
+	*	\return bool true if the value implied by the mixhash meets the boundary, false otherwise.
+	*/
+	bool quick_check(h256_t const & header_hash, uint64_t const nonce, h256_t const & mixhash, h256_t const & boundary);
+
+	/** \brief submission_t is a claimed proof of work to be checked by verify_batch.
+	*/
+	struct submission_t
+	{
+		uint64_t block_number;
+		h256_t header_hash;
+		uint64_t nonce;
+		h256_t mixhash;
+		h256_t boundary;
+	};
+
+	/** \brief verification_t is the outcome of checking a submission_t.
+	*/
+	struct verification_t
+	{
+		/** \brief true if the computed mixhash matches the claimed mixhash and the computed value meets the boundary.
+		*/
+		bool valid;
+
+		/** \brief true if result was computed or taken from the result cache, false if the submission failed quick_check().
+		*/
+		bool computed;
+
+		/** \brief the hash of the submission if computed is true, otherwise the claimed mixhash and the value it implies.
+		*/
+		result_t result;
+	};
+
+	/** \brief Check many submissions at once.
+	*
+	*	Each submission is first checked with quick_check(), and rejected without computing its hash if it fails. Such a submission is
+	*	not computed, and its result holds the claimed mixhash and the value it implies.
+	*	The remaining submissions are grouped by epoch. Epochs whose DAG is loaded are checked with full hashes, interleaved as by full::hash_batch.
+	*	Other epochs are checked with light hashes, generating their cache if it is not loaded. The work is spread across the threads of a pool.
+	*	\param submissions points to count submissions to check.
+	*	\param count is the number of submissions.
+	*	\param threads (optional) is the most threads to use at once, or 0 for every thread of the pool.
+	*	\param pool (optional) is the thread_pool_t to run on.
+	*	\throws hash_exception on error
+	*	\return ::std::vector of verification_t, in the same order as the submissions.
+	*/
+	::std::vector<verification_t> verify_batch(submission_t const * submissions, ::std::size_t count, unsigned threads = 0, thread_pool_t const & pool = thread_pool_t::get_default());
+
+	/** \brief result_cache_stats_t reports how effective the result cache has been.
+	*/
+	struct result_cache_stats_t
+	{
+		uint64_t hits;				/**< hashes answered from the result cache */
+		uint64_t misses;			/**< hashes which were not in the result cache and were computed */
+		::std::size_t size;			/**< results held */
+		::std::size_t capacity;		/**< the most results held */
+	};
+
+	/** \brief Set the size of the result cache, which memoizes hashes by epoch, header hash and nonce.
+	*
+	*	Full nodes receive the same block from many peers and pools see shares resubmitted, so the same hash is often checked
+	*	several times. With the result cache enabled, the header hash and nonce overloads of light::hash and full::hash, and
+	*	verify_batch(), look the hash up before computing it. The result cache is shared by every thread, split into shards which
+	*	each evict their least recently used results. Resizing the result cache empties it and resets its statistics.
+	*	It is not meant for mining, where every nonce is new, and full::hash_batch and full::search bypass it.
+	*	\param capacity is the most results to hold in total, dealt out between up to 16 shards, or 0 to disable the result cache (the default).
+	*/
+	void set_result_cache_size(::std::size_t capacity);
+
+	/** \brief Get the hit statistics of the result cache.
+	*
+	*	\return result_cache_stats_t since the result cache was sized, all zero if it is disabled.
+	*/
+	result_cache_stats_t get_result_cache_stats();
+
+	/** \brief dag_store manages a directory of DAG and cache files.
+	*
+	*	Files are named by epoch and seedhash, e.g. egihash-0-290decd9548b62a8.dag, so a store may be shared by several processes.
+	*	Existing files are discovered when the store is opened, new files are written atomically and the total size of the files
+	*	is kept within a disk quota by pruning the oldest epochs. The store can also record which epochs are resident in memory,
+	*	so that a restarted process can re-warm them in the background.
+	*/
+	struct dag_store
+	{
+		/** \brief size_type represents sizes of the files in a store.
+		*/
+		using size_type = uint64_t;
+
+		/** \brief file_kind is the kind of data held by a file in the store.
+		*/
+		enum file_kind
+		{
+			dag_file,
+			cache_file
+		};
+
+		/** \brief entry_t describes a file in the store.
+		*/
+		struct entry_t
+		{
+			file_kind kind;
+			uint64_t epoch;
+			::std::string path;
+			size_type size;
+		};
+
+		/** \brief unlimited is the quota of a store which is never pruned.
+		*/
+		static constexpr size_type unlimited = 0;
+
+		/** \brief default copy constructor.
+		*/
+		dag_store(dag_store const &) = default;
+
+		/** \brief default copy assignment operator.
+		*/
+		dag_store & operator=(dag_store const &) = default;
+
+		/** \brief default move constructor.
+		*/
+		dag_store(dag_store &&) = default;
+
+		/** \brief default move assignment operator.
+		*/
+		dag_store & operator=(dag_store &&) = default;
+
+		/** \brief default destructor.
+		*/
+		~dag_store() = default;
+
+		/** \brief explicitly deleted default constructor.
+		*/
+		dag_store() = delete;
+
+		/** \brief open a store, creating the directory if it does not exist, and discover the files it contains.
+		*
+		*	\param directory is the path of the directory holding the store.
+		*	\param quota (optional) is the maximum total size in bytes of the files in the store, or unlimited.
+		*	\throws hash_exception if the directory can not be created or read.
+		*/
+		explicit dag_store(::std::string const & directory, size_type quota = unlimited);
+
+		/** \brief Get the directory holding the store.
+		*/
+		::std::string directory() const;
+
+		/** \brief Get the disk quota of the store.
+		*/
+		size_type quota() const;
+
+		/** \brief Set the disk quota of the store, pruning the oldest epochs if it is exceeded.
+		*/
+		void set_quota(size_type quota);
+
+		/** \brief Get the total size in bytes of the files in the store.
+		*/
+		size_type usage() const;
+
+		/** \brief Discover the files in the store again, e.g. after another process has written to it.
+		*
+		*	Files whose name does not match the seedhash of their epoch are ignored, as are files of epochs beyond the first
+		*	constants::SEEDHASH_SEARCH_EPOCHS and partial writes of other processes.
+		*	Partial writes left behind by processes which no longer exist are removed.
+		*/
+		void rescan();
+
+		/** \brief Get the files in the store, ordered by epoch.
+		*/
+		::std::vector<entry_t> entries() const;
+
+		/** \brief Determine whether the store contains a file.
+		*
+		*	\param kind is the kind of file.
+		*	\param epoch is the epoch of the file.
+		*	\return bool true if the store contains this file, false otherwise.
+		*/
+		bool contains(file_kind kind, uint64_t epoch) const;
+
+		/** \brief Get the path at which the store keeps a file.
+		*
+		*	\param kind is the kind of file.
+		*	\param epoch is the epoch of the file.
+		*	\return ::std::string containing the path of the file, whether or not it exists.
+		*/
+		::std::string path(file_kind kind, uint64_t epoch) const;
+
+		/** \brief Get the DAG for an epoch, loading it from the store or generating and storing it.
+		*
+		*	\param epoch is the epoch of the DAG.
+		*	\param callback (optional) may be used to monitor the progress of DAG loading, generation and saving. Return false to cancel, true to continue.
+		*/
+		dag_t get_dag(uint64_t epoch, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Get the cache for an epoch, loading it from the store or generating and storing it.
+		*
+		*	\param epoch is the epoch of the cache.
+		*	\param callback (optional) may be used to monitor the progress of cache loading, generation and saving. Return false to cancel, true to continue.
+		*/
+		cache_t get_cache(uint64_t epoch, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Atomically write a DAG to the store, pruning older epochs to stay within the quota.
+		*
+		*	Older epochs are only pruned once the file has been written, and newer epochs are never pruned to make room for it.
+		*	\param dag is the DAG to store.
+		*	\param callback (optional) may be used to monitor the progress of DAG saving. Return false to cancel, true to continue.
+		*	\return bool true if the file was written, false if it would not fit within the quota.
+		*/
+		bool store(dag_t const & dag, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Atomically write a cache to the store, pruning older epochs to stay within the quota.
+		*
+		*	Older epochs are only pruned once the file has been written, and newer epochs are never pruned to make room for it.
+		*	\param cache is the cache to store.
+		*	\param callback (optional) may be used to monitor the progress of cache saving. Return false to cancel, true to continue.
+		*	\return bool true if the file was written, false if it would not fit within the quota.
+		*/
+		bool store(cache_t const & cache, progress_callback_type callback = [](size_type, size_type, int){ return true; });
+
+		/** \brief Remove the oldest epochs until the store is within its quota.
+		*
+		*	\return ::std::vector of the entries which were removed.
+		*/
+		::std::vector<entry_t> prune();
+
+		/** \brief Record which DAGs and caches are currently loaded, for warm().
+		*/
+		void record_resident() const;
+
+		/** \brief Get the epochs which were recorded as resident by record_resident().
+		*
+		*	\param kind is the kind of data to get the resident epochs of.
+		*	\return ::std::vector containing the recorded epoch numbers.
+		*/
+		::std::vector<uint64_t> resident(file_kind kind) const;
+
+		/** \brief Load the recorded resident epochs from the store in the background.
+		*
+		*	Only epochs which have a file in the store are loaded, nothing is generated.
+		*	\param callback (optional) may be used to monitor the progress of loading. Return false to cancel, true to continue.
+		*	\param pool (optional) is the thread_pool_t the epochs are loaded on, as a priority_background task.
+		*	\return ::std::future which becomes ready when warming has finished, and rethrows any hash_exception.
+		*/
+		::std::future<void> warm(progress_callback_type callback = [](size_type, size_type, int){ return true; }, thread_pool_t const & pool = thread_pool_t::get_default()) const;
+
+		/** \brief dag_store private implementation.
+		*/
+		struct impl_t;
+
+		/** \brief shared_ptr to impl allows copies of a store to share their view of the directory.
+		*/
+		::std::shared_ptr<impl_t> impl;
+	};
+}
+
+namespace std
+{
+	/** \brief hash of an h256_t, so hashes may key unordered containers.
+	*
+	*	Keccak hashes are uniformly distributed, so the leading bytes serve as the hash.
+	*/
+	template <>
+	struct hash<::egihash::h256_t>
+	{
+		size_t operator()(::egihash::h256_t const & h) const noexcept
+		{
+			size_t ret;
+			::std::memcpy(&ret, h.b, sizeof(ret));
+			return ret;
+		}
+	};
 }
 
 #endif // __cplusplus
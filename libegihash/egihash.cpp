@@ -3,6 +3,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "egihash.h"
+#include "epoch_sizes.h"
+#include "fast_divisor.h"
+#include "topology.h"
 extern "C"
 {
 #include "keccak-tiny.h"
@@ -11,17 +14,38 @@ extern "C"
 #include <stdint.h>
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <list>
 #include <map>
 #include <mutex>
+#include <new>
+#include <random>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <iostream> // TODO: remove me (debugging)
 
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
 namespace
 {
 	using namespace egihash;
@@ -101,6 +125,124 @@ namespace
 	static_assert(dag_file_header_t::magic_size == 12, "Magic size invalid.");
 	static_assert(sizeof(dag_file_header_t) == 64, "Dag header size invalid.");
 
+#pragma pack(push, 1)
+	struct cache_file_header_t
+	{
+		static constexpr size_t magic_size = 16;
+		using size_type = cache_t::size_type;
+
+		char magic[magic_size];
+		uint32_t major_version;
+		uint32_t revision;
+		uint32_t minor_version;
+		uint32_t reserved;
+		uint64_t epoch;
+		uint64_t size;
+		uint64_t checksum;
+		uint8_t seedhash[h256_t::hash_size];
+		uint8_t padding[40];
+
+		cache_file_header_t() = delete;
+		cache_file_header_t(cache_file_header_t const &) = default;
+		cache_file_header_t & operator=(cache_file_header_t const &) = default;
+		cache_file_header_t(cache_file_header_t &&) = default;
+		cache_file_header_t & operator=(cache_file_header_t &&) = default;
+		~cache_file_header_t() = default;
+
+		cache_file_header_t(uint64_t epoch, uint64_t size, uint64_t checksum, h256_t const & seed)
+		: magic{0}
+		, major_version(constants::MAJOR_VERSION)
+		, revision(constants::REVISION)
+		, minor_version(constants::MINOR_VERSION)
+		, reserved(0)
+		, epoch(epoch)
+		, size(size)
+		, checksum(checksum)
+		, seedhash{0}
+		, padding{0}
+		{
+			::std::memcpy(magic, constants::CACHE_MAGIC_BYTES, sizeof(constants::CACHE_MAGIC_BYTES));
+			::std::memcpy(seedhash, seed.b, sizeof(seedhash));
+		}
+
+		cache_file_header_t(read_function_type read)
+		: magic{0}
+		, major_version(0)
+		, revision(0)
+		, minor_version(0)
+		, reserved(0)
+		, epoch(0)
+		, size(0)
+		, checksum(0)
+		, seedhash{0}
+		, padding{0}
+		{
+			read(this, sizeof(*this));
+
+			if (::std::memcmp(magic, constants::CACHE_MAGIC_BYTES, sizeof(constants::CACHE_MAGIC_BYTES)) != 0)
+			{
+				throw hash_exception("Not a cache file");
+			}
+
+			if ((major_version != constants::MAJOR_VERSION) || (revision != constants::REVISION))
+			{
+				throw hash_exception("Cache version is invalid");
+			}
+
+			// validate size of cache
+			if (size != cache_t::get_cache_size((epoch * constants::EPOCH_LENGTH) + 1))
+			{
+				throw hash_exception("Cache is corrupt");
+			}
+		}
+
+		// validating the seedhash is kept separate as it is relatively expensive to compute
+		bool valid_seedhash() const
+		{
+			h256_t const expected = cache_t::get_seedhash(epoch * constants::EPOCH_LENGTH);
+			return ::std::memcmp(seedhash, expected.b, sizeof(seedhash)) == 0;
+		}
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(constants::CACHE_MAGIC_BYTES) <= cache_file_header_t::magic_size, "Cache magic size invalid.");
+	static_assert(sizeof(cache_file_header_t) == constants::CACHE_FILE_HEADER_SIZE, "Cache header size invalid.");
+
+#pragma pack(push, 1)
+	struct dag_file_trailer_t
+	{
+		static constexpr size_t magic_size = sizeof(constants::DAG_TRAILER_MAGIC_BYTES);
+
+		char magic[magic_size];
+		uint32_t reserved;
+		uint64_t checksum;
+
+		dag_file_trailer_t(uint64_t checksum)
+		: magic{0}
+		, reserved(0)
+		, checksum(checksum)
+		{
+			::std::memcpy(magic, constants::DAG_TRAILER_MAGIC_BYTES, magic_size);
+		}
+
+		dag_file_trailer_t(read_function_type read)
+		: magic{0}
+		, reserved(0)
+		, checksum(0)
+		{
+			read(magic, magic_size);
+			if (std::string(magic, magic_size - 1) != constants::DAG_TRAILER_MAGIC_BYTES)
+			{
+				throw hash_exception("DAG checksum is corrupt");
+			}
+			read(&reserved, sizeof(reserved));
+			read(&checksum, sizeof(checksum));
+		}
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(dag_file_trailer_t) == constants::DAG_FILE_TRAILER_SIZE, "Dag trailer size invalid.");
+
 	inline uint32_t decode_int(uint8_t const * data, uint8_t const * dataEnd) noexcept
 	{
 		if (!data || (dataEnd < (data + 3)))
@@ -144,13 +286,87 @@ namespace
 		return ret;
 	}
 
+	// (a * b) % m without overflowing
+	inline uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t m) noexcept
+	{
+#if defined(__SIZEOF_INT128__)
+		return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) % m);
+#else
+		if ((a <= 0xffffffff) && (b <= 0xffffffff))
+		{
+			return (a * b) % m;
+		}
+		uint64_t ret = 0;
+		for (a %= m; b != 0; b >>= 1)
+		{
+			if ((b & 1) != 0)
+			{
+				ret = (ret >= (m - a)) ? (ret - (m - a)) : (ret + a);
+			}
+			a = (a >= (m - a)) ? (a - (m - a)) : (a + a);
+		}
+		return ret;
+#endif
+	}
+
+	inline uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t m) noexcept
+	{
+		uint64_t ret = 1;
+		for (base %= m; exponent != 0; exponent >>= 1)
+		{
+			if ((exponent & 1) != 0)
+			{
+				ret = mul_mod(ret, base, m);
+			}
+			base = mul_mod(base, base, m);
+		}
+		return ret;
+	}
+
+	// deterministic Miller-Rabin, the first 12 prime bases are sufficient for every 64-bit x
 	template <typename IntegralType >
 	typename ::std::enable_if<::std::is_integral<IntegralType>::value, bool>::type
 	/*bool*/ is_prime(IntegralType x) noexcept
 	{
-		for (auto i = IntegralType(2); i <= ::std::sqrt(x); i++)
+		static constexpr uint64_t bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+		uint64_t const n = static_cast<uint64_t>(x);
+		if (n < 2)
+		{
+			return false;
+		}
+		for (auto const p : bases)
 		{
-			if ((x % i) == 0) return false;
+			if ((n % p) == 0)
+			{
+				return n == p;
+			}
+		}
+
+		uint64_t d = n - 1;
+		unsigned r = 0;
+		for (; (d & 1) == 0; d >>= 1)
+		{
+			r++;
+		}
+
+		for (auto const a : bases)
+		{
+			uint64_t y = pow_mod(a, d, n);
+			if ((y == 1) || (y == (n - 1)))
+			{
+				continue;
+			}
+			bool composite = true;
+			for (unsigned i = 1; (i < r) && composite; i++)
+			{
+				y = mul_mod(y, y, n);
+				composite = (y != (n - 1));
+			}
+			if (composite)
+			{
+				return false;
+			}
 		}
 		return true;
 	}
@@ -163,907 +379,3686 @@ namespace
 		return ((v1 * FNV_PRIME) ^ v2) % FNV_MODULUS;
 	}
 
-	template <size_t HashSize, int (*HashFunction)(uint8_t *, size_t, uint8_t const * in, size_t)>
-	struct sha3_base
+	// 64-bit FNV-1a applied to whole hash words, used to detect accidental corruption of stored DAG data
+	inline uint64_t checksum_words(uint64_t checksum, node const * begin, node const * end) noexcept
 	{
-		using deserialized_hash_t = ::std::vector<node>;
-		using size_type = ::std::size_t;
-
-		static constexpr size_type hash_size = HashSize;
-		static constexpr size_type data_size = HashSize / sizeof(node);
-		deserialized_hash_t data;
-
-		sha3_base(sha3_base const &) = default;
-		sha3_base(sha3_base &&) = default;
-		sha3_base & operator=(sha3_base const &) = default;
-		sha3_base & operator=(sha3_base &&) = default;
-		~sha3_base() = default;
+		constexpr uint64_t FNV64_PRIME = 0x100000001b3ull;
 
-		sha3_base()
-		:data(data_size)
+		for (; begin != end; begin++)
 		{
-
+			checksum = (checksum ^ begin->hword) * FNV64_PRIME;
 		}
+		return checksum;
+	}
 
-		sha3_base(::std::string const & input)
-		:sha3_base()
+	static constexpr uint64_t checksum_seed = 0xcbf29ce484222325ull;
+
+	// keccak-512 hash of input_size bytes into a single cache or DAG item
+	inline void sha3_512_item(node * out, void const * input, size_t input_size)
+	{
+		if (::sha3_512(reinterpret_cast<uint8_t *>(out), constants::HASH_BYTES, reinterpret_cast<uint8_t const *>(input), input_size) != 0)
 		{
-			compute_hash(input.c_str(), input.size());
+			throw hash_exception("Keccak-512 computation failed.");
 		}
+	}
 
-		sha3_base(void const * input, size_type const input_size)
-		:sha3_base()
+	// read item_count items in spans of IO_CHUNK_BYTES straight into dst, reporting progress after each span
+	// if ready is given, the number of items read so far is published to it after each span
+	void read_items(source_t & source, node * dst, size_t item_count, progress_callback_type callback, progress_callback_phase phase, char const * cancel_message, ::std::atomic<uint32_t> * ready = nullptr)
+	{
+		constexpr size_t chunk_items = constants::IO_CHUNK_BYTES / constants::HASH_BYTES;
+		for (size_t count = 0; count < item_count;)
 		{
-			compute_hash(input, input_size);
+			size_t const items = (::std::min)(chunk_items, item_count - count);
+			source.read(dst + (count * constants::HASH_WORDS), items * constants::HASH_BYTES);
+			count += items;
+			if (ready != nullptr)
+			{
+				ready->store(static_cast<uint32_t>(count), ::std::memory_order_release);
+			}
+			if (!callback(count, item_count, phase))
+			{
+				throw hash_exception(cancel_message);
+			}
 		}
+	}
 
-		inline void compute_hash(void const * input, size_type const input_size)
+	// write item_count items in spans of IO_CHUNK_BYTES, progress is accumulated in count
+	void write_items(sink_t & sink, node const * src, size_t item_count, size_t & count, size_t max_count, progress_callback_type callback, progress_callback_phase phase, char const * cancel_message)
+	{
+		constexpr size_t chunk_items = constants::IO_CHUNK_BYTES / constants::HASH_BYTES;
+		for (size_t written = 0; written < item_count;)
 		{
-			if (HashFunction(reinterpret_cast<uint8_t*>(data.data()), hash_size, reinterpret_cast<uint8_t const *>(input), input_size) != 0)
+			size_t const items = (::std::min)(chunk_items, item_count - written);
+			sink.write(src + (written * constants::HASH_WORDS), items * constants::HASH_BYTES);
+			written += items;
+			count += items;
+			if (!callback(count, max_count, phase))
 			{
-				throw hash_exception("Unable to compute hash"); // TODO: better message?
+				throw hash_exception(cancel_message);
 			}
 		}
+	}
 
-		inline deserialized_hash_t deserialize() const
+#if defined(MAP_HUGETLB) && !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif
+
+	// the default allocator_t, anonymous memory mapped pages rather than the heap so huge pages can be asked for
+	class page_allocator_t : public allocator_t
+	{
+	public:
+		void * allocate(size_t bytes, page_mode mode, page_backing & backing) override
 		{
-			return data;
+#if defined(MAP_HUGETLB)
+			// a huge page size is only tried if at most half of the last page would be wasted
+			if (mode == pages_huge)
+			{
+				static page_backing const huge_pages[] = { page_backing_huge_1g, page_backing_huge_2m };
+				for (auto const huge : huge_pages)
+				{
+					int const shift = page_shift(huge);
+					size_t const page_size = size_t(1) << shift;
+					if (bytes >= (page_size / 2))
+					{
+						void * const ptr = map(bytes, huge, MAP_HUGETLB | (shift << MAP_HUGE_SHIFT));
+						if (ptr != nullptr)
+						{
+							backing = huge;
+							return ptr;
+						}
+					}
+				}
+			}
+#endif
+
+			void * const ptr = map(bytes, page_backing_normal, 0);
+			if (ptr == nullptr)
+			{
+				throw ::std::bad_alloc();
+			}
+			backing = page_backing_normal;
+
+#if defined(MADV_HUGEPAGE)
+			if ((mode == pages_huge) && (::madvise(ptr, mapped_size(bytes, page_backing_normal), MADV_HUGEPAGE) == 0))
+			{
+				backing = page_backing_transparent;
+			}
+#else
+			(void)mode;
+#endif
+			return ptr;
 		}
 
-		inline static ::std::string serialize(deserialized_hash_t const & h)
+		void deallocate(void * memory, size_t bytes, page_backing backing) noexcept override
 		{
-			return std::string(reinterpret_cast<const char*>(h.data()), h.size() * sizeof(node));
+			::munmap(memory, mapped_size(bytes, backing));
 		}
 
-		operator ::std::string() const
+	private:
+		static int page_shift(page_backing backing) noexcept
 		{
-			// TODO: fast hex conversion
-			::std::stringstream ss;
-			ss << ::std::hex;
-			uint8_t const * iEnd = reinterpret_cast<uint8_t const *>(&data.back());
-			for (uint8_t const * i = reinterpret_cast<uint8_t const *>(data.data()); i != iEnd; i++)
+			switch (backing)
 			{
-				ss << ::std::setw(2) << ::std::setfill('0') << static_cast<uint16_t>(*i);
+				case page_backing_huge_1g:
+					return 30;
+				case page_backing_huge_2m:
+					return 21;
+				default:
+					return 0;
 			}
-			return ss.str();
 		}
-	};
 
-	struct sha3_256_t : public sha3_base<32, ::sha3_256>
-	{
-		sha3_256_t(::std::string const & input)
-		: sha3_base(input)
+		// mappings are whole pages of the size they were made with
+		static size_t mapped_size(size_t bytes, page_backing backing) noexcept
 		{
-
+			int const shift = page_shift(backing);
+			size_t const page_size = (shift != 0) ? (size_t(1) << shift) : static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+			return ((bytes + page_size - 1) / page_size) * page_size;
 		}
 
-		sha3_256_t(void const * input, size_type const input_size)
-		: sha3_base(input, input_size)
+		static void * map(size_t bytes, page_backing backing, int flags) noexcept
 		{
-
+			void * const ptr = ::mmap(nullptr, mapped_size(bytes, backing), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+			return (ptr == MAP_FAILED) ? nullptr : ptr;
 		}
 	};
 
-	struct sha3_512_t : public sha3_base<64, ::sha3_512>
+	// the nodes of a cache or DAG, either obtained from an allocator_t or adopted from the caller along with a hook to release them
+	class item_storage_t
 	{
-		sha3_512_t(::std::string const & input)
-		: sha3_base(input)
+	public:
+		item_storage_t() noexcept
+		: memory(nullptr)
+		, node_count(0)
+		, backing(page_backing_normal)
+		, locked(false)
+		, allocator()
+		, release_hook()
 		{
-
 		}
 
-		sha3_512_t(void const * input, size_type const input_size)
-		: sha3_base(input, input_size)
+		item_storage_t(size_t count, page_mode mode, ::std::shared_ptr<allocator_t> const & allocator)
+		: item_storage_t()
 		{
-
+			allocate(count, mode, allocator);
 		}
-	};
-
-	// TODO: unit tests / validation
-	template <typename HashType>
-	typename HashType::deserialized_hash_t hash_words(::std::string const & data)
-	{
-		return HashType(data).data;
-	}
 
-	template <typename HashType, typename DataType>
-	typename HashType::deserialized_hash_t hash_words(DataType * data_ptr, typename HashType::size_type data_size)
-	{
-		return HashType(data_ptr, data_size).data;
-	}
+		item_storage_t(item_storage_t && other) noexcept
+		: item_storage_t()
+		{
+			swap(other);
+		}
 
-	// TODO: unit tests / validation
-	template <typename HashType>
-	typename HashType::deserialized_hash_t hash_words(typename HashType::deserialized_hash_t const & deserialized)
-	{
-		auto const serialized = HashType::serialize(deserialized);
-		return hash_words<HashType>(serialized);
-	}
+		item_storage_t & operator=(item_storage_t && other) noexcept
+		{
+			release();
+			swap(other);
+			return *this;
+		}
 
-	template <typename HashFunc, typename DatasetType>
-	result_t hash_header_nonce(HashFunc hashfunc, DatasetType const & dataset, h256_t const & header_hash, uint64_t const nonce)
-	{
-		uint8_t const * nonce_bytes = reinterpret_cast<uint8_t const *>(&nonce);
+		item_storage_t(item_storage_t const &) = delete;
+		item_storage_t & operator=(item_storage_t const &) = delete;
 
-		// combine header_hash with nonce
-		uint8_t const bytes[sizeof(header_hash.b) + sizeof(nonce)] =
+		~item_storage_t()
 		{
-			header_hash.b[ 0], header_hash.b[ 1], header_hash.b[ 2], header_hash.b[ 3],
-			header_hash.b[ 4], header_hash.b[ 5], header_hash.b[ 6], header_hash.b[ 7],
-			header_hash.b[ 8], header_hash.b[ 9], header_hash.b[10], header_hash.b[11],
-			header_hash.b[12], header_hash.b[13], header_hash.b[14], header_hash.b[15],
-			header_hash.b[16], header_hash.b[17], header_hash.b[18], header_hash.b[19],
-			header_hash.b[20], header_hash.b[21], header_hash.b[22], header_hash.b[23],
-			header_hash.b[24], header_hash.b[25], header_hash.b[26], header_hash.b[27],
-			header_hash.b[28], header_hash.b[29], header_hash.b[30], header_hash.b[31],
+			release();
+		}
 
-			nonce_bytes[0], nonce_bytes[1], nonce_bytes[2], nonce_bytes[3],
-			nonce_bytes[4], nonce_bytes[5], nonce_bytes[6], nonce_bytes[7],
-		};
+		// replaces any existing nodes with count uninitialized nodes
+		void allocate(size_t count, page_mode mode, ::std::shared_ptr<allocator_t> const & from)
+		{
+			release();
+			size_t const bytes = count * sizeof(node);
+			if (bytes == 0)
+			{
+				return;
+			}
 
-		return hashfunc(dataset, bytes, sizeof(bytes));
-	}
-}
+			page_backing actual = page_backing_normal;
+			void * const ptr = from->allocate(bytes, mode, actual);
+			if (ptr == nullptr)
+			{
+				throw ::std::bad_alloc();
+			}
+			memory = ptr;
+			node_count = count;
+			backing = actual;
+			allocator = from;
+		}
 
-namespace egihash
-{
-	constexpr h256_t::size_type h256_t::hash_size;
+		// replaces any existing nodes with count nodes owned by the caller, release is called with them once they are no longer used
+		void adopt(void * items, size_t count, release_function_type release_items)
+		{
+			release();
+			memory = items;
+			node_count = count;
+			release_hook = release_items;
+		}
 
-	h256_t::h256_t(void const * input_data, size_type input_size)
-	: b{0}
-	{
-		if (::sha3_256(b, hash_size, reinterpret_cast<uint8_t const *>(input_data), input_size) != 0)
+		node * data() noexcept
 		{
-			throw hash_exception("Keccak-256 computation failed.");
+			return reinterpret_cast<node *>(memory);
 		}
-	}
 
-	::std::string h256_t::to_hex() const
-	{
-		// TODO: fast hex conversion
-		::std::stringstream ss;
-		ss << ::std::hex << ::std::nouppercase;
-		uint8_t const * iEnd = reinterpret_cast<uint8_t const *>(&b[hash_size]);
-		for (uint8_t const * i = reinterpret_cast<uint8_t const *>(&b[0]); i != iEnd; i++)
+		node const * data() const noexcept
 		{
-			ss << ::std::setw(2) << ::std::setfill('0') << static_cast<uint16_t>(*i);
+			return reinterpret_cast<node const *>(memory);
 		}
-		return ss.str();
-	}
 
-	h256_t::operator bool() const
-	{
-		return (::std::memcmp(&b[0], &empty_h256.b[0], sizeof(b)) != 0);
-	}
+		node & operator[](size_t index) noexcept
+		{
+			return data()[index];
+		}
 
-	bool h256_t::operator==(h256_t const & rhs) const
-	{
-		return (::std::memcmp(&b[0], &rhs.b[0], sizeof(b)) == 0);
-	}
+		node const & operator[](size_t index) const noexcept
+		{
+			return data()[index];
+		}
 
-	constexpr h512_t::size_type h512_t::hash_size;
+		size_t size() const noexcept
+		{
+			return node_count;
+		}
 
-	h512_t::h512_t(void const * input_data, size_type input_size)
-	: b{0}
-	{
-		if (::sha3_512(b, hash_size, reinterpret_cast<uint8_t const *>(input_data), input_size) != 0)
+		size_t size_bytes() const noexcept
 		{
-			throw hash_exception("Keccak-512 computation failed.");
+			return node_count * sizeof(node);
 		}
-	}
+
+		bool empty() const noexcept
+		{
+			return node_count == 0;
+		}
+
+		page_backing get_backing() const noexcept
+		{
+			return backing;
+		}
+
+		// locks the nodes in RAM, raising the soft RLIMIT_MEMLOCK to the hard limit if that is what stands in the way
+		bool lock() noexcept
+		{
+			if (locked || empty())
+			{
+				return locked;
+			}
+			if (::mlock(memory, size_bytes()) != 0)
+			{
+				struct rlimit limit;
+				if ((errno != ENOMEM) || (::getrlimit(RLIMIT_MEMLOCK, &limit) != 0) || (limit.rlim_cur == limit.rlim_max))
+				{
+					return false;
+				}
+				limit.rlim_cur = limit.rlim_max;
+				if ((::setrlimit(RLIMIT_MEMLOCK, &limit) != 0) || (::mlock(memory, size_bytes()) != 0))
+				{
+					return false;
+				}
+			}
+			locked = true;
+			return true;
+		}
+
+		bool is_locked() const noexcept
+		{
+			return locked;
+		}
+
+		// the bytes of the nodes which are in RAM, counted in whole pages
+		size_t resident_bytes() const
+		{
+			if (empty())
+			{
+				return 0;
+			}
+			uintptr_t const page_size = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+			uintptr_t const begin = reinterpret_cast<uintptr_t>(memory) & ~(page_size - 1);
+			uintptr_t const end = reinterpret_cast<uintptr_t>(memory) + size_bytes();
+			::std::vector<unsigned char> pages(static_cast<size_t>((end - begin + page_size - 1) / page_size));
+			if (::mincore(reinterpret_cast<void *>(begin), static_cast<size_t>(end - begin), pages.data()) != 0)
+			{
+				return 0;
+			}
+			size_t const resident = static_cast<size_t>(::std::count_if(pages.begin(), pages.end(), [](unsigned char page) { return (page & 1) != 0; }));
+			return (::std::min)(resident * static_cast<size_t>(page_size), size_bytes());
+		}
+
+	private:
+		void swap(item_storage_t & other) noexcept
+		{
+			::std::swap(memory, other.memory);
+			::std::swap(node_count, other.node_count);
+			::std::swap(backing, other.backing);
+			::std::swap(locked, other.locked);
+			allocator.swap(other.allocator);
+			release_hook.swap(other.release_hook);
+		}
+
+		void release() noexcept
+		{
+			if (locked)
+			{
+				::munlock(memory, size_bytes());
+			}
+			if (memory != nullptr)
+			{
+				if (allocator)
+				{
+					allocator->deallocate(memory, size_bytes(), backing);
+				}
+				else if (release_hook)
+				{
+					// nothing can be reported from a destructor, so a throwing hook is the caller's loss
+					try
+					{
+						release_hook(memory, size_bytes());
+					}
+					catch (...)
+					{
+					}
+				}
+			}
+			memory = nullptr;
+			node_count = 0;
+			backing = page_backing_normal;
+			locked = false;
+			allocator.reset();
+			release_hook = nullptr;
+		}
+
+		void * memory;
+		size_t node_count;
+		page_backing backing;
+		bool locked;
+		::std::shared_ptr<allocator_t> allocator;
+		release_function_type release_hook;
+	};
+
+	// locks the items of a cache or DAG in RAM as the lock mode asks
+	void lock_items(item_storage_t & items, memory_lock_mode mode)
+	{
+		if ((mode != lock_none) && !items.lock() && (mode == lock_required))
+		{
+			throw hash_exception("Could not lock items in memory, RLIMIT_MEMLOCK may be too low.");
+		}
+	}
+
+	// points items at item_count items held in memory which outlives the source, rather than copying them into memory of their own
+	// this is only done where the items would have been allocated from regular pages by the default allocator anyway
+	// returns false if nothing was consumed from the source, in which case the items should be read as usual
+	bool view_items(source_t & source, item_storage_t & items, size_t item_count, page_mode mode, ::std::shared_ptr<allocator_t> const & allocator, progress_callback_type callback, progress_callback_phase phase, char const * cancel_message)
+	{
+		::std::shared_ptr<void const> const owner = source.view_owner();
+		if (!owner || (mode != pages_normal) || (allocator != allocator_t::get_page_allocator()))
+		{
+			return false;
+		}
+
+		void const * const viewed = source.view(item_count * constants::HASH_BYTES);
+		if (viewed == nullptr)
+		{
+			return false;
+		}
+		if ((reinterpret_cast<uintptr_t>(viewed) % alignof(node)) == 0)
+		{
+			items.adopt(const_cast<void *>(viewed), item_count * constants::HASH_WORDS, [owner](void *, ::std::size_t) {});
+		}
+		else
+		{
+			items.allocate(item_count * constants::HASH_WORDS, mode, allocator);
+			::std::memcpy(items.data(), viewed, item_count * constants::HASH_BYTES);
+		}
+
+		if (!callback(item_count, item_count, phase))
+		{
+			throw hash_exception(cancel_message);
+		}
+		return true;
+	}
+
+	// saves a file under a temporary name and renames it over file_path once it is complete
+	// the file being replaced is never truncated, as a cache or DAG may still be loaded from a lent mapping of it
+	void save_file(::std::string const & file_path, ::std::function<void (sink_t &)> save)
+	{
+		::std::ostringstream temp_name;
+		temp_name << file_path << "." << ::getpid() << ".tmp";
+		::std::string const temp_path = temp_name.str();
+		try
+		{
+			fd_sink sink(temp_path);
+			save(sink);
+		}
+		catch (...)
+		{
+			::unlink(temp_path.c_str());
+			throw;
+		}
+
+		if (::rename(temp_path.c_str(), file_path.c_str()) != 0)
+		{
+			::unlink(temp_path.c_str());
+			throw hash_exception("Could not replace file.");
+		}
+	}
+
+	// memory policies of the mbind system call, which is called directly rather than through libnuma
+	constexpr int mpol_bind = 2;
+	constexpr int mpol_interleave = 3;
+	constexpr unsigned mpol_mf_move = 1u << 1;
+	constexpr size_t max_numa_nodes = 1024;
+
+	// the NUMA nodes of the system and the CPUs which belong to each of them
+	// nodes are referred to by their index here, which is the same as the node number unless some nodes are offline
+	// a fake topology deals the CPUs round robin to fake_nodes nodes and never binds memory, so it works on any machine
+	struct numa_topology_t
+	{
+		explicit numa_topology_t(uint32_t fake_nodes)
+		: fake(fake_nodes != 0)
+		{
+#if defined(__linux__)
+			if (!fake)
+			{
+				for (auto const node : topology::parse_id_list(topology::read_sysfs_line("/sys/devices/system/node/online")))
+				{
+					if (node < max_numa_nodes)
+					{
+						nodes.push_back(node);
+						node_cpus.push_back(topology::parse_id_list(topology::read_sysfs_line("/sys/devices/system/node/node" + ::std::to_string(node) + "/cpulist")));
+					}
+				}
+			}
+#endif
+
+			if (nodes.empty())
+			{
+				uint32_t const node_count = fake ? fake_nodes : 1;
+				uint32_t const cpu_count = (::std::max)(::std::thread::hardware_concurrency(), 1u);
+				nodes.resize(node_count);
+				node_cpus.resize(node_count);
+				for (uint32_t i = 0; i < node_count; i++)
+				{
+					nodes[i] = i;
+				}
+				for (uint32_t cpu = 0; cpu < cpu_count; cpu++)
+				{
+					node_cpus[cpu % node_count].push_back(cpu);
+				}
+			}
+
+			for (uint32_t i = 0; i < node_cpus.size(); i++)
+			{
+				for (auto const cpu : node_cpus[i])
+				{
+					if (cpu_node.size() <= cpu)
+					{
+						cpu_node.resize(cpu + 1, 0);
+					}
+					cpu_node[cpu] = i;
+				}
+			}
+		}
+
+		size_t size() const noexcept
+		{
+			return nodes.size();
+		}
+
+		// the node the calling thread is running on, which may change whenever the thread is rescheduled
+		uint32_t current_node() const noexcept
+		{
+#if defined(__linux__)
+			int const cpu = ::sched_getcpu();
+			if ((cpu >= 0) && (static_cast<size_t>(cpu) < cpu_node.size()))
+			{
+				return cpu_node[cpu];
+			}
+#endif
+			return 0;
+		}
+
+		// restricts the calling thread to the CPUs of a node, fails for nodes without CPUs
+		bool pin_thread(uint32_t node) const noexcept
+		{
+			return topology::pin_thread(node_cpus[node]);
+		}
+
+		// applies a memory policy over the given nodes to a page aligned range, moving pages which are already resident
+		bool bind(void * address, size_t bytes, int policy, ::std::vector<uint32_t> const & node_indices) const noexcept
+		{
+#if defined(__linux__) && defined(SYS_mbind)
+			if (fake || (address == nullptr) || (bytes == 0))
+			{
+				return false;
+			}
+			constexpr size_t word_bits = sizeof(unsigned long) * 8;
+			unsigned long mask[max_numa_nodes / word_bits] = {0};
+			for (auto const i : node_indices)
+			{
+				mask[nodes[i] / word_bits] |= 1ul << (nodes[i] % word_bits);
+			}
+			return ::syscall(SYS_mbind, address, bytes, policy, mask, max_numa_nodes + 1, mpol_mf_move) == 0;
+#else
+			(void)address;
+			(void)bytes;
+			(void)policy;
+			(void)node_indices;
+			return false;
+#endif
+		}
+
+		bool fake;
+		::std::vector<uint32_t> nodes;
+		::std::vector<::std::vector<uint32_t>> node_cpus;
+		::std::vector<uint32_t> cpu_node;
+	};
+
+	template <size_t HashSize, int (*HashFunction)(uint8_t *, size_t, uint8_t const * in, size_t)>
+	struct sha3_base
+	{
+		using deserialized_hash_t = ::std::vector<node>;
+		using size_type = ::std::size_t;
+
+		static constexpr size_type hash_size = HashSize;
+		static constexpr size_type data_size = HashSize / sizeof(node);
+		deserialized_hash_t data;
+
+		sha3_base(sha3_base const &) = default;
+		sha3_base(sha3_base &&) = default;
+		sha3_base & operator=(sha3_base const &) = default;
+		sha3_base & operator=(sha3_base &&) = default;
+		~sha3_base() = default;
+
+		sha3_base()
+		:data(data_size)
+		{
+
+		}
+
+		sha3_base(::std::string const & input)
+		:sha3_base()
+		{
+			compute_hash(input.c_str(), input.size());
+		}
+
+		sha3_base(void const * input, size_type const input_size)
+		:sha3_base()
+		{
+			compute_hash(input, input_size);
+		}
+
+		inline void compute_hash(void const * input, size_type const input_size)
+		{
+			if (HashFunction(reinterpret_cast<uint8_t*>(data.data()), hash_size, reinterpret_cast<uint8_t const *>(input), input_size) != 0)
+			{
+				throw hash_exception("Unable to compute hash"); // TODO: better message?
+			}
+		}
+
+		inline deserialized_hash_t deserialize() const
+		{
+			return data;
+		}
+
+		inline static ::std::string serialize(deserialized_hash_t const & h)
+		{
+			return std::string(reinterpret_cast<const char*>(h.data()), h.size() * sizeof(node));
+		}
+
+		operator ::std::string() const
+		{
+			// TODO: fast hex conversion
+			::std::stringstream ss;
+			ss << ::std::hex;
+			uint8_t const * iEnd = reinterpret_cast<uint8_t const *>(&data.back());
+			for (uint8_t const * i = reinterpret_cast<uint8_t const *>(data.data()); i != iEnd; i++)
+			{
+				ss << ::std::setw(2) << ::std::setfill('0') << static_cast<uint16_t>(*i);
+			}
+			return ss.str();
+		}
+	};
+
+	struct sha3_256_t : public sha3_base<32, ::sha3_256>
+	{
+		sha3_256_t(::std::string const & input)
+		: sha3_base(input)
+		{
+
+		}
+
+		sha3_256_t(void const * input, size_type const input_size)
+		: sha3_base(input, input_size)
+		{
+
+		}
+	};
+
+	struct sha3_512_t : public sha3_base<64, ::sha3_512>
+	{
+		sha3_512_t(::std::string const & input)
+		: sha3_base(input)
+		{
+
+		}
+
+		sha3_512_t(void const * input, size_type const input_size)
+		: sha3_base(input, input_size)
+		{
+
+		}
+	};
+
+	// TODO: unit tests / validation
+	template <typename HashType>
+	typename HashType::deserialized_hash_t hash_words(::std::string const & data)
+	{
+		return HashType(data).data;
+	}
+
+	template <typename HashType, typename DataType>
+	typename HashType::deserialized_hash_t hash_words(DataType * data_ptr, typename HashType::size_type data_size)
+	{
+		return HashType(data_ptr, data_size).data;
+	}
+
+	// TODO: unit tests / validation
+	template <typename HashType>
+	typename HashType::deserialized_hash_t hash_words(typename HashType::deserialized_hash_t const & deserialized)
+	{
+		auto const serialized = HashType::serialize(deserialized);
+		return hash_words<HashType>(serialized);
+	}
+
+	// hashes are computed over the header hash followed by the nonce in host byte order
+	using header_nonce_bytes = uint8_t[sizeof(h256_t::b) + sizeof(uint64_t)];
+
+	inline void combine_header_nonce(h256_t const & header_hash, uint64_t const nonce, header_nonce_bytes & bytes)
+	{
+		::std::memcpy(bytes, header_hash.b, sizeof(header_hash.b));
+		::std::memcpy(bytes + sizeof(header_hash.b), &nonce, sizeof(nonce));
+	}
+
+	template <typename HashFunc, typename DatasetType>
+	result_t hash_header_nonce(HashFunc hashfunc, DatasetType const & dataset, h256_t const & header_hash, uint64_t const nonce)
+	{
+		header_nonce_bytes bytes;
+		combine_header_nonce(header_hash, nonce, bytes);
+		return hashfunc(dataset, bytes, sizeof(bytes));
+	}
+
+	// full hashes of complete DAGs, which paced DAG generation watches for signs that it is starving hashing of memory bandwidth
+	::std::atomic<uint64_t> & get_foreground_hashes()
+	{
+		static ::std::atomic<uint64_t> hashes(0);
+		return hashes;
+	}
+
+	// hashes are added to the shared count in blocks, so threads hashing at once don't contend for it
+	inline void count_foreground_hashes(uint64_t count)
+	{
+		static constexpr uint64_t block = 64;
+		static thread_local uint64_t pending = 0;
+		pending += count;
+		if (pending >= block)
+		{
+			get_foreground_hashes().fetch_add(pending, ::std::memory_order_relaxed);
+			pending = 0;
+		}
+	}
+
+	// paces DAG generation, sleeping after each slice of items for as long as the throttle_policy_t requires
+	class generation_throttle_t
+	{
+	public:
+		using clock = ::std::chrono::steady_clock;
+
+		// each item reads its parents from the cache and writes itself to the DAG
+		static constexpr double bytes_per_item = static_cast<double>((constants::DATASET_PARENTS + 1) * constants::HASH_BYTES);
+
+		// the slices generated flat out to measure the rate for throttle_bandwidth_fraction
+		static constexpr uint32_t calibration_slices = 8;
+
+		// the lowest fraction of its target that generation backs off to, so it always finishes
+		static constexpr double min_scale = 1.0 / 16.0;
+
+		// how long the peak hash rate takes to decay to half, so generation stops comparing against a load which has gone
+		static constexpr double peak_half_life = 30.0;
+
+		// the longest pause between checks for cancellation
+		static constexpr ::std::chrono::milliseconds max_sleep = ::std::chrono::milliseconds(10);
+
+		generation_throttle_t(throttle_policy_t const & policy, cancel_token_t const & token)
+		: policy(policy)
+		, token(token)
+		, mutex()
+		, started(false)
+		, stopped(false)
+		, start()
+		, stop()
+		, slice_start()
+		, items(0)
+		, work_seconds(0)
+		, calibration_left(calibration_slices)
+		, calibration_items(0)
+		, calibration_seconds(0)
+		, flat_out_rate(0)
+		, scale(1)
+		, target(0)
+		, hashes(0)
+		, hashes_time()
+		, hash_rate(0)
+		, peak_hash_rate(0)
+		{
+		}
+
+		void begin()
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			started = true;
+			start = slice_start = hashes_time = clock::now();
+			hashes = get_foreground_hashes().load(::std::memory_order_relaxed);
+		}
+
+		// called after each slice with the number of items generated so far, returns early if cancelled
+		void pace(uint32_t total_items)
+		{
+			using namespace std;
+
+			auto const now = clock::now();
+			double const work = seconds(now - slice_start);
+			uint32_t const slice_items = total_items - items;
+			double const rate = (work > 0) ? (slice_items / work) : 0;
+
+			double base = 0;
+			switch (policy.mode)
+			{
+				case throttle_items_per_second:
+					base = policy.items_per_second;
+					break;
+				case throttle_bandwidth_fraction:
+					if (calibration_left != 0)
+					{
+						calibration_left--;
+						calibration_items += slice_items;
+						calibration_seconds += work;
+						flat_out_rate = (calibration_seconds > 0) ? (calibration_items / calibration_seconds) : 0;
+					}
+					else
+					{
+						base = policy.bandwidth_fraction * flat_out_rate;
+					}
+					break;
+				case throttle_none:
+				default:
+					break;
+			}
+
+			if (policy.foreground_tolerance > 0)
+			{
+				adapt(now);
+			}
+
+			// without a target of its own, backing off is relative to how fast generation runs flat out
+			double const limit = (base > 0) ? (base * scale) : ((scale < 1) ? (rate * scale) : 0);
+			if (limit > 0)
+			{
+				// the slice should have taken slice_items / limit seconds, so sleep out the rest of that
+				auto const resume = slice_start + chrono::duration_cast<clock::duration>(chrono::duration<double>(slice_items / limit));
+				for (auto t = clock::now(); (t < resume) && !token.is_cancelled(); t = clock::now())
+				{
+					this_thread::sleep_for((min)(resume - t, chrono::duration_cast<clock::duration>(max_sleep)));
+				}
+			}
+
+			lock_guard<std::mutex> lock(mutex);
+			items = total_items;
+			work_seconds += work;
+			target = limit;
+			slice_start = clock::now();
+		}
+
+		// stops the clock once every item is generated
+		void end(uint32_t total_items)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			stop = clock::now();
+			stopped = true;
+			work_seconds += seconds(stop - slice_start);
+			items = total_items;
+			target = 0;
+		}
+
+		throttle_stats_t stats() const
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			throttle_stats_t ret = { 0, 0, 0, 0 };
+			double const elapsed = started ? seconds((stopped ? stop : clock::now()) - start) : 0;
+			if (elapsed > 0)
+			{
+				ret.duty_cycle = (::std::min)(1.0, work_seconds / elapsed);
+				ret.items_per_second = items / elapsed;
+				ret.bytes_per_second = ret.items_per_second * bytes_per_item;
+				ret.target_items_per_second = target;
+			}
+			return ret;
+		}
+
+	private:
+		template <typename Duration>
+		static double seconds(Duration const & d)
+		{
+			return ::std::chrono::duration_cast<::std::chrono::duration<double>>(d).count();
+		}
+
+		// halves the rate while the hash rate is down on its recent peak, and recovers gradually otherwise
+		void adapt(clock::time_point const & now)
+		{
+			double const elapsed = seconds(now - hashes_time);
+			if (elapsed <= 0)
+			{
+				return;
+			}
+			uint64_t const count = get_foreground_hashes().load(::std::memory_order_relaxed);
+			double const rate = (count - hashes) / elapsed;
+			hashes = count;
+			hashes_time = now;
+
+			hash_rate = (hash_rate > 0) ? ((0.75 * hash_rate) + (0.25 * rate)) : rate;
+			peak_hash_rate = (::std::max)(hash_rate, peak_hash_rate * ::std::pow(0.5, elapsed / peak_half_life));
+			if ((peak_hash_rate > 0) && (hash_rate < (peak_hash_rate * (1.0 - policy.foreground_tolerance))))
+			{
+				scale = (::std::max)(min_scale, scale / 2);
+			}
+			else
+			{
+				scale = (::std::min)(1.0, scale + min_scale);
+			}
+		}
+
+		throttle_policy_t const policy;
+		cancel_token_t const token;
+		mutable ::std::mutex mutex;
+		bool started;
+		bool stopped;
+		clock::time_point start;
+		clock::time_point stop;
+		clock::time_point slice_start;
+		uint32_t items;
+		double work_seconds;
+		uint32_t calibration_left;
+		double calibration_items;
+		double calibration_seconds;
+		double flat_out_rate;
+		double scale;
+		double target;
+		uint64_t hashes;
+		clock::time_point hashes_time;
+		double hash_rate;
+		double peak_hash_rate;
+	};
+
+	constexpr double generation_throttle_t::bytes_per_item;
+	constexpr uint32_t generation_throttle_t::calibration_slices;
+	constexpr double generation_throttle_t::min_scale;
+	constexpr double generation_throttle_t::peak_half_life;
+	constexpr ::std::chrono::milliseconds generation_throttle_t::max_sleep;
+
+	// memoizes hash results by epoch, header hash and nonce, in shards which each evict their least recently used result
+	class result_cache_t
+	{
+	public:
+		// the capacity is dealt out between the shards, so together they hold exactly that many results
+		explicit result_cache_t(size_t capacity)
+		: shard_count((::std::max)(static_cast<size_t>(1), (::std::min)(max_shard_count, capacity)))
+		, shards(new shard_t[shard_count])
+		, capacity(capacity)
+		, hits(0)
+		, misses(0)
+		{
+			for (size_t i = 0; i < shard_count; i++)
+			{
+				shards[i].capacity = (capacity / shard_count) + ((i < (capacity % shard_count)) ? 1 : 0);
+			}
+		}
+
+		bool lookup(uint64_t epoch, h256_t const & header_hash, uint64_t nonce, result_t & result)
+		{
+			key_t const key = { epoch, header_hash, nonce };
+			size_t const hash = key_hash_t()(key);
+			shard_t & shard = shards[hash % shard_count];
+			{
+				::std::lock_guard<::std::mutex> lock(shard.mutex);
+				auto const i = shard.index.find(key);
+				if (i != shard.index.end())
+				{
+					shard.entries.splice(shard.entries.begin(), shard.entries, i->second);
+					result = i->second->second;
+					hits.fetch_add(1, ::std::memory_order_relaxed);
+					return true;
+				}
+			}
+			misses.fetch_add(1, ::std::memory_order_relaxed);
+			return false;
+		}
+
+		void store(uint64_t epoch, h256_t const & header_hash, uint64_t nonce, result_t const & result)
+		{
+			key_t const key = { epoch, header_hash, nonce };
+			size_t const hash = key_hash_t()(key);
+			shard_t & shard = shards[hash % shard_count];
+			::std::lock_guard<::std::mutex> lock(shard.mutex);
+			if (shard.index.find(key) != shard.index.end())
+			{
+				// another thread computed the same hash meanwhile
+				return;
+			}
+			shard.entries.emplace_front(key, result);
+			shard.index.insert(::std::make_pair(key, shard.entries.begin()));
+			if (shard.entries.size() > shard.capacity)
+			{
+				shard.index.erase(shard.entries.back().first);
+				shard.entries.pop_back();
+			}
+		}
+
+		result_cache_stats_t stats() const
+		{
+			result_cache_stats_t ret = { hits.load(::std::memory_order_relaxed), misses.load(::std::memory_order_relaxed), 0, capacity };
+			for (size_t i = 0; i < shard_count; i++)
+			{
+				::std::lock_guard<::std::mutex> lock(shards[i].mutex);
+				ret.size += shards[i].entries.size();
+			}
+			return ret;
+		}
+
+	private:
+		static constexpr size_t max_shard_count = 16;
+
+		struct key_t
+		{
+			uint64_t epoch;
+			h256_t header_hash;
+			uint64_t nonce;
+
+			bool operator==(key_t const & rhs) const
+			{
+				return (epoch == rhs.epoch) && (nonce == rhs.nonce) && (header_hash == rhs.header_hash);
+			}
+		};
+
+		struct key_hash_t
+		{
+			size_t operator()(key_t const & key) const noexcept
+			{
+				// nonces of the same header are often consecutive, so they are spread by a multiplicative hash
+				uint64_t const mixed = (key.nonce ^ (key.epoch << 48)) * 0x9e3779b97f4a7c15ull;
+				return ::std::hash<h256_t>()(key.header_hash) ^ static_cast<size_t>(mixed ^ (mixed >> 32));
+			}
+		};
+
+		using entry_list = ::std::list<::std::pair<key_t, result_t>>;
+
+		struct shard_t
+		{
+			mutable ::std::mutex mutex;
+			entry_list entries;
+			::std::unordered_map<key_t, entry_list::iterator, key_hash_t> index;
+			size_t capacity;
+		};
+
+		size_t const shard_count;
+		::std::unique_ptr<shard_t[]> shards;
+		size_t const capacity;
+		::std::atomic<uint64_t> hits;
+		::std::atomic<uint64_t> misses;
+	};
+
+	constexpr size_t result_cache_t::max_shard_count;
+
+	::std::shared_ptr<result_cache_t> & get_result_cache()
+	{
+		static ::std::shared_ptr<result_cache_t> results;
+		return results;
+	}
+
+	// computes a hash through the result cache when it is enabled
+	template <typename HashFunc>
+	result_t cached_hash(uint64_t epoch, h256_t const & header_hash, uint64_t nonce, HashFunc hash)
+	{
+		auto const results = ::std::atomic_load(&get_result_cache());
+		if (!results)
+		{
+			return hash();
+		}
+		result_t ret;
+		if (!results->lookup(epoch, header_hash, nonce, ret))
+		{
+			ret = hash();
+			results->store(epoch, header_hash, nonce, ret);
+		}
+		return ret;
+	}
+
+	// hint that the bytes [begin, begin + size) will soon be read
+	inline void prefetch(void const * begin, size_t size)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		uintptr_t const end = reinterpret_cast<uintptr_t>(begin) + size;
+		for (uintptr_t line = reinterpret_cast<uintptr_t>(begin) & ~uintptr_t(63); line < end; line += 64)
+		{
+			__builtin_prefetch(reinterpret_cast<void const *>(line));
+		}
+#else
+		(void)begin;
+		(void)size;
+#endif
+	}
+}
+
+namespace egihash
+{
+	constexpr h256_t::size_type h256_t::hash_size;
+
+	h256_t::h256_t(void const * input_data, size_type input_size)
+	: b{0}
+	{
+		if (::sha3_256(b, hash_size, reinterpret_cast<uint8_t const *>(input_data), input_size) != 0)
+		{
+			throw hash_exception("Keccak-256 computation failed.");
+		}
+	}
+
+	::std::string h256_t::to_hex() const
+	{
+		// TODO: fast hex conversion
+		::std::stringstream ss;
+		ss << ::std::hex << ::std::nouppercase;
+		uint8_t const * iEnd = reinterpret_cast<uint8_t const *>(&b[hash_size]);
+		for (uint8_t const * i = reinterpret_cast<uint8_t const *>(&b[0]); i != iEnd; i++)
+		{
+			ss << ::std::setw(2) << ::std::setfill('0') << static_cast<uint16_t>(*i);
+		}
+		return ss.str();
+	}
+
+	h256_t::operator bool() const
+	{
+		return (::std::memcmp(&b[0], &empty_h256.b[0], sizeof(b)) != 0);
+	}
+
+	bool h256_t::operator==(h256_t const & rhs) const
+	{
+		return (::std::memcmp(&b[0], &rhs.b[0], sizeof(b)) == 0);
+	}
+
+	constexpr h512_t::size_type h512_t::hash_size;
+
+	h512_t::h512_t(void const * input_data, size_type input_size)
+	: b{0}
+	{
+		if (::sha3_512(b, hash_size, reinterpret_cast<uint8_t const *>(input_data), input_size) != 0)
+		{
+			throw hash_exception("Keccak-512 computation failed.");
+		}
+	}
 
 	::std::string h512_t::to_hex() const
 	{
-		// TODO: fast hex conversion
-		::std::stringstream ss;
-		ss << ::std::hex << ::std::nouppercase;
-		uint8_t const * iEnd = reinterpret_cast<uint8_t const *>(&b[hash_size]);
-		for (uint8_t const * i = reinterpret_cast<uint8_t const *>(&b[0]); i != iEnd; i++)
+		// TODO: fast hex conversion
+		::std::stringstream ss;
+		ss << ::std::hex << ::std::nouppercase;
+		uint8_t const * iEnd = reinterpret_cast<uint8_t const *>(&b[hash_size]);
+		for (uint8_t const * i = reinterpret_cast<uint8_t const *>(&b[0]); i != iEnd; i++)
+		{
+			ss << ::std::setw(2) << ::std::setfill('0') << static_cast<uint16_t>(*i);
+		}
+		return ss.str();
+	}
+
+	h512_t::operator bool() const
+	{
+		return (::std::memcmp(&b[0], &empty_h512.b[0], sizeof(b)) != 0);
+	}
+
+	bool h512_t::operator==(h512_t const & rhs) const
+	{
+		return (::std::memcmp(&b[0], &rhs.b[0], sizeof(b)) == 0);
+	}
+
+	result_t::operator bool() const
+	{
+		return bool(value) && bool(mixhash);
+	}
+
+	bool result_t::operator==(result_t const & rhs) const
+	{
+		return ((value == rhs.value) && (mixhash == rhs.mixhash));
+	}
+
+	// TODO: unit tests / validation
+	template <typename T>
+	sha3_512_t::deserialized_hash_t sha3_512(T const & data)
+	{
+		return hash_words<sha3_512_t>(data);
+	}
+
+	template <typename DataPtr>
+	sha3_512_t::deserialized_hash_t sha3_512(DataPtr const * data, sha3_512_t::size_type data_size)
+	{
+		return hash_words<sha3_512_t>(data, data_size);
+	}
+
+	// TODO: unit tests / validation
+	template <typename T>
+	sha3_256_t::deserialized_hash_t sha3_256(T const & data)
+	{
+		return hash_words<sha3_256_t>(data);
+	}
+
+	template <typename DataPtr>
+	sha3_256_t::deserialized_hash_t sha3_256(DataPtr const * data, sha3_256_t::size_type data_size)
+	{
+		return hash_words<sha3_256_t>(data, data_size);
+	}
+
+	// TODO: unit tests / validation
+	template <typename T>
+	::std::string serialize_cache(T const & cache_data)
+	{
+		::std::string ret;
+		for (auto const & i : cache_data)
+		{
+			ret += serialize_hash(cache_data);
+		}
+		return ret;
+	}
+
+	// TODO: unit tests / validation
+	template <typename T>
+	::std::string serialize_dataset(T const & dataset)
+	{
+		return serialize_cache(dataset);
+	}
+
+	// direct mapped cache of computed DAG items, each slot guarded by a sequence lock so lookups never block
+	class item_cache_t
+	{
+	public:
+		explicit item_cache_t(size_t slot_count)
+		: slots(new slot_t[slot_count])
+		, mask(slot_count - 1)
+		, hits(0)
+		, misses(0)
+		{
+			for (size_t i = 0; i < slot_count; i++)
+			{
+				slots[i].sequence.store(0, ::std::memory_order_relaxed);
+				slots[i].index.store(empty_index, ::std::memory_order_relaxed);
+			}
+		}
+
+		// the number of slots which fit in a budget of megabytes, rounded down to a power of 2
+		static size_t slots_for(size_t megabytes)
+		{
+			size_t const budget = (megabytes * 1024 * 1024) / sizeof(slot_t);
+			size_t slot_count = 1;
+			while ((slot_count * 2) <= budget)
+			{
+				slot_count *= 2;
+			}
+			return (budget == 0) ? 0 : slot_count;
+		}
+
+		bool lookup(uint32_t index, node * out)
+		{
+			slot_t & slot = slots[index & mask];
+			uint32_t const before = slot.sequence.load(::std::memory_order_acquire);
+			if (((before & 1) == 0) && (slot.index.load(::std::memory_order_relaxed) == index))
+			{
+				for (uint32_t k = 0; k < constants::HASH_WORDS; k++)
+				{
+					out[k].hword = slot.words[k].load(::std::memory_order_relaxed);
+				}
+				::std::atomic_thread_fence(::std::memory_order_acquire);
+				if (slot.sequence.load(::std::memory_order_relaxed) == before)
+				{
+					hits.fetch_add(1, ::std::memory_order_relaxed);
+					return true;
+				}
+			}
+			misses.fetch_add(1, ::std::memory_order_relaxed);
+			return false;
+		}
+
+		// a slot being written by another thread is left alone rather than waited for
+		void store(uint32_t index, node const * item)
+		{
+			slot_t & slot = slots[index & mask];
+			uint32_t sequence = slot.sequence.load(::std::memory_order_relaxed);
+			if (((sequence & 1) != 0) || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, ::std::memory_order_relaxed))
+			{
+				return;
+			}
+			::std::atomic_thread_fence(::std::memory_order_release);
+			slot.index.store(index, ::std::memory_order_relaxed);
+			for (uint32_t k = 0; k < constants::HASH_WORDS; k++)
+			{
+				slot.words[k].store(item[k].hword, ::std::memory_order_relaxed);
+			}
+			slot.sequence.store(sequence + 2, ::std::memory_order_release);
+		}
+
+		cache_t::item_cache_stats_t stats() const
+		{
+			cache_t::item_cache_stats_t ret;
+			ret.hits = hits.load(::std::memory_order_relaxed);
+			ret.misses = misses.load(::std::memory_order_relaxed);
+			ret.capacity = mask + 1;
+			return ret;
+		}
+
+	private:
+		static constexpr uint32_t empty_index = ::std::numeric_limits<uint32_t>::max();
+
+		struct slot_t
+		{
+			::std::atomic<uint32_t> sequence;
+			::std::atomic<uint32_t> index;
+			::std::atomic<uint32_t> words[constants::HASH_WORDS];
+		};
+
+		::std::unique_ptr<slot_t[]> slots;
+		size_t const mask;
+		::std::atomic<uint64_t> hits;
+		::std::atomic<uint64_t> misses;
+	};
+
+	// seedhashes of epochs computed so far, the seedhash of each epoch is the keccak-256 of the seedhash of the one before
+	class seedhash_table_t
+	{
+	public:
+		h256_t get(uint64_t epoch)
+		{
+			h256_t ret;
+			uint64_t last = 0;
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				extend((std::min)(epoch + 1, max_epochs));
+				if (epoch < seedhashes.size())
+				{
+					return seedhashes[epoch];
+				}
+				ret = seedhashes.back();
+				last = seedhashes.size() - 1;
+			}
+
+			// epochs this far out are not remembered, they are hashed on from the last one which is without holding the lock
+			for (uint64_t i = last; i < epoch; i++)
+			{
+				ret = h256_t(&ret.b[0], ret.hash_size);
+			}
+			return ret;
+		}
+
+		bool find(h256_t const & seedhash, uint64_t & epoch)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			extend(1);
+			auto i = epochs.find(seedhash);
+			while ((i == epochs.end()) && (seedhashes.size() < constants::SEEDHASH_SEARCH_EPOCHS))
+			{
+				extend(seedhashes.size() + 1);
+				if (seedhashes.back() == seedhash)
+				{
+					i = epochs.find(seedhash);
+				}
+			}
+			if (i == epochs.end())
+			{
+				return false;
+			}
+			epoch = i->second;
+			return true;
+		}
+
+		void precompute(uint64_t epoch_count)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			extend((std::min)(epoch_count, max_epochs));
+		}
+
+	private:
+		// at most this many seedhashes are remembered, 2 MiB worth
+		static constexpr uint64_t max_epochs = 1u << 16;
+
+		struct less_t
+		{
+			bool operator()(h256_t const & lhs, h256_t const & rhs) const
+			{
+				return ::std::memcmp(&lhs.b[0], &rhs.b[0], lhs.hash_size) < 0;
+			}
+		};
+
+		void extend(uint64_t count)
+		{
+			if (seedhashes.empty())
+			{
+				h256_t seedhash;
+				::std::memcpy(&seedhash.b[0], epoch0_seedhash, size_epoch0_seedhash);
+				append(seedhash);
+			}
+			while (seedhashes.size() < count)
+			{
+				h256_t const & previous = seedhashes.back();
+				append(h256_t(&previous.b[0], previous.hash_size));
+			}
+		}
+
+		void append(h256_t const & seedhash)
+		{
+			epochs.insert(::std::make_pair(seedhash, static_cast<uint64_t>(seedhashes.size())));
+			seedhashes.push_back(seedhash);
+		}
+
+		::std::mutex mutex;
+		::std::vector<h256_t> seedhashes;
+		::std::map<h256_t, uint64_t, less_t> epochs;
+	};
+
+	constexpr uint64_t seedhash_table_t::max_epochs;
+
+	// construct on first use ensures safe static initialization order
+	seedhash_table_t & get_seedhash_table()
+	{
+		static seedhash_table_t table;
+		return table;
+	}
+
+	struct cache_t::impl_t
+	{
+		using size_type = cache_t::size_type;
+		using data_type = item_storage_t;
+		using cache_cache_map = ::std::map<uint64_t /* epoch */, ::std::shared_ptr<impl_t>>;
+
+		impl_t(uint64_t const block_number, progress_callback_type callback)
+		: epoch(block_number / constants::EPOCH_LENGTH)
+		, seedhash(get_seedhash(block_number))
+		, size(get_cache_size(block_number))
+		, data()
+		, full_size(dag_t::get_full_size(block_number))
+		, item_divisor(static_cast<uint32_t>(size / constants::HASH_BYTES))
+		, page_divisor(static_cast<uint32_t>(full_size / constants::MIX_BYTES))
+		, last_used(0)
+		{
+			mkcache(callback);
+		}
+
+		impl_t(uint64_t epoch, uint64_t size, source_t & source, progress_callback_type callback)
+		: epoch(epoch)
+		, seedhash(get_seedhash((epoch * constants::EPOCH_LENGTH) + 1))
+		, size(size)
+		, data()
+		, full_size(dag_t::get_full_size(epoch * constants::EPOCH_LENGTH))
+		, item_divisor(static_cast<uint32_t>(size / constants::HASH_BYTES))
+		, page_divisor(static_cast<uint32_t>(full_size / constants::MIX_BYTES))
+		, last_used(0)
+		{
+			load(source, callback);
+		}
+
+		void mkcache(progress_callback_type callback)
+		{
+			uint32_t n = item_divisor.value();
+
+			data.allocate(static_cast<size_t>(n) * constants::HASH_WORDS, cache_t::get_page_mode(), cache_t::get_allocator());
+			lock_items(data, cache_t::get_lock_mode());
+			sha3_512_item(item(0), &seedhash.b[0], seedhash.hash_size);
+			for (uint32_t i = 1; i < n; i++)
+			{
+				sha3_512_item(item(i), item(i - 1), constants::HASH_BYTES);
+				if (((i % constants::CALLBACK_FREQUENCY) == 0) && !callback(i, n, cache_seeding))
+				{
+					throw hash_exception("Cache creation cancelled.");
+				}
+			}
+
+			uint32_t progress_counter = 0;
+			for (uint32_t i = 0; i < constants::CACHE_ROUNDS; i++)
+			{
+				for (uint32_t j = 0; j < n; j++)
+				{
+					auto v = item_divisor.mod(item(j)[0].hword);
+					node u[constants::HASH_WORDS];
+					::std::memcpy(u, item(item_divisor.mod(n - 1 + j)), constants::HASH_BYTES);
+					for (uint32_t k = 0; k < constants::HASH_WORDS; k++)
+					{
+						u[k].hword = u[k].hword ^ item(v)[k].hword;
+					}
+					sha3_512_item(item(j), u, constants::HASH_BYTES);
+
+					if (((++progress_counter % constants::CALLBACK_FREQUENCY) == 0) && !callback(progress_counter, n * constants::CACHE_ROUNDS, cache_generation))
+					{
+						throw hash_exception("Cache creation cancelled.");
+					}
+				}
+			}
+		}
+
+		void load(source_t & source, progress_callback_type callback)
+		{
+			size_type const cache_hash_count = size / constants::HASH_BYTES;
+			page_mode const mode = cache_t::get_page_mode();
+			::std::shared_ptr<allocator_t> const allocator = cache_t::get_allocator();
+
+			bool const viewed = view_items(source, data, cache_hash_count, mode, allocator, callback, cache_loading, "Cache loading cancelled.");
+			if (!viewed)
+			{
+				data.allocate(cache_hash_count * constants::HASH_WORDS, mode, allocator);
+			}
+			lock_items(data, cache_t::get_lock_mode());
+			if (!viewed)
+			{
+				read_items(source, data.data(), cache_hash_count, callback, cache_loading, "Cache loading cancelled.");
+			}
+		}
+
+		void save(sink_t & sink, progress_callback_type callback) const
+		{
+			cache_file_header_t const header(epoch, size, compute_checksum(), seedhash);
+			sink.write(&header, sizeof(header));
+
+			size_t count = 0;
+			write_items(sink, data.data(), item_count(), count, item_count(), callback, cache_saving, "Cache save cancelled.");
+			sink.flush();
+		}
+
+		uint64_t compute_checksum() const
+		{
+			return checksum_words(checksum_seed, data.data(), data.data() + data.size());
+		}
+
+		node * item(uint32_t index)
+		{
+			return &data[static_cast<size_t>(index) * constants::HASH_WORDS];
+		}
+
+		size_t item_count() const
+		{
+			return data.size() / constants::HASH_WORDS;
+		}
+
+		data_view_t view() const
+		{
+			return data_view_t(data.data(), item_count());
+		}
+
+		static size_type get_cache_size(uint64_t block_number) noexcept
+		{
+			using namespace constants;
+
+			uint64_t const epoch = block_number / EPOCH_LENGTH;
+			if (epoch < EPOCH_SIZE_TABLE_LENGTH)
+			{
+				return static_cast<size_type>(cache_sizes[epoch]);
+			}
+
+			size_type cache_size = (CACHE_BYTES_INIT + (CACHE_BYTES_GROWTH * (block_number / EPOCH_LENGTH))) - HASH_BYTES;
+			while (!is_prime(cache_size / HASH_BYTES))
+			{
+				cache_size -= (2 * HASH_BYTES);
+			}
+			return cache_size;
+		}
+
+		static h256_t get_seedhash(uint64_t const block_number)
+		{
+			return get_seedhash_table().get(block_number / constants::EPOCH_LENGTH);
+		}
+
+		// computes DAG item index into out, through the item cache when it is enabled
+		void dataset_item(item_cache_t * items, uint32_t index, node * out) const;
+
+		::std::shared_ptr<item_cache_t> get_item_cache() const
+		{
+			return ::std::atomic_load(&item_cache);
+		}
+
+		uint64_t epoch;
+		h256_t seedhash;
+		size_type size;
+		data_type data;
+		::std::shared_ptr<item_cache_t> item_cache;
+		size_type const full_size; // the size of the DAG of this epoch
+		fast_divisor_t const item_divisor; // the number of items in the cache
+		fast_divisor_t const page_divisor; // the number of pages in the DAG of this epoch
+		uint64_t last_used; // when the cache cache last handed out this cache, guarded by the cache cache mutex
+	};
+
+	// construct on first use mutex ensures safe static initialization order
+	std::recursive_mutex & get_cache_cache_mutex()
+	{
+		static std::recursive_mutex mutex;
+		return mutex;
+	}
+	// ensures single threaded construction
+	std::recursive_mutex & cache_cache_mutex = get_cache_cache_mutex();
+
+	// construct on first use dag_cache_map ensures safe static initialization order
+	cache_t::impl_t::cache_cache_map & get_cache_cache()
+	{
+		std::lock_guard<std::recursive_mutex> lock(get_cache_cache_mutex());
+		static cache_t::impl_t::cache_cache_map cache_cache;
+		return cache_cache;
+	}
+	// ensures single threaded construction
+	cache_t::impl_t::cache_cache_map & cache_cache = get_cache_cache();
+
+	void cache_t::unload() const
+	{
+		get_cache_cache().erase(epoch());
+	}
+
+	// the following are guarded by the cache cache mutex
+	cache_t::size_type & get_cache_budget()
+	{
+		static cache_t::size_type budget = 0;
+		return budget;
+	}
+
+	// marks a cache as the most recently used
+	void touch_cache(cache_t::impl_t & impl)
+	{
+		static uint64_t clock = 0;
+		impl.last_used = ++clock;
+	}
+
+	cache_t::size_type cache_cache_bytes()
+	{
+		cache_t::size_type total = 0;
+		for (auto const & i : get_cache_cache())
+		{
+			total += i.second->size;
+		}
+		return total;
+	}
+
+	// unloads the least recently used caches other than the cache of keep_epoch until the cache cache is within budget
+	void trim_cache_cache(uint64_t keep_epoch)
+	{
+		auto & caches = get_cache_cache();
+		cache_t::size_type const budget = get_cache_budget();
+		cache_t::size_type total = cache_cache_bytes();
+		while ((budget != 0) && (total > budget))
+		{
+			auto victim = caches.end();
+			for (auto i = caches.begin(); i != caches.end(); ++i)
+			{
+				if ((i->first != keep_epoch) && ((victim == caches.end()) || (i->second->last_used < victim->second->last_used)))
+				{
+					victim = i;
+				}
+			}
+			if (victim == caches.end())
+			{
+				break;
+			}
+			total -= victim->second->size;
+			caches.erase(victim);
+		}
+	}
+
+	// adds a cache to the cache cache, returning the cache which is registered for that epoch
+	::std::shared_ptr<cache_t::impl_t> add_to_cache_cache(::std::shared_ptr<cache_t::impl_t> impl)
+	{
+		using namespace std;
+
+		lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+		auto insert_pair = get_cache_cache().insert(make_pair(impl->epoch, impl));
+
+		// if insert succeded, return the cache
+		if (insert_pair.second)
+		{
+			touch_cache(*impl);
+			trim_cache_cache(impl->epoch);
+			return insert_pair.first->second;
+		}
+
+		// if insert failed, it's probably already been inserted
+		auto const cache_cache_iterator = get_cache_cache().find(impl->epoch);
+		if (cache_cache_iterator != get_cache_cache().end())
+		{
+			touch_cache(*cache_cache_iterator->second);
+			return cache_cache_iterator->second;
+		}
+
+		// we couldn't insert it and it's not in the cache
+		throw hash_exception("Could not get cache");
+	}
+
+	::std::shared_ptr<cache_t::impl_t> get_cache_from_cache(uint64_t const block_number, progress_callback_type callback)
+	{
+		using namespace std;
+		uint64_t epoch_number = block_number / constants::EPOCH_LENGTH;
+
+		// if we have the correct cache already loaded, return it from the cache cache
+		{
+			lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+			auto const cache_cache_iterator = get_cache_cache().find(epoch_number);
+			if (cache_cache_iterator != get_cache_cache().end())
+			{
+				touch_cache(*cache_cache_iterator->second);
+				return cache_cache_iterator->second;
+			}
+		}
+
+		// otherwise create the cache and add it to the cache cache
+		// this is not locked as it can be a lengthy process and we don't want to block access to the cache cache
+		shared_ptr<cache_t::impl_t> impl(new cache_t::impl_t(block_number, callback));
+
+		return add_to_cache_cache(impl);
+	}
+
+	::std::shared_ptr<cache_t::impl_t> get_cache_from_cache(source_t & source, progress_callback_type callback)
+	{
+		using namespace std;
+
+		if (source.remaining() < constants::CACHE_FILE_HEADER_SIZE)
+		{
+			throw hash_exception("Cache is corrupt");
+		}
+
+		cache_file_header_t const header([&source](void * dst, size_t count) { source.read(dst, count); });
+
+		if ((source.remaining() != source_t::unknown_size) && (source.remaining() < header.size))
+		{
+			throw hash_exception("Cache is corrupt");
+		}
+
+		// if we have the correct cache already loaded, return it from the cache cache
+		{
+			lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+			auto const cache_cache_iterator = get_cache_cache().find(header.epoch);
+			if (cache_cache_iterator != get_cache_cache().end())
+			{
+				touch_cache(*cache_cache_iterator->second);
+				return cache_cache_iterator->second;
+			}
+		}
+
+		if (!header.valid_seedhash())
+		{
+			throw hash_exception("Cache seedhash is invalid");
+		}
+
+		// otherwise load the cache and add it to the cache cache
+		// this is not locked as it can be a lengthy process and we don't want to block access to the cache cache
+		shared_ptr<cache_t::impl_t> impl(new cache_t::impl_t(header.epoch, header.size, source, callback));
+
+		if (impl->compute_checksum() != header.checksum)
+		{
+			throw hash_exception("Cache checksum mismatch");
+		}
+
+		return add_to_cache_cache(impl);
+	}
+
+	::std::shared_ptr<cache_t::impl_t> get_cache_from_cache(uint64_t const epoch, uint64_t const size, source_t & source, progress_callback_type callback)
+	{
+		using namespace std;
+
+		// a cache embedded in a DAG file is skipped over if that epoch is already in the cache cache
+		{
+			lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+			auto const cache_cache_iterator = get_cache_cache().find(epoch);
+			if ((cache_cache_iterator != get_cache_cache().end()) && (cache_cache_iterator->second->size == size))
+			{
+				source.skip(size);
+				touch_cache(*cache_cache_iterator->second);
+				return cache_cache_iterator->second;
+			}
+		}
+
+		// otherwise it is loaded, and added to the cache cache by the DAG loader once the DAG has been verified against it
+		return shared_ptr<cache_t::impl_t>(new cache_t::impl_t(epoch, size, source, callback));
+	}
+
+	::std::shared_ptr<cache_t::impl_t> get_cache_from_cache(::std::string const & file_path, progress_callback_type callback)
+	{
+		// cache files are laid out so they can be mapped and copied straight into the cache
+		mmap_source source(file_path);
+		return get_cache_from_cache(source, callback);
+	}
+
+	cache_t::cache_t(uint64_t const block_number, progress_callback_type callback)
+	: impl(get_cache_from_cache(block_number, callback))
+	{
+	}
+
+	cache_t::cache_t(::std::string const & file_path, progress_callback_type callback)
+	: impl(get_cache_from_cache(file_path, callback))
+	{
+	}
+
+	cache_t::cache_t(source_t & source, progress_callback_type callback)
+	: impl(get_cache_from_cache(source, callback))
+	{
+	}
+
+	cache_t::cache_t(uint64_t epoch, uint64_t size, source_t & source, progress_callback_type callback)
+	: impl(get_cache_from_cache(epoch, size, source, callback))
+	{
+	}
+
+	uint64_t cache_t::epoch() const
+	{
+		return impl->epoch;
+	}
+
+	cache_t::size_type cache_t::size() const
+	{
+		return impl->size;
+	}
+
+	cache_t::size_type cache_t::full_size() const
+	{
+		return impl->full_size;
+	}
+
+	cache_t::data_type cache_t::data() const
+	{
+		return impl->view();
+	}
+
+	h256_t cache_t::seedhash() const
+	{
+		return impl->seedhash;
+	}
+
+	void cache_t::save(::std::string const & file_path, progress_callback_type callback) const
+	{
+		save_file(file_path, [this, &callback](sink_t & sink) { impl->save(sink, callback); });
+	}
+
+	void cache_t::save(sink_t & sink, progress_callback_type callback) const
+	{
+		impl->save(sink, callback);
+	}
+
+	void cache_t::load(source_t & source, progress_callback_type callback)
+	{
+		impl->load(source, callback);
+	}
+
+	cache_t::size_type cache_t::get_cache_size(uint64_t const block_number) noexcept
+	{
+		return impl_t::get_cache_size(block_number);
+	}
+
+	h256_t cache_t::get_seedhash(uint64_t const block_number)
+	{
+		return impl_t::get_seedhash(block_number);
+	}
+
+	uint64_t cache_t::get_epoch(h256_t const & seedhash)
+	{
+		uint64_t epoch = 0;
+		if (!get_seedhash_table().find(seedhash, epoch))
+		{
+			throw hash_exception("Unknown seedhash.");
+		}
+		return epoch;
+	}
+
+	void cache_t::precompute_seedhashes(uint64_t epoch_count)
+	{
+		get_seedhash_table().precompute(epoch_count);
+	}
+
+	::std::vector<uint64_t> cache_t::prepare_range(uint64_t first_epoch, uint64_t last_epoch, unsigned threads, thread_pool_t const & pool)
+	{
+		using namespace std;
+
+		if (last_epoch < first_epoch)
+		{
+			return vector<uint64_t>();
+		}
+
+		// the seedhash chain is walked once for the whole range, rather than by each cache
+		get_seedhash_table().precompute(last_epoch + 1);
+
+		// epochs are claimed in order, and caches only grow, so the first epoch which does not fit ends the range
+		uint64_t const count = last_epoch - first_epoch + 1;
+		std::mutex mutex;
+		uint64_t next = 0;
+		uint64_t end = count;
+		size_type budget = 0;
+		size_type reserved = 0;
+		{
+			lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+			budget = get_cache_budget();
+			reserved = cache_cache_bytes();
+		}
+
+		auto const worker = [&]()
+		{
+			for (;;)
+			{
+				uint64_t epoch = 0;
+				{
+					lock_guard<std::mutex> lock(mutex);
+					if (next >= end)
+					{
+						return;
+					}
+					epoch = first_epoch + next;
+					if (!is_loaded(epoch))
+					{
+						size_type const size = get_cache_size(epoch * constants::EPOCH_LENGTH);
+						if ((budget != 0) && ((reserved + size) > budget))
+						{
+							end = next;
+							return;
+						}
+						reserved += size;
+					}
+					next++;
+				}
+
+				try
+				{
+					get_cache_from_cache(epoch * constants::EPOCH_LENGTH, [](size_type, size_type, int){ return true; });
+				}
+				catch (...)
+				{
+					lock_guard<std::mutex> lock(mutex);
+					end = next;
+					throw;
+				}
+			}
+		};
+
+		size_t const thread_count = static_cast<size_t>((min)(static_cast<uint64_t>((threads != 0) ? threads : pool.size()), count));
+		pool.parallel_for(thread_count, [&worker](size_t) { worker(); });
+
+		vector<uint64_t> prepared;
+		prepared.reserve(static_cast<size_t>(end));
+		for (uint64_t i = 0; i < end; i++)
+		{
+			prepared.push_back(first_epoch + i);
+		}
+		return prepared;
+	}
+
+	void cache_t::set_memory_budget(size_type budget_bytes)
+	{
+		::std::lock_guard<::std::recursive_mutex> lock(get_cache_cache_mutex());
+		get_cache_budget() = budget_bytes;
+		trim_cache_cache(::std::numeric_limits<uint64_t>::max());
+	}
+
+	cache_t::size_type cache_t::get_memory_budget()
+	{
+		::std::lock_guard<::std::recursive_mutex> lock(get_cache_cache_mutex());
+		return get_cache_budget();
+	}
+
+	bool cache_t::is_loaded(uint64_t const epoch)
+	{
+		using namespace std;
+		lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+		auto const & cache_cache = get_cache_cache();
+		return (cache_cache.find(epoch) != cache_cache.end());
+	}
+
+	::std::vector<uint64_t> cache_t::get_loaded()
+	{
+		using namespace std;
+		lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
+		auto const & cache_cache = get_cache_cache();
+		::std::vector<uint64_t> loaded_epochs;
+		loaded_epochs.reserve(cache_cache.size());
+		for (auto const & i : cache_cache)
+		{
+			loaded_epochs.push_back(i.first);
+		}
+		return loaded_epochs;
+	}
+
+	struct dag_t::impl_t
+	{
+		using size_type = dag_t::size_type;
+		using data_type = item_storage_t;
+		using dag_cache_map = ::std::map<uint64_t /* epoch */, ::std::shared_ptr<impl_t>>;
+		static constexpr uint64_t max_epoch = ::std::numeric_limits<uint64_t>::max();
+
+		// tag for constructors which only prepare the cache and room for the items, see generate() and load_items()
+		struct deferred_t {};
+
+		// the items are allocated here unless room for them is passed in
+		impl_t(uint64_t block_number, progress_callback_type callback, deferred_t, item_storage_t && items = item_storage_t())
+		: epoch(block_number / constants::EPOCH_LENGTH)
+		, size(get_full_size(block_number))
+		, cache(block_number, callback)
+		, data(items.empty() ? item_storage_t(node_count(size), dag_t::get_page_mode(), dag_t::get_allocator()) : ::std::move(items))
+		, checksum(0)
+		, has_checksum(false)
+		, ready(0)
+		, page_divisor(static_cast<uint32_t>(size / constants::MIX_BYTES))
+		, numa(dag_t::get_numa_policy())
+		{
+			interleave();
+			lock_items(data, dag_t::get_lock_mode());
+		}
+
+		impl_t(uint64_t block_number, progress_callback_type callback)
+		: impl_t(block_number, callback, deferred_t())
+		{
+			generate(callback);
+		}
+
+		// where the source can lend its memory, the items are viewed in place and are ready straight away
+		impl_t(source_t & source, dag_file_header_t & header, progress_callback_type callback, deferred_t, item_storage_t && items = item_storage_t())
+		: epoch(header.epoch)
+		, size(header.dag_end - header.dag_begin)
+		, cache(header.epoch, header.cache_end - header.cache_begin, source, callback)
+		, data(::std::move(items))
+		, checksum(0)
+		, has_checksum(false)
+		, ready(0)
+		, page_divisor(static_cast<uint32_t>(size / constants::MIX_BYTES))
+		, numa(dag_t::get_numa_policy())
+		{
+			if (data.empty())
+			{
+				size_t const count = static_cast<size_t>(size / constants::HASH_BYTES);
+				page_mode const mode = dag_t::get_page_mode();
+				::std::shared_ptr<allocator_t> const allocator = dag_t::get_allocator();
+				if ((numa.mode == numa_local) && view_items(source, data, count, mode, allocator, callback, dag_loading, "DAG loading cancelled."))
+				{
+					ready.store(static_cast<uint32_t>(count), ::std::memory_order_release);
+				}
+				else
+				{
+					data.allocate(node_count(size), mode, allocator);
+				}
+			}
+			interleave();
+			lock_items(data, dag_t::get_lock_mode());
+		}
+
+		impl_t(source_t & source, dag_file_header_t & header, progress_callback_type callback)
+		: impl_t(source, header, callback, deferred_t())
+		{
+			load_items(source, callback);
+		}
+
+		// the items were computed elsewhere and are taken over without being copied
+		impl_t(uint64_t block_number, item_storage_t && items, progress_callback_type callback)
+		: epoch(block_number / constants::EPOCH_LENGTH)
+		, size(get_full_size(block_number))
+		, cache(block_number, callback)
+		, data(::std::move(items))
+		, checksum(0)
+		, has_checksum(false)
+		, ready(static_cast<uint32_t>(data.size() / constants::HASH_WORDS))
+		, page_divisor(static_cast<uint32_t>(size / constants::MIX_BYTES))
+		, numa(dag_t::get_numa_policy())
+		{
+			lock_items(data, dag_t::get_lock_mode());
+			replicate();
+		}
+
+		void load_items(source_t & source, progress_callback_type callback)
+		{
+			if (ready.load(::std::memory_order_relaxed) < item_count())
+			{
+				read_items(source, data.data(), item_count(), callback, dag_loading, "DAG loading cancelled.", &ready);
+			}
+
+			// DAG files written before checksums were introduced have no trailer
+			size_t const remaining = source.remaining();
+			if ((remaining != source_t::unknown_size) && (remaining >= constants::DAG_FILE_TRAILER_SIZE))
+			{
+				dag_file_trailer_t trailer([&source](void * dst, size_t count) { source.read(dst, count); });
+				checksum = trailer.checksum;
+				has_checksum = true;
+			}
+			replicate();
+		}
+
+		void save(sink_t & sink, progress_callback_type callback) const
+		{
+			uint64_t cache_begin = constants::DAG_FILE_HEADER_SIZE + 1;
+			uint64_t cache_end = cache_begin + cache.size();
+			uint64_t dag_begin = cache_end;
+			uint64_t dag_end = dag_begin + size;
+
+			// TODO: write all value in little endian
+			sink.write(constants::DAG_MAGIC_BYTES, sizeof(constants::DAG_MAGIC_BYTES));
+			sink.write(&constants::MAJOR_VERSION, sizeof(constants::MAJOR_VERSION));
+			sink.write(&constants::REVISION, sizeof(constants::REVISION));
+			sink.write(&constants::MINOR_VERSION, sizeof(constants::MINOR_VERSION));
+			sink.write(&epoch, sizeof(epoch));
+			sink.write(&cache_begin, sizeof(cache_begin));
+			sink.write(&cache_end, sizeof(cache_end));
+			sink.write(&dag_begin, sizeof(dag_begin));
+			sink.write(&dag_end, sizeof(dag_end));
+
+			auto const cache_data = cache.data();
+			size_t const max_count = cache_data.size() + item_count();
+			size_t count = 0;
+			write_items(sink, cache_data.data(), cache_data.size(), count, max_count, callback, dag_saving, "DAG save cancelled.");
+			write_items(sink, data.data(), item_count(), count, max_count, callback, dag_saving, "DAG save cancelled.");
+
+			dag_file_trailer_t const trailer(has_checksum ? checksum : compute_checksum());
+			sink.write(&trailer, sizeof(trailer));
+			sink.flush();
+		}
+
+		uint64_t compute_checksum() const
+		{
+			auto const cache_data = cache.data();
+			uint64_t const ret = checksum_words(checksum_seed, cache_data.data(), cache_data.data() + (cache_data.size() * constants::HASH_WORDS));
+			return checksum_words(ret, data.data(), data.data() + data.size());
+		}
+
+		node const * item(uint32_t index) const
+		{
+			return &data[static_cast<size_t>(index) * constants::HASH_WORDS];
+		}
+
+		size_t item_count() const
+		{
+			return data.size() / constants::HASH_WORDS;
+		}
+
+		// the number of nodes in the items of a DAG of size bytes
+		static size_t node_count(size_type size)
+		{
+			return static_cast<size_t>(size / constants::HASH_BYTES) * constants::HASH_WORDS;
+		}
+
+		// the replica on the node of the calling thread when the DAG is replicated
+		data_view_t view() const
+		{
+			if (!replicas.empty())
+			{
+				uint32_t const node = topology->current_node();
+				if (node != 0)
+				{
+					return data_view_t(replicas[node - 1]->data(), item_count());
+				}
+			}
+			return data_view_t(data.data(), item_count());
+		}
+
+		// pages are interleaved before anything is written to them, so they are first touched on their own node
+		void interleave()
+		{
+			if (numa.mode != numa_interleave)
+			{
+				return;
+			}
+			numa_topology_t const nodes(numa.fake_nodes);
+			::std::vector<uint32_t> all_nodes(nodes.size());
+			for (uint32_t i = 0; i < all_nodes.size(); i++)
+			{
+				all_nodes[i] = i;
+			}
+			if (all_nodes.size() > 1)
+			{
+				nodes.bind(data.data(), data.size_bytes(), mpol_interleave, all_nodes);
+			}
+		}
+
+		// the items stay on the first node and are copied to every other node in parallel, each by a thread pinned to that node,
+		// so each copy is first touched by the node it is bound to. replication is skipped if any copy can not be allocated
+		void replicate()
+		{
+			using namespace std;
+
+			if (numa.mode != numa_replicate)
+			{
+				return;
+			}
+			unique_ptr<numa_topology_t> nodes(new numa_topology_t(numa.fake_nodes));
+			uint32_t const node_count = static_cast<uint32_t>(nodes->size());
+			if (node_count < 2)
+			{
+				return;
+			}
+			nodes->bind(data.data(), data.size_bytes(), mpol_bind, { 0 });
+
+			vector<unique_ptr<item_storage_t>> copies(node_count - 1);
+			atomic<bool> failed(false);
+			vector<thread> threads;
+			threads.reserve(node_count - 1);
+			for (uint32_t i = 1; i < node_count; i++)
+			{
+				threads.emplace_back([&, i]()
+				{
+					try
+					{
+						nodes->pin_thread(i);
+						unique_ptr<item_storage_t> copy(new item_storage_t(data.size(), dag_t::get_page_mode(), dag_t::get_allocator()));
+						nodes->bind(copy->data(), copy->size_bytes(), mpol_bind, { i });
+						lock_items(*copy, dag_t::get_lock_mode());
+						::std::memcpy(copy->data(), data.data(), data.size() * sizeof(node));
+						copies[i - 1] = move(copy);
+					}
+					catch (...)
+					{
+						failed = true;
+					}
+				});
+			}
+			for (auto & i : threads)
+			{
+				i.join();
+			}
+
+			if (!failed)
+			{
+				topology = move(nodes);
+				replicas = move(copies);
+			}
+		}
+
+		uint32_t replica_count() const
+		{
+			return static_cast<uint32_t>(replicas.size() + 1);
+		}
+
+		// every copy of the items is counted when the DAG is replicated
+		residency_t residency() const
+		{
+			residency_t ret = { data.resident_bytes(), data.size_bytes(), data.is_locked() };
+			for (auto const & i : replicas)
+			{
+				ret.resident_bytes += i->resident_bytes();
+				ret.total_bytes += i->size_bytes();
+				ret.locked = ret.locked && i->is_locked();
+			}
+			return ret;
+		}
+
+		bool verify(verify_mode mode, uint32_t sample_count, progress_callback_type callback) const
+		{
+			switch (mode)
+			{
+				case verify_none:
+					return true;
+				case verify_checksum:
+					if (has_checksum)
+					{
+						return compute_checksum() == checksum;
+					}
+					return verify_samples(sample_count, callback);
+				case verify_sampled:
+					return verify_samples(sample_count, callback);
+				case verify_full:
+					return verify_all(callback);
+				default:
+					throw hash_exception("Unknown DAG verification mode.");
+			}
+		}
+
+		bool verify_item(uint32_t index) const
+		{
+			node expected[constants::HASH_WORDS];
+			cache_t::impl_t const & cache_impl = get_cache_impl(cache);
+			calc_dataset_item(cache_impl.view(), cache_impl.item_divisor, index, expected);
+			return ::std::memcmp(expected, item(index), constants::HASH_BYTES) == 0;
+		}
+
+		bool verify_samples(uint32_t sample_count, progress_callback_type callback) const
+		{
+			if (data.empty())
+			{
+				return false;
+			}
+
+			// the first and last items are always checked to catch truncated or padded files
+			uint32_t const last = static_cast<uint32_t>(item_count() - 1);
+			if (!verify_item(0) || !verify_item(last))
+			{
+				return false;
+			}
+
+			::std::mt19937_64 rng(::std::random_device{}());
+			::std::uniform_int_distribution<uint32_t> distribution(0, last);
+			for (uint32_t i = 0; i < sample_count; i++)
+			{
+				if (!verify_item(distribution(rng)))
+				{
+					return false;
+				}
+				if ((((i + 1) % constants::CALLBACK_FREQUENCY) == 0) && !callback(i + 1, sample_count, dag_verification))
+				{
+					throw hash_exception("DAG verification cancelled.");
+				}
+			}
+			return true;
+		}
+
+		bool verify_all(progress_callback_type callback) const
+		{
+			using namespace std;
+
+			uint32_t const n = static_cast<uint32_t>(item_count());
+			thread_pool_t const pool = thread_pool_t::get_default();
+			atomic<uint32_t> next_block(0);
+			atomic<bool> corrupt(false);
+			progress_t const progress = progress_t::from_callback(callback);
+			progress(0, n, dag_verification);
+
+			// items are handed out in blocks of CALLBACK_FREQUENCY, and every worker reports its blocks and checks for cancellation
+			auto worker = [&]()
+			{
+				for (uint32_t block = next_block++; !corrupt && !progress.is_cancelled(); block = next_block++)
+				{
+					uint64_t const begin = static_cast<uint64_t>(block) * constants::CALLBACK_FREQUENCY;
+					if (begin >= n)
+					{
+						break;
+					}
+					uint32_t const end = static_cast<uint32_t>((min)(begin + constants::CALLBACK_FREQUENCY, static_cast<uint64_t>(n)));
+					for (uint32_t i = static_cast<uint32_t>(begin); i < end; i++)
+					{
+						if (!verify_item(i))
+						{
+							corrupt = true;
+							break;
+						}
+					}
+					progress.advance(end - static_cast<uint32_t>(begin), n, dag_verification);
+				}
+			};
+
+			pool.parallel_for(pool.size(), [&](size_t) { worker(); });
+
+			if (progress.is_cancelled() && !corrupt)
+			{
+				throw hash_exception("DAG verification cancelled.");
+			}
+			return !corrupt;
+		}
+
+		// a throttle paces the generation after every constants::CALLBACK_FREQUENCY items
+		void generate(progress_callback_type callback, generation_throttle_t * throttle = nullptr)
+		{
+			uint32_t const n = static_cast<uint32_t>(item_count());
+			cache_t::impl_t const & cache_impl = get_cache_impl(cache);
+			auto const cache_data = cache_impl.view();
+			for (uint32_t i = 0; i < n; i++)
+			{
+				calc_dataset_item(cache_data, cache_impl.item_divisor, i, &data[static_cast<size_t>(i) * constants::HASH_WORDS]);
+				if ((i % constants::CALLBACK_FREQUENCY) == 0)
+				{
+					ready.store(i + 1, ::std::memory_order_release);
+					if (throttle)
+					{
+						throttle->pace(i + 1);
+					}
+					if (!callback(i, n, dag_generation))
+					{
+						throw hash_exception("DAG creation cancelled.");
+					}
+				}
+			}
+			ready.store(n, ::std::memory_order_release);
+			if (throttle)
+			{
+				throttle->end(n);
+			}
+			if (!callback(n, n, dag_generation))
+			{
+				throw hash_exception("DAG creation cancelled.");
+			}
+			checksum = compute_checksum();
+			has_checksum = true;
+			replicate();
+		}
+
+		// items below the ready watermark may be read while the rest are still being generated or loaded
+		uint32_t ready_items() const
+		{
+			return ready.load(::std::memory_order_acquire);
+		}
+
+		// n is the number of items in the cache
+		static void calc_dataset_item(data_view_t const & cache, fast_divisor_t const & n, uint32_t const i, node * out)
+		{
+			constexpr uint32_t r = constants::HASH_WORDS;
+			node mix[constants::HASH_WORDS];
+			::std::memcpy(mix, cache[n.mod(i)], constants::HASH_BYTES);
+			mix[0].hword ^= i;
+			sha3_512_item(out, mix, constants::HASH_BYTES);
+			::std::memcpy(mix, out, constants::HASH_BYTES);
+			for (uint32_t j = 0; j < constants::DATASET_PARENTS; j++)
+			{
+				uint32_t const cache_index = fnv(i ^ j, mix[j % r].hword);
+				node const * parent = cache[n.mod(cache_index)];
+				for (uint32_t k = 0; k < constants::HASH_WORDS; k++)
+				{
+					mix[k].hword = fnv(mix[k].hword, parent[k].hword);
+				}
+			}
+			sha3_512_item(out, mix, constants::HASH_BYTES);
+		}
+
+		cache_t get_cache() const
+		{
+			return cache;
+		}
+
+		// dag_t is a friend of cache_t, this gives the light hash functions access to a cache's implementation
+		static cache_t::impl_t & get_cache_impl(cache_t const & cache)
+		{
+			return *cache.impl;
+		}
+
+		// share the cache this DAG was loaded with through the cache cache, so light hashes don't regenerate it
+		void register_cache()
+		{
+			cache.impl = add_to_cache_cache(cache.impl);
+		}
+
+		static size_type get_full_size(uint64_t const block_number) noexcept
+		{
+			using namespace constants;
+
+			uint64_t const epoch = block_number / EPOCH_LENGTH;
+			if (epoch < EPOCH_SIZE_TABLE_LENGTH)
+			{
+				return static_cast<size_type>(dag_sizes[epoch]);
+			}
+
+			uint64_t full_size = (DATASET_BYTES_INIT + (DATASET_BYTES_GROWTH * (block_number / EPOCH_LENGTH))) - MIX_BYTES;
+			while (!is_prime(full_size / MIX_BYTES))
+			{
+				full_size -= (2 * MIX_BYTES);
+			}
+			return full_size;
+		}
+
+		uint64_t epoch;
+		size_type size;
+		cache_t cache;
+		data_type data;
+		uint64_t checksum;
+		bool has_checksum;
+		::std::atomic<uint32_t> ready;
+		fast_divisor_t const page_divisor;
+		numa_policy_t const numa;
+		::std::unique_ptr<numa_topology_t const> topology; // set with the replicas, which are only made before the DAG is shared
+		::std::vector<::std::unique_ptr<item_storage_t>> replicas; // the copy for each node after the first
+	};
+
+	void cache_t::impl_t::dataset_item(item_cache_t * items, uint32_t index, node * out) const
+	{
+		if ((items != nullptr) && items->lookup(index, out))
+		{
+			return;
+		}
+		dag_t::impl_t::calc_dataset_item(view(), item_divisor, index, out);
+		if (items != nullptr)
+		{
+			items->store(index, out);
+		}
+	}
+
+	void cache_t::dataset_item(uint32_t index, node * out) const
+	{
+		impl->dataset_item(impl->get_item_cache().get(), index, out);
+	}
+
+	void cache_t::set_item_cache_size(size_type megabytes) const
+	{
+		size_t const slot_count = item_cache_t::slots_for(megabytes);
+		::std::shared_ptr<item_cache_t> items;
+		if (slot_count != 0)
+		{
+			items = ::std::make_shared<item_cache_t>(slot_count);
+		}
+		::std::atomic_store(&impl->item_cache, items);
+	}
+
+	cache_t::item_cache_stats_t cache_t::get_item_cache_stats() const
+	{
+		auto const items = impl->get_item_cache();
+		if (!items)
+		{
+			return item_cache_stats_t{0, 0, 0};
+		}
+		return items->stats();
+	}
+
+	// construct on first use mutex ensures safe static initialization order
+	std::recursive_mutex & get_dag_cache_mutex()
+	{
+		static std::recursive_mutex mutex;
+		return mutex;
+	}
+	// ensures single threaded construction
+	std::recursive_mutex & dag_cache_mutex = get_dag_cache_mutex();
+
+	// construct on first use dag_cache_map ensures safe static initialization order
+	dag_t::impl_t::dag_cache_map & get_dag_cache()
+	{
+		std::lock_guard<std::recursive_mutex> lock(get_dag_cache_mutex());
+		static dag_t::impl_t::dag_cache_map dag_cache;
+		return dag_cache;
+	}
+	// ensures single threaded construction
+	dag_t::impl_t::dag_cache_map & dag_cache = get_dag_cache();
+
+	// returns the DAG for epoch if it is loaded, or nullptr
+	::std::shared_ptr<dag_t::impl_t> find_dag(uint64_t epoch)
+	{
+		using namespace std;
+		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
+		auto const dag_cache_iterator = get_dag_cache().find(epoch);
+		if (dag_cache_iterator != get_dag_cache().end())
+		{
+			return dag_cache_iterator->second;
+		}
+		return nullptr;
+	}
+
+	// add a DAG to the cache, returning the DAG which was already there if another thread got there first
+	::std::shared_ptr<dag_t::impl_t> add_to_dag_cache(::std::shared_ptr<dag_t::impl_t> const & impl)
+	{
+		using namespace std;
+		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
+		auto insert_pair = get_dag_cache().insert(make_pair(impl->epoch, impl));
+
+		// if insert succeded, return the dag
+		if (insert_pair.second)
+		{
+			return insert_pair.first->second;
+		}
+
+		// if insert failed, it's probably already been inserted
+		auto const dag_cache_iterator = get_dag_cache().find(impl->epoch);
+		if (dag_cache_iterator != get_dag_cache().end())
+		{
+			return dag_cache_iterator->second;
+		}
+
+		// we couldn't insert it and it's not in the cache
+		throw hash_exception("Could not get DAG");
+	}
+
+	// read the header of a DAG file, checking it against the size of the source where that is known
+	dag_file_header_t read_dag_header(source_t & source)
+	{
+		// check minimum dag size
+		dag_t::size_type const filesize = source.remaining();
+		bool const known_size = (filesize != source_t::unknown_size);
+		if (known_size && (filesize < constants::DAG_FILE_MINIMUM_SIZE))
+		{
+			throw hash_exception("DAG is corrupt");
+		}
+
+		// TODO: this func needs to be made endian safe
+		dag_file_header_t header([&source](void * dst, size_t count) { source.read(dst, count); });
+
+		if (known_size && ((header.cache_end >= filesize) || (header.dag_end > (filesize + 1))))
+		{
+			throw hash_exception("DAG is corrupt");
+		}
+		return header;
+	}
+
+	// apply the verify policy to a freshly loaded DAG
+	void check_verify_policy(dag_t::impl_t const & impl, progress_callback_type callback)
+	{
+		verify_policy_t const policy = dag_t::get_verify_policy();
+		if (!impl.verify(policy.mode, policy.sample_count, callback))
+		{
+			throw hash_exception("DAG failed verification");
+		}
+	}
+
+	// take over DAG items which were computed elsewhere, checking them against the verify policy
+	::std::shared_ptr<dag_t::impl_t> adopt_dag(uint64_t block_number, item_storage_t && items, progress_callback_type callback)
+	{
+		using namespace std;
+
+		// if we have the correct DAG already loaded, return it from the cache
+		shared_ptr<dag_t::impl_t> const loaded = find_dag(block_number / constants::EPOCH_LENGTH);
+		if (loaded)
+		{
+			return loaded;
+		}
+
+		shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(block_number, move(items), callback));
+		check_verify_policy(*impl, callback);
+		return add_to_dag_cache(impl);
+	}
+
+	// construct on first use ensures safe static initialization order
+	std::mutex & get_shared_memory_prefix_mutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	::std::string & get_shared_memory_prefix_instance()
+	{
+		static ::std::string prefix;
+		return prefix;
+	}
+
+	// the first page of a shared DAG segment, the items start on the page after it
+	// a segment which has just been created is all zeroes, which reads as building with no known creator
+	struct shared_dag_header_t
+	{
+		static constexpr uint32_t building = 0;
+		static constexpr uint32_t ready = 1;
+		static constexpr uint32_t failed = 2;
+		static constexpr char magic_bytes[] = "egihash-shm-dag";
+		static constexpr size_t max_holders = 256;
+
+		// the creator holds the first slot
+		shared_dag_header_t(uint64_t epoch, uint64_t size)
+		: magic{0}
+		, epoch(epoch)
+		, size(size)
+		, state(building)
+		, creator(static_cast<int32_t>(::getpid()))
+		, step(0)
+		, max(0)
+		, phase(0)
+		{
+			::std::memcpy(magic, magic_bytes, sizeof(magic_bytes));
+			for (auto & holder : holders)
+			{
+				holder.store(0);
+			}
+			holders[0].store(creator.load());
+		}
+
+		bool valid(uint64_t expected_epoch, uint64_t expected_size) const
+		{
+			return (::std::memcmp(magic, magic_bytes, sizeof(magic_bytes)) == 0) && (epoch == expected_epoch) && (size == expected_size);
+		}
+
+		char magic[sizeof(magic_bytes)];
+		uint64_t epoch;
+		uint64_t size;
+		::std::atomic<uint32_t> state;
+		::std::atomic<int32_t> creator;
+
+		// the progress of the creator, so waiting processes can report it
+		::std::atomic<uint32_t> step;
+		::std::atomic<uint32_t> max;
+		::std::atomic<int32_t> phase;
+
+		// one slot per mapping of the segment, holding the pid of the process which maps it, or 0 if it is free
+		// a process which dies leaves its pid behind rather than releasing its slot, so slots of processes which no longer exist are reclaimed
+		::std::atomic<int32_t> holders[max_holders];
+	};
+
+	constexpr char shared_dag_header_t::magic_bytes[];
+	constexpr size_t shared_dag_header_t::max_holders;
+
+	static_assert(ATOMIC_INT_LOCK_FREE == 2, "Shared DAG segments need lock free atomics.");
+
+	// removes the name of a shared DAG segment, unless the name has since been given to a different segment
+	void unlink_shared_dag(::std::string const & name, ino_t inode) noexcept
+	{
+		int const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0)
+		{
+			return;
+		}
+		struct stat st;
+		bool const same = (::fstat(fd, &st) == 0) && (st.st_ino == inode);
+		::close(fd);
+		if (same)
+		{
+			::shm_unlink(name.c_str());
+		}
+	}
+
+	bool process_exited(pid_t pid) noexcept
+	{
+		return (::kill(pid, 0) != 0) && (errno == ESRCH);
+	}
+
+	// frees the slots of processes which no longer exist, and returns how many slots are still held
+	size_t reclaim_shared_dag_holders(shared_dag_header_t & header) noexcept
+	{
+		size_t held = 0;
+		for (auto & holder : header.holders)
+		{
+			int32_t pid = holder.load(::std::memory_order_acquire);
+			if ((pid != 0) && process_exited(pid) && holder.compare_exchange_strong(pid, 0))
+			{
+				continue;
+			}
+			if (holder.load(::std::memory_order_acquire) != 0)
+			{
+				held++;
+			}
+		}
+		return held;
+	}
+
+	// takes a slot for a mapping of this process, reclaiming the slots of processes which no longer exist first
+	size_t acquire_shared_dag_holder(shared_dag_header_t & header)
+	{
+		int32_t const self = static_cast<int32_t>(::getpid());
+		reclaim_shared_dag_holders(header);
+		for (size_t i = 0; i < shared_dag_header_t::max_holders; i++)
 		{
-			ss << ::std::setw(2) << ::std::setfill('0') << static_cast<uint16_t>(*i);
+			int32_t expected = 0;
+			if (header.holders[i].compare_exchange_strong(expected, self))
+			{
+				return i;
+			}
 		}
-		return ss.str();
+		throw hash_exception("Too many processes share the DAG.");
 	}
 
-	h512_t::operator bool() const
+	// frees the slot of a mapping of this process, the segment is removed once no process which still exists holds a slot
+	// items which are released while they are still being built were abandoned, so the segment is removed for another process to retry
+	void release_shared_dag(void * base, size_t bytes, ::std::string const & name, ino_t inode, size_t slot) noexcept
 	{
-		return (::std::memcmp(&b[0], &empty_h512.b[0], sizeof(b)) != 0);
+		auto * const header = reinterpret_cast<shared_dag_header_t *>(base);
+		uint32_t expected = shared_dag_header_t::building;
+		bool const abandoned = header->state.compare_exchange_strong(expected, shared_dag_header_t::failed);
+		header->holders[slot].store(0, ::std::memory_order_release);
+		if ((reclaim_shared_dag_holders(*header) == 0) || abandoned)
+		{
+			unlink_shared_dag(name, inode);
+		}
+		::munmap(base, bytes);
 	}
 
-	bool h512_t::operator==(h512_t const & rhs) const
+	using shared_build_type = ::std::function<::std::shared_ptr<dag_t::impl_t>(item_storage_t && items, progress_callback_type callback)>;
+
+	// the DAG for an epoch in a POSIX shared memory segment named after the epoch
+	// the process which creates the segment builds the items in it with build, every other process waits until they are ready and maps them read only
+	::std::shared_ptr<dag_t::impl_t> get_shared_dag(uint64_t epoch, ::std::string const & prefix, progress_callback_type callback, shared_build_type build)
 	{
-		return (::std::memcmp(&b[0], &rhs.b[0], sizeof(b)) == 0);
+		using namespace std;
+		constexpr chrono::milliseconds poll_interval(10);
+
+		string const name = prefix + "-" + to_string(epoch);
+		uint64_t const block_number = epoch * constants::EPOCH_LENGTH;
+		dag_t::size_type const size = dag_t::get_full_size(block_number);
+		size_t const offset = (max)(sizeof(shared_dag_header_t), static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+		size_t const total = offset + size;
+
+		for (;;)
+		{
+			int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+			bool const create = (fd >= 0);
+			if (!create)
+			{
+				fd = (errno == EEXIST) ? ::shm_open(name.c_str(), O_RDWR, 0) : -1;
+				if ((fd < 0) && (errno == ENOENT))
+				{
+					// removed since it was found to exist
+					continue;
+				}
+			}
+			if (fd < 0)
+			{
+				throw hash_exception("Could not open shared DAG.");
+			}
+			if (create && (::ftruncate(fd, static_cast<off_t>(total)) != 0))
+			{
+				::close(fd);
+				::shm_unlink(name.c_str());
+				throw hash_exception("Could not size shared DAG.");
+			}
+
+			struct stat st;
+			if (::fstat(fd, &st) != 0)
+			{
+				::close(fd);
+				throw hash_exception("Could not open shared DAG.");
+			}
+			if (st.st_size == 0)
+			{
+				// the creator has not sized it yet
+				::close(fd);
+				this_thread::sleep_for(poll_interval);
+				continue;
+			}
+			if (static_cast<size_t>(st.st_size) != total)
+			{
+				::close(fd);
+				throw hash_exception("Shared DAG segment is invalid.");
+			}
+
+			void * const base = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (base == MAP_FAILED)
+			{
+				if (create)
+				{
+					::shm_unlink(name.c_str());
+				}
+				throw hash_exception("Could not map shared DAG.");
+			}
+
+			auto * const header = reinterpret_cast<shared_dag_header_t *>(base);
+			node * const nodes = reinterpret_cast<node *>(static_cast<char *>(base) + offset);
+			ino_t const inode = st.st_ino;
+			item_storage_t items;
+			auto const release = [base, total, name, inode](size_t slot)
+			{
+				return [base, total, name, inode, slot](void *, size_t) { release_shared_dag(base, total, name, inode, slot); };
+			};
+
+			if (create)
+			{
+				new (header) shared_dag_header_t(epoch, size);
+				items.adopt(nodes, dag_t::impl_t::node_count(size), release(0));
+				auto const progress = [header, callback](size_t step, size_t max, progress_callback_phase phase)
+				{
+					header->step = static_cast<uint32_t>(step);
+					header->max = static_cast<uint32_t>(max);
+					header->phase = static_cast<int32_t>(phase);
+					return callback(step, max, phase);
+				};
+				shared_ptr<dag_t::impl_t> const impl = build(move(items), progress);
+				header->state.store(shared_dag_header_t::ready, memory_order_release);
+				return impl;
+			}
+
+			// a creator which died without finishing leaves the segment building forever
+			uint32_t state = shared_dag_header_t::building;
+			while ((state = header->state.load(memory_order_acquire)) == shared_dag_header_t::building)
+			{
+				pid_t const creator = header->creator;
+				if ((creator != 0) && process_exited(creator))
+				{
+					if (header->state.compare_exchange_strong(state, shared_dag_header_t::failed))
+					{
+						unlink_shared_dag(name, inode);
+					}
+					break;
+				}
+				if (!callback(header->step.load(), header->max.load(), static_cast<progress_callback_phase>(header->phase.load())))
+				{
+					::munmap(base, total);
+					throw hash_exception("Waiting for shared DAG cancelled.");
+				}
+				this_thread::sleep_for(poll_interval);
+			}
+			if (header->state.load(memory_order_acquire) != shared_dag_header_t::ready)
+			{
+				::munmap(base, total);
+				continue;
+			}
+			if (!header->valid(epoch, size))
+			{
+				::munmap(base, total);
+				throw hash_exception("Shared DAG segment is invalid.");
+			}
+
+			// the items are only read from here on
+			size_t slot = 0;
+			try
+			{
+				slot = acquire_shared_dag_holder(*header);
+			}
+			catch (...)
+			{
+				::munmap(base, total);
+				throw;
+			}
+			items.adopt(nodes, dag_t::impl_t::node_count(size), release(slot));
+			::mprotect(nodes, size, PROT_READ);
+			return adopt_dag(block_number, move(items), callback);
+		}
 	}
 
-	result_t::operator bool() const
+	::std::shared_ptr<dag_t::impl_t> get_dag(uint64_t block_number, progress_callback_type callback)
 	{
-		return bool(value) && bool(mixhash);
+		using namespace std;
+
+		// if we have the correct DAG already loaded, return it from the cache
+		shared_ptr<dag_t::impl_t> const loaded = find_dag(block_number / constants::EPOCH_LENGTH);
+		if (loaded)
+		{
+			return loaded;
+		}
+
+		string const prefix = dag_t::get_shared_memory_prefix();
+		if (!prefix.empty())
+		{
+			return add_to_dag_cache(get_shared_dag(block_number / constants::EPOCH_LENGTH, prefix, callback,
+				[block_number](item_storage_t && items, progress_callback_type progress)
+				{
+					shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(block_number, progress, dag_t::impl_t::deferred_t(), move(items)));
+					impl->generate(progress);
+					return impl;
+				}));
+		}
+
+		// otherwise create the dag and add it to the cache
+		// this is not locked as it can be a lengthy process and we don't want to block access to the dag cache
+		shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(block_number, callback));
+		return add_to_dag_cache(impl);
 	}
 
-	bool result_t::operator==(result_t const & rhs) const
+	::std::shared_ptr<dag_t::impl_t> get_dag(source_t & source, progress_callback_type callback)
 	{
-		return ((value == rhs.value) && (mixhash == rhs.mixhash));
+		using namespace std;
+
+		dag_file_header_t header = read_dag_header(source);
+
+		// if we have the correct DAG already loaded, return it from the cache
+		shared_ptr<dag_t::impl_t> const loaded = find_dag(header.epoch);
+		if (loaded)
+		{
+			return loaded;
+		}
+
+		string const prefix = dag_t::get_shared_memory_prefix();
+		if (!prefix.empty())
+		{
+			return add_to_dag_cache(get_shared_dag(header.epoch, prefix, callback,
+				[&source, &header](item_storage_t && items, progress_callback_type progress)
+				{
+					shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(source, header, progress, dag_t::impl_t::deferred_t(), move(items)));
+					impl->load_items(source, progress);
+					check_verify_policy(*impl, progress);
+					impl->register_cache();
+					return impl;
+				}));
+		}
+
+		// otherwise create the dag and add it to the cache
+		// this is not locked as it can be a lengthy process and we don't want to block access to the dag cache
+		shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(source, header, callback));
+		check_verify_policy(*impl, callback);
+		impl->register_cache();
+		return add_to_dag_cache(impl);
 	}
 
-	// TODO: unit tests / validation
-	template <typename T>
-	sha3_512_t::deserialized_hash_t sha3_512(T const & data)
+	::std::shared_ptr<dag_t::impl_t> get_dag(uint64_t block_number, void * items, dag_t::size_type size, release_function_type release, progress_callback_type callback)
 	{
-		return hash_words<sha3_512_t>(data);
+		using namespace std;
+
+		// the items belong to us from here on, so they are released however this ends
+		item_storage_t adopted;
+		adopted.adopt(items, static_cast<size_t>(size / sizeof(node)), release);
+		if ((items == nullptr) || (size != dag_t::get_full_size(block_number)))
+		{
+			throw hash_exception("Adopted DAG size is invalid.");
+		}
+
+		return adopt_dag(block_number, move(adopted), callback);
 	}
 
-	template <typename DataPtr>
-	sha3_512_t::deserialized_hash_t sha3_512(DataPtr const * data, sha3_512_t::size_type data_size)
+	::std::shared_ptr<dag_t::impl_t> get_dag(::std::string const & file_path, progress_callback_type callback)
 	{
-		return hash_words<sha3_512_t>(data, data_size);
+		// DAG data is read in large spans straight into the DAG
+		fd_source source(file_path);
+		return get_dag(source, callback);
 	}
 
-	// TODO: unit tests / validation
-	template <typename T>
-	sha3_256_t::deserialized_hash_t sha3_256(T const & data)
+	dag_t::dag_t(uint64_t block_number, progress_callback_type callback)
+	: impl(get_dag(block_number, callback))
 	{
-		return hash_words<sha3_256_t>(data);
 	}
 
-	template <typename DataPtr>
-	sha3_256_t::deserialized_hash_t sha3_256(DataPtr const * data, sha3_256_t::size_type data_size)
+	dag_t::dag_t(::std::string const & file_path, progress_callback_type callback)
+	: impl(get_dag(file_path, callback))
 	{
-		return hash_words<sha3_256_t>(data, data_size);
+
 	}
 
-	// TODO: unit tests / validation
-	template <typename T>
-	::std::string serialize_cache(T const & cache_data)
+	dag_t::dag_t(source_t & source, progress_callback_type callback)
+	: impl(get_dag(source, callback))
 	{
-		::std::string ret;
-		for (auto const & i : cache_data)
-		{
-			ret += serialize_hash(cache_data);
-		}
-		return ret;
 	}
 
-	// TODO: unit tests / validation
-	template <typename T>
-	::std::string serialize_dataset(T const & dataset)
+	dag_t::dag_t(uint64_t block_number, void * items, size_type size, release_function_type release, progress_callback_type callback)
+	: impl(get_dag(block_number, items, size, release, callback))
 	{
-		return serialize_cache(dataset);
 	}
 
-	struct cache_t::impl_t
+	dag_t::dag_t(::std::shared_ptr<impl_t> const & impl)
+	: impl(impl)
 	{
-		using size_type = cache_t::size_type;
-		using data_type = ::std::vector<std::vector<node>>;
-		using cache_cache_map = ::std::map<uint64_t /* epoch */, ::std::shared_ptr<impl_t>>;
+	}
 
-		impl_t(uint64_t const block_number, progress_callback_type callback)
-		: epoch(block_number / constants::EPOCH_LENGTH)
-		, seedhash(get_seedhash(block_number))
-		, size(get_cache_size(block_number))
-		, data()
+	uint64_t dag_t::epoch() const
+	{
+		return impl->epoch;
+	}
+
+	dag_t::size_type dag_t::size() const
+	{
+		return impl->size;
+	}
+
+	dag_t::data_type dag_t::data() const
+	{
+		return impl->view();
+	}
+
+	void dag_t::save(::std::string const & file_path, progress_callback_type callback) const
+	{
+		save_file(file_path, [this, &callback](sink_t & sink) { impl->save(sink, callback); });
+	}
+
+	void dag_t::save(sink_t & sink, progress_callback_type callback) const
+	{
+		impl->save(sink, callback);
+	}
+
+	cache_t dag_t::get_cache() const
+	{
+		return impl->get_cache();
+	}
+
+	bool dag_t::verify(verify_mode mode, uint32_t sample_count, progress_callback_type callback) const
+	{
+		return impl->verify(mode, sample_count, callback);
+	}
+
+	void dag_t::unload() const
+	{
+		auto const i = get_dag_cache().erase(epoch());
+		if (i == 0)
 		{
-			mkcache(callback);
+			throw hash_exception("Can not unload DAG - not loaded.");
 		}
+		get_cache().unload();
+	}
 
-		impl_t(uint64_t epoch, uint64_t size, read_function_type read, progress_callback_type callback)
-		: epoch(epoch)
-		, seedhash(get_seedhash((epoch * constants::EPOCH_LENGTH) + 1))
-		, size(size)
-		, data()
+	dag_t::size_type dag_t::get_full_size(uint64_t const block_number) noexcept
+	{
+		return impl_t::get_full_size(block_number);
+	}
+
+	bool dag_t::is_loaded(uint64_t const epoch)
+	{
+		using namespace std;
+		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
+		auto const & dag_cache = get_dag_cache();
+		return (dag_cache.find(epoch) != dag_cache.end());
+	}
+
+	::std::vector<uint64_t> dag_t::get_loaded()
+	{
+		using namespace std;
+		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
+		auto const & dag_cache = get_dag_cache();
+		::std::vector<uint64_t> loaded_epochs;
+		loaded_epochs.reserve(dag_cache.size());
+		for (auto const & i : dag_cache)
 		{
-			load(read, callback);
+			loaded_epochs.push_back(i.first);
 		}
+		return loaded_epochs;
+	}
 
-		void mkcache(progress_callback_type callback)
-		{
-			uint32_t n = size / constants::HASH_BYTES;
+	// construct on first use mutex ensures safe static initialization order
+	std::mutex & get_verify_policy_mutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
 
-			data.reserve(n);
-			data.push_back(sha3_512(&seedhash.b[0], seedhash.hash_size));
-			for (uint32_t i = 1; i < n; i++)
-			{
-				data.push_back(sha3_512(data.back()));
-				if (((i % constants::CALLBACK_FREQUENCY) == 0) && !callback(i, n, cache_seeding))
-				{
-					throw hash_exception("Cache creation cancelled.");
-				}
-			}
+	verify_policy_t & get_verify_policy_instance()
+	{
+		static verify_policy_t policy = { verify_sampled, constants::VERIFY_SAMPLE_COUNT };
+		return policy;
+	}
 
-			//std::cout << "Length: " << data.size() << std::endl;
+	void dag_t::set_verify_policy(verify_policy_t const & policy)
+	{
+		std::lock_guard<std::mutex> lock(get_verify_policy_mutex());
+		get_verify_policy_instance() = policy;
+	}
 
-			uint32_t progress_counter = 0;
-			for (uint32_t i = 0; i < constants::CACHE_ROUNDS; i++)
-			{
-				for (uint32_t j = 0; j < n; j++)
-				{
-					auto v = data[j][0].hword % n;
-					auto u = data[(n - 1 + j)%n];
-					size_t count = 0;
-					for (auto & k : u)
-					{
-						k.hword = k.hword ^ data[v][count++].hword;
-					}
-					data[j] = sha3_512(u);
+	verify_policy_t dag_t::get_verify_policy()
+	{
+		std::lock_guard<std::mutex> lock(get_verify_policy_mutex());
+		return get_verify_policy_instance();
+	}
 
-					if (((++progress_counter % constants::CALLBACK_FREQUENCY) == 0) && !callback(progress_counter, n * constants::CACHE_ROUNDS, cache_generation))
-					{
-						throw hash_exception("Cache creation cancelled.");
-					}
-				}
-			}
-		}
+	// construct on first use ensures safe static initialization order
+	std::atomic<page_mode> & get_dag_page_mode()
+	{
+		static std::atomic<page_mode> mode(pages_normal);
+		return mode;
+	}
+
+	std::atomic<page_mode> & get_cache_page_mode()
+	{
+		static std::atomic<page_mode> mode(pages_normal);
+		return mode;
+	}
+
+	void dag_t::set_page_mode(page_mode mode)
+	{
+		get_dag_page_mode().store(mode);
+	}
+
+	page_mode dag_t::get_page_mode()
+	{
+		return get_dag_page_mode().load();
+	}
 
-		void load(read_function_type read, progress_callback_type callback)
-		{
-			size_type const cache_hash_count = size / constants::HASH_BYTES;
+	page_backing dag_t::backing() const
+	{
+		return impl->data.get_backing();
+	}
 
-			data.resize(cache_hash_count);
-			size_t count = 0;
-			for (auto & i : data)
-			{
-				i.resize(constants::HASH_BYTES / constants::WORD_BYTES);
-				read(&i[0], constants::HASH_BYTES);
-				if (((++count % constants::CALLBACK_FREQUENCY) == 0) && !callback(count, cache_hash_count, cache_loading))
-				{
-					throw hash_exception("Cache loading cancelled.");
-				}
-			}
-		}
+	uint32_t dag_t::replica_count() const
+	{
+		return impl->replica_count();
+	}
 
-		static size_type get_cache_size(uint64_t block_number) noexcept
-		{
-			using namespace constants;
+	residency_t dag_t::residency() const
+	{
+		return impl->residency();
+	}
 
-			size_type cache_size = (CACHE_BYTES_INIT + (CACHE_BYTES_GROWTH * (block_number / EPOCH_LENGTH))) - HASH_BYTES;
-			while (!is_prime(cache_size / HASH_BYTES))
-			{
-				cache_size -= (2 * HASH_BYTES);
-			}
-			return cache_size;
-		}
+	// construct on first use ensures safe static initialization order
+	std::atomic<memory_lock_mode> & get_dag_lock_mode()
+	{
+		static std::atomic<memory_lock_mode> mode(lock_none);
+		return mode;
+	}
 
-		static h256_t get_seedhash(uint64_t const block_number)
-		{
-			::std::string s(epoch0_seedhash, size_epoch0_seedhash);
-			for (size_t i = 0; i < (block_number / constants::EPOCH_LENGTH); i++)
-			{
-				s = sha3_256_t::serialize(sha3_256(s));
-			}
-			h256_t ret;
-			::std::memcpy(&ret.b[0], s.c_str(), (std::min)(ret.hash_size, s.length()));
-			return ret;
-		}
+	std::atomic<memory_lock_mode> & get_cache_lock_mode()
+	{
+		static std::atomic<memory_lock_mode> mode(lock_none);
+		return mode;
+	}
 
-		uint64_t epoch;
-		h256_t seedhash;
-		size_type size;
-		data_type data;
-	};
+	void dag_t::set_lock_mode(memory_lock_mode mode)
+	{
+		get_dag_lock_mode().store(mode);
+	}
 
-	// construct on first use mutex ensures safe static initialization order
-	std::recursive_mutex & get_cache_cache_mutex()
+	memory_lock_mode dag_t::get_lock_mode()
 	{
-		static std::recursive_mutex mutex;
-		return mutex;
+		return get_dag_lock_mode().load();
 	}
-	// ensures single threaded construction
-	std::recursive_mutex & cache_cache_mutex = get_cache_cache_mutex();
 
-	// construct on first use dag_cache_map ensures safe static initialization order
-	cache_t::impl_t::cache_cache_map & get_cache_cache()
+	void cache_t::set_lock_mode(memory_lock_mode mode)
 	{
-		std::lock_guard<std::recursive_mutex> lock(get_cache_cache_mutex());
-		static cache_t::impl_t::cache_cache_map cache_cache;
-		return cache_cache;
+		get_cache_lock_mode().store(mode);
 	}
-	// ensures single threaded construction
-	cache_t::impl_t::cache_cache_map & cache_cache = get_cache_cache();
 
-	void cache_t::unload() const
+	memory_lock_mode cache_t::get_lock_mode()
 	{
-		get_cache_cache().erase(epoch());
+		return get_cache_lock_mode().load();
 	}
 
-	::std::shared_ptr<cache_t::impl_t> get_cache_from_cache(uint64_t const block_number, progress_callback_type callback)
+	residency_t cache_t::residency() const
 	{
-		using namespace std;
-		uint64_t epoch_number = block_number / constants::EPOCH_LENGTH;
+		residency_t const ret = { impl->data.resident_bytes(), impl->data.size_bytes(), impl->data.is_locked() };
+		return ret;
+	}
 
-		// if we have the correct cache already loaded, return it from the cache cache
-		{
-			lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
-			auto const cache_cache_iterator = get_cache_cache().find(epoch_number);
-			if (cache_cache_iterator != get_cache_cache().end())
-			{
-				return cache_cache_iterator->second;
-			}
-		}
+	std::mutex & get_numa_policy_mutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
 
-		// otherwise create the cache and add it to the cache cache
-		// this is not locked as it can be a lengthy process and we don't want to block access to the cache cache
-		shared_ptr<cache_t::impl_t> impl(new cache_t::impl_t(block_number, callback));
+	numa_policy_t & get_numa_policy_instance()
+	{
+		static numa_policy_t policy = { numa_local, 0 };
+		return policy;
+	}
 
-		lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
-		auto insert_pair = get_cache_cache().insert(make_pair(epoch_number, impl));
+	void dag_t::set_numa_policy(numa_policy_t const & policy)
+	{
+		std::lock_guard<std::mutex> lock(get_numa_policy_mutex());
+		get_numa_policy_instance() = policy;
+	}
 
-		// if insert succeded, return the cache
-		if (insert_pair.second)
-		{
-			return insert_pair.first->second;
-		}
+	numa_policy_t dag_t::get_numa_policy()
+	{
+		std::lock_guard<std::mutex> lock(get_numa_policy_mutex());
+		return get_numa_policy_instance();
+	}
 
-		// if insert failed, it's probably already been inserted
-		auto const cache_cache_iterator = get_cache_cache().find(epoch_number);
-		if (cache_cache_iterator != get_cache_cache().end())
-		{
-			return cache_cache_iterator->second;
-		}
+	void dag_t::set_shared_memory_prefix(::std::string const & prefix)
+	{
+		std::lock_guard<std::mutex> lock(get_shared_memory_prefix_mutex());
+		get_shared_memory_prefix_instance() = prefix;
+	}
 
-		// we couldn't insert it and it's not in the cache
-		throw hash_exception("Could not get cache");
+	::std::string dag_t::get_shared_memory_prefix()
+	{
+		std::lock_guard<std::mutex> lock(get_shared_memory_prefix_mutex());
+		return get_shared_memory_prefix_instance();
 	}
 
-	cache_t::cache_t(uint64_t const block_number, progress_callback_type callback)
-	: impl(get_cache_from_cache(block_number, callback))
+	uint32_t dag_t::get_numa_node_count()
 	{
+		return static_cast<uint32_t>(numa_topology_t(get_numa_policy().fake_nodes).size());
 	}
 
-	cache_t::cache_t(uint64_t epoch, uint64_t size, read_function_type read, progress_callback_type callback)
-	: impl(new impl_t(epoch, size, read, callback))
+	::std::shared_ptr<allocator_t> allocator_t::get_page_allocator()
 	{
+		static ::std::shared_ptr<allocator_t> const allocator = ::std::make_shared<page_allocator_t>();
+		return allocator;
 	}
 
-	uint64_t cache_t::epoch() const
+	// construct on first use ensures safe static initialization order
+	std::mutex & get_allocator_mutex()
 	{
-		return impl->epoch;
+		static std::mutex mutex;
+		return mutex;
 	}
 
-	cache_t::size_type cache_t::size() const
+	::std::shared_ptr<allocator_t> & get_dag_allocator()
 	{
-		return impl->size;
+		static ::std::shared_ptr<allocator_t> allocator = allocator_t::get_page_allocator();
+		return allocator;
 	}
 
-	cache_t::data_type const & cache_t::data() const
+	::std::shared_ptr<allocator_t> & get_cache_allocator()
 	{
-		return impl->data;
+		static ::std::shared_ptr<allocator_t> allocator = allocator_t::get_page_allocator();
+		return allocator;
 	}
 
-	h256_t cache_t::seedhash() const
+	void dag_t::set_allocator(::std::shared_ptr<allocator_t> const & allocator)
 	{
-		return impl->seedhash;
+		std::lock_guard<std::mutex> lock(get_allocator_mutex());
+		get_dag_allocator() = allocator ? allocator : allocator_t::get_page_allocator();
 	}
 
-	void cache_t::load(read_function_type read, progress_callback_type callback)
+	::std::shared_ptr<allocator_t> dag_t::get_allocator()
 	{
-		impl->load(read, callback);
+		std::lock_guard<std::mutex> lock(get_allocator_mutex());
+		return get_dag_allocator();
 	}
 
-	cache_t::size_type cache_t::get_cache_size(uint64_t const block_number) noexcept
+	void cache_t::set_allocator(::std::shared_ptr<allocator_t> const & allocator)
 	{
-		return impl_t::get_cache_size(block_number);
+		std::lock_guard<std::mutex> lock(get_allocator_mutex());
+		get_cache_allocator() = allocator ? allocator : allocator_t::get_page_allocator();
 	}
 
-	h256_t cache_t::get_seedhash(uint64_t const block_number)
+	::std::shared_ptr<allocator_t> cache_t::get_allocator()
 	{
-		return impl_t::get_seedhash(block_number);
+		std::lock_guard<std::mutex> lock(get_allocator_mutex());
+		return get_cache_allocator();
 	}
 
-	bool cache_t::is_loaded(uint64_t const epoch)
+	void cache_t::set_page_mode(page_mode mode)
 	{
-		using namespace std;
-		lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
-		auto const & cache_cache = get_cache_cache();
-		return (cache_cache.find(epoch) != cache_cache.end());
+		get_cache_page_mode().store(mode);
 	}
 
-	::std::vector<uint64_t> cache_t::get_loaded()
+	page_mode cache_t::get_page_mode()
 	{
-		using namespace std;
-		lock_guard<recursive_mutex> lock(get_cache_cache_mutex());
-		auto const & cache_cache = get_cache_cache();
-		::std::vector<uint64_t> loaded_epochs;
-		loaded_epochs.reserve(cache_cache.size());
-		for (auto const & i : cache_cache)
-		{
-			loaded_epochs.push_back(i.first);
-		}
-		return loaded_epochs;
+		return get_cache_page_mode().load();
 	}
 
-	struct dag_t::impl_t
+	page_backing cache_t::backing() const
 	{
-		using size_type = dag_t::size_type;
-		using data_type = ::std::vector<::std::vector<node>>;
-		using dag_cache_map = ::std::map<uint64_t /* epoch */, ::std::shared_ptr<impl_t>>;
-		static constexpr uint64_t max_epoch = ::std::numeric_limits<uint64_t>::max();
+		return impl->data.get_backing();
+	}
 
-		impl_t(uint64_t block_number, progress_callback_type callback)
+	// the dataset is reserved but not committed, and items are written in place as they are computed
+	// residency is tracked per page: each page has a sequence lock which is odd while it is being released,
+	// so a read which races with the release of its page is detected and the item is computed instead
+	struct lazy_dag_t::impl_t
+	{
+		struct page_t
+		{
+			::std::atomic<uint32_t> sequence;
+			::std::atomic<uint8_t> lock;
+			::std::atomic<uint8_t> resident;
+			::std::atomic<uint8_t> referenced;
+		};
+
+		impl_t(uint64_t const block_number, size_type budget_bytes, progress_callback_type callback)
 		: epoch(block_number / constants::EPOCH_LENGTH)
-		, size(get_full_size(block_number))
+		, size(dag_t::get_full_size(block_number))
 		, cache(block_number, callback)
-		, data()
+		, page_size(static_cast<size_type>(::sysconf(_SC_PAGESIZE)))
+		, page_count((size + page_size - 1) / page_size)
+		, items_per_page(static_cast<uint32_t>(page_size / constants::HASH_BYTES))
+		, mapping(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0))
+		, pages(new page_t[page_count])
+		, present(new ::std::atomic<uint64_t>[((size / constants::HASH_BYTES) + 63) / 64])
+		, budget_pages(pages_for(budget_bytes))
+		, resident_pages(0)
+		, hits(0)
+		, misses(0)
+		, evictions(0)
+		, clock_hand(0)
+		, eviction_mutex()
 		{
-			generate(callback);
-		}
+			if (mapping == MAP_FAILED)
+			{
+				throw hash_exception("Could not reserve address space for lazy DAG.");
+			}
+			// items are read in a random order, read ahead would only fault in items which are never computed
+			::madvise(mapping, size, MADV_RANDOM);
 
-		impl_t(read_function_type read, dag_file_header_t & header, progress_callback_type callback)
-		: epoch(header.epoch)
-		, size(header.dag_end - header.dag_begin)
-		, cache(header.epoch, header.cache_end - header.cache_begin, read, callback)
-		, data()
-		{
-			// load the DAG
-			size_type dag_hash_count = size / constants::HASH_BYTES;
-			data.resize(dag_hash_count);
-			size_t count = 0;
-			for (auto & i : data)
+			for (size_type i = 0; i < page_count; i++)
 			{
-				i.resize(constants::HASH_BYTES / constants::WORD_BYTES);
-				read(&i[0], constants::HASH_BYTES);
-				if (((++count % constants::CALLBACK_FREQUENCY) == 0) && !callback(count, data.size(), dag_loading))
-				{
-					throw hash_exception("DAG loading cancelled.");
-				}
+				pages[i].sequence.store(0, ::std::memory_order_relaxed);
+				pages[i].lock.store(0, ::std::memory_order_relaxed);
+				pages[i].resident.store(0, ::std::memory_order_relaxed);
+				pages[i].referenced.store(0, ::std::memory_order_relaxed);
+			}
+			for (size_type i = 0; i < ((size / constants::HASH_BYTES) + 63) / 64; i++)
+			{
+				present[i].store(0, ::std::memory_order_relaxed);
 			}
 		}
 
-		void save(::std::string const & file_path, progress_callback_type callback) const
+		~impl_t()
 		{
-			using namespace std;
-			ofstream fs;
-			fs.open(file_path, ios::out | ios::binary);
+			::munmap(mapping, size);
+		}
 
-			uint64_t cache_begin = constants::DAG_FILE_HEADER_SIZE + 1;
-			uint64_t cache_end = cache_begin + cache.size();
-			uint64_t dag_begin = cache_end;
-			uint64_t dag_end = dag_begin + size;
+		size_type pages_for(size_type budget_bytes) const
+		{
+			return (std::max)(static_cast<size_type>(1), budget_bytes / page_size);
+		}
+
+		node * item_ptr(uint32_t index) const
+		{
+			return reinterpret_cast<node *>(mapping) + (static_cast<size_t>(index) * constants::HASH_WORDS);
+		}
+
+		bool is_present(uint32_t index) const
+		{
+			return (present[index / 64].load(::std::memory_order_acquire) & (uint64_t(1) << (index % 64))) != 0;
+		}
 
-			auto write = [&fs](void const * data, size_type count)
+		void item(uint32_t index, node * out)
+		{
+			page_t & page = pages[index / items_per_page];
+			uint32_t const before = page.sequence.load(::std::memory_order_acquire);
+			if (((before & 1) == 0) && is_present(index))
 			{
-				// TODO: write all value in little endian
-				fs.write(reinterpret_cast<char const *>(data), count);
-				if (fs.fail())
+				::std::memcpy(out, item_ptr(index), constants::HASH_BYTES);
+				::std::atomic_thread_fence(::std::memory_order_acquire);
+				if (page.sequence.load(::std::memory_order_relaxed) == before)
 				{
-					throw hash_exception("Write failure");
+					page.referenced.store(1, ::std::memory_order_relaxed);
+					hits.fetch_add(1, ::std::memory_order_relaxed);
+					return;
 				}
-			};
+			}
 
-			write(constants::DAG_MAGIC_BYTES, sizeof(constants::DAG_MAGIC_BYTES));
-			write(&constants::MAJOR_VERSION, sizeof(constants::MAJOR_VERSION));
-			write(&constants::REVISION, sizeof(constants::REVISION));
-			write(&constants::MINOR_VERSION, sizeof(constants::MINOR_VERSION));
-			write(&epoch, sizeof(epoch));
-			write(&cache_begin, sizeof(cache_begin));
-			write(&cache_end, sizeof(cache_end));
-			write(&dag_begin, sizeof(dag_begin));
-			write(&dag_end, sizeof(dag_end));
-
-			size_t max_count = cache.size() + data.size();
-			size_t count = 0;
-			for (auto const & i : cache.data())
+			misses.fetch_add(1, ::std::memory_order_relaxed);
+			cache_t::impl_t const & cache_impl = dag_t::impl_t::get_cache_impl(cache);
+			dag_t::impl_t::calc_dataset_item(cache_impl.view(), cache_impl.item_divisor, index, out);
+			fill(page, index, out);
+		}
+
+		// a page locked by another thread is left alone rather than waited for, the item is simply computed again next time
+		void fill(page_t & page, uint32_t index, node const * item)
+		{
+			uint8_t unlocked = 0;
+			if (!page.lock.compare_exchange_strong(unlocked, 1, ::std::memory_order_acquire))
 			{
-				for (auto const & j : i)
-				{
-					write(&j, sizeof(j));
-				}
-				if (((++count % constants::CALLBACK_FREQUENCY) == 0) && !callback(count, max_count, dag_saving))
-				{
-					throw hash_exception("DAG save cancelled.");
-				}
+				return;
 			}
 
-			for (auto const & i : data)
+			bool newly_resident = false;
+			if (!is_present(index))
 			{
-				for (auto const & j : i)
-				{
-					write(&j, sizeof(j));
-				}
-				if (((++count % constants::CALLBACK_FREQUENCY) == 0) && !callback(count, max_count, dag_saving))
+				if (page.resident.load(::std::memory_order_relaxed) == 0)
 				{
-					throw hash_exception("DAG save cancelled.");
+					page.resident.store(1, ::std::memory_order_relaxed);
+					newly_resident = true;
 				}
+				::std::memcpy(item_ptr(index), item, constants::HASH_BYTES);
+				present[index / 64].fetch_or(uint64_t(1) << (index % 64), ::std::memory_order_release);
+			}
+			page.referenced.store(1, ::std::memory_order_relaxed);
+			page.lock.store(0, ::std::memory_order_release);
+
+			if (newly_resident && (resident_pages.fetch_add(1, ::std::memory_order_relaxed) + 1 > budget_pages.load(::std::memory_order_relaxed)))
+			{
+				evict();
 			}
 		}
 
-		void generate(progress_callback_type callback)
+		// CLOCK replacement: pages read since the hand last passed get a second chance
+		void evict()
 		{
-			uint32_t const n = size / constants::HASH_BYTES;
-			data.reserve(n);
-			for (uint32_t i = 0; i < n; i++)
+			::std::unique_lock<::std::mutex> lock(eviction_mutex, ::std::try_to_lock);
+			if (!lock.owns_lock())
+			{
+				return; // another thread is already making room
+			}
+
+			for (size_type step = 0; (step < (2 * page_count)) && (resident_pages.load(::std::memory_order_relaxed) > budget_pages.load(::std::memory_order_relaxed)); step++)
 			{
-				data.push_back(calc_dataset_item(cache.data(), i));
-				if ((i % constants::CALLBACK_FREQUENCY) == 0 && !callback(i, n, dag_generation))
+				size_type const p = clock_hand;
+				clock_hand = (clock_hand + 1) % page_count;
+
+				page_t & page = pages[p];
+				if (page.resident.load(::std::memory_order_relaxed) == 0)
+				{
+					continue;
+				}
+				if (page.referenced.exchange(0, ::std::memory_order_relaxed) != 0)
+				{
+					continue;
+				}
+				if (release(p))
 				{
-					throw hash_exception("DAG creation cancelled.");
+					resident_pages.fetch_sub(1, ::std::memory_order_relaxed);
+					evictions.fetch_add(1, ::std::memory_order_relaxed);
 				}
 			}
 		}
 
-		static data_type::value_type calc_dataset_item(::std::vector<sha3_512_t::deserialized_hash_t> const & cache, uint32_t const i)
+		bool release(size_type p)
 		{
-			uint32_t const n = cache.size();
-			constexpr uint32_t r = constants::HASH_BYTES / constants::WORD_BYTES;
-			sha3_512_t::deserialized_hash_t mix(cache[i%n]);
-			mix[0].hword ^= i;
-			mix = sha3_512(mix);
-			for (uint32_t j = 0; j < constants::DATASET_PARENTS; j++)
+			page_t & page = pages[p];
+			uint8_t unlocked = 0;
+			if (!page.lock.compare_exchange_strong(unlocked, 1, ::std::memory_order_acquire))
 			{
-				uint32_t const cache_index = fnv(i ^ j, mix[j % r].hword);
-				auto lBeg = cache[cache_index % n].begin();
-				auto lEnd = cache[cache_index % n].end();
-				for (auto k = mix.begin(), kEnd = mix.end();
-					((k != kEnd) && (lBeg != lEnd)); k++, lBeg++)
-				{
-					k->hword = fnv(k->hword, lBeg->hword);
-				}
+				return false;
+			}
 
+			page.sequence.fetch_add(1, ::std::memory_order_relaxed);
+			::std::atomic_thread_fence(::std::memory_order_release);
+			uint32_t const first = static_cast<uint32_t>(p * items_per_page);
+			uint32_t const last = static_cast<uint32_t>((std::min)((p + 1) * items_per_page, size / constants::HASH_BYTES));
+			for (uint32_t i = first; i < last; i++)
+			{
+				present[i / 64].fetch_and(~(uint64_t(1) << (i % 64)), ::std::memory_order_relaxed);
 			}
-			return sha3_512(mix);
+			// private anonymous pages read back as zeroes once released
+			::madvise(reinterpret_cast<uint8_t *>(mapping) + (p * page_size), (std::min)(page_size, size - (p * page_size)), MADV_DONTNEED);
+			page.resident.store(0, ::std::memory_order_relaxed);
+			page.sequence.fetch_add(1, ::std::memory_order_release);
+			page.lock.store(0, ::std::memory_order_release);
+			return true;
 		}
 
-		cache_t get_cache() const
+		void set_budget(size_type budget_bytes)
 		{
-			return cache;
+			budget_pages.store(pages_for(budget_bytes), ::std::memory_order_relaxed);
+			evict();
 		}
 
-		static size_type get_full_size(uint64_t const block_number) noexcept
+		stats_t stats() const
 		{
-			using namespace constants;
-
-			uint64_t full_size = (DATASET_BYTES_INIT + (DATASET_BYTES_GROWTH * (block_number / EPOCH_LENGTH))) - MIX_BYTES;
-			while (!is_prime(full_size / MIX_BYTES))
-			{
-				full_size -= (2 * MIX_BYTES);
-			}
-			return full_size;
+			stats_t ret;
+			ret.hits = hits.load(::std::memory_order_relaxed);
+			ret.misses = misses.load(::std::memory_order_relaxed);
+			ret.evictions = evictions.load(::std::memory_order_relaxed);
+			ret.resident_bytes = resident_pages.load(::std::memory_order_relaxed) * page_size;
+			ret.budget_bytes = budget_pages.load(::std::memory_order_relaxed) * page_size;
+			return ret;
 		}
 
-		uint64_t epoch;
-		size_type size;
-		cache_t cache;
-		data_type data;
+		uint64_t const epoch;
+		size_type const size;
+		cache_t const cache;
+		size_type const page_size;
+		size_type const page_count;
+		uint32_t const items_per_page;
+		void * const mapping;
+		::std::unique_ptr<page_t[]> pages;
+		::std::unique_ptr<::std::atomic<uint64_t>[]> present;
+		::std::atomic<size_type> budget_pages;
+		::std::atomic<size_type> resident_pages;
+		::std::atomic<uint64_t> hits;
+		::std::atomic<uint64_t> misses;
+		::std::atomic<uint64_t> evictions;
+		size_type clock_hand; // guarded by eviction_mutex
+		::std::mutex eviction_mutex;
 	};
 
-	// construct on first use mutex ensures safe static initialization order
-	std::recursive_mutex & get_dag_cache_mutex()
+	lazy_dag_t::lazy_dag_t(uint64_t const block_number, size_type budget_bytes, progress_callback_type callback)
+	: impl(::std::make_shared<impl_t>(block_number, budget_bytes, callback))
 	{
-		static std::recursive_mutex mutex;
-		return mutex;
 	}
-	// ensures single threaded construction
-	std::recursive_mutex & dag_cache_mutex = get_dag_cache_mutex();
 
-	// construct on first use dag_cache_map ensures safe static initialization order
-	dag_t::impl_t::dag_cache_map & get_dag_cache()
+	uint64_t lazy_dag_t::epoch() const
 	{
-		std::lock_guard<std::recursive_mutex> lock(get_dag_cache_mutex());
-		static dag_t::impl_t::dag_cache_map dag_cache;
-		return dag_cache;
+		return impl->epoch;
 	}
-	// ensures single threaded construction
-	dag_t::impl_t::dag_cache_map & dag_cache = get_dag_cache();
 
-	::std::shared_ptr<dag_t::impl_t> get_dag(uint64_t block_number, progress_callback_type callback)
+	lazy_dag_t::size_type lazy_dag_t::size() const
 	{
-		using namespace std;
-		uint64_t epoch_number = block_number / constants::EPOCH_LENGTH;
-
-		// if we have the correct DAG already loaded, return it from the cache
-		{
-			lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
-			auto const dag_cache_iterator = get_dag_cache().find(epoch_number);
-			if (dag_cache_iterator != get_dag_cache().end())
-			{
-				return dag_cache_iterator->second;
-			}
-		}
-
-		// otherwise create the dag and add it to the cache
-		// this is not locked as it can be a lengthy process and we don't want to block access to the dag cache
-		shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(block_number, callback));
+		return impl->size;
+	}
 
-		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
-		auto insert_pair = get_dag_cache().insert(make_pair(epoch_number, impl));
+	cache_t lazy_dag_t::get_cache() const
+	{
+		return impl->cache;
+	}
 
-		// if insert succeded, return the dag
-		if (insert_pair.second)
-		{
-			return insert_pair.first->second;
-		}
+	void lazy_dag_t::dataset_item(uint32_t index, node * out) const
+	{
+		impl->item(index, out);
+	}
 
-		// if insert failed, it's probably already been inserted
-		auto const dag_cache_iterator = get_dag_cache().find(epoch_number);
-		if (dag_cache_iterator != get_dag_cache().end())
-		{
-			return dag_cache_iterator->second;
-		}
+	void lazy_dag_t::set_budget(size_type budget_bytes) const
+	{
+		impl->set_budget(budget_bytes);
+	}
 
-		// we couldn't insert it and it's not in the cache
-		throw hash_exception("Could not get DAG");
+	lazy_dag_t::stats_t lazy_dag_t::get_stats() const
+	{
+		return impl->stats();
 	}
 
-	::std::shared_ptr<dag_t::impl_t> get_dag(::std::string const & file_path, progress_callback_type callback)
+	// the DAG is built by a background task, which publishes it as soon as its cache is available
+	std::mutex & get_throttle_policy_mutex()
 	{
-		using namespace std;
-		using size_type = dag_t::size_type;
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	throttle_policy_t & get_throttle_policy_instance()
+	{
+		static throttle_policy_t policy = { throttle_none, 0, 0, 0 };
+		return policy;
+	}
 
-		ifstream fs;
-		fs.open(file_path, ios::in | ios::binary);
+	void progressive_dag_t::set_throttle_policy(throttle_policy_t const & policy)
+	{
+		std::lock_guard<std::mutex> lock(get_throttle_policy_mutex());
+		get_throttle_policy_instance() = policy;
+	}
 
-		if (fs.fail())
-		{
-			throw hash_exception("Could not open DAG file.");
-		}
+	throttle_policy_t progressive_dag_t::get_throttle_policy()
+	{
+		std::lock_guard<std::mutex> lock(get_throttle_policy_mutex());
+		return get_throttle_policy_instance();
+	}
 
-		fs.seekg(0, ios::end);
-		dag_t::size_type const filesize = static_cast<dag_t::size_type>(fs.tellg());
-		fs.seekg(0, ios::beg);
+	struct progressive_dag_t::impl_t
+	{
+		// the DAG being built and a copy of its cache, which is not replaced when the DAG registers its cache
+		struct snapshot_t
+		{
+			::std::shared_ptr<dag_t::impl_t> dag;
+			::std::shared_ptr<cache_t const> cache;
+		};
 
-		// check minimum dag size
-		if (filesize < constants::DAG_FILE_MINIMUM_SIZE)
+		explicit impl_t(progress_callback_type callback)
+		: mutex()
+		, cv()
+		, snapshot()
+		, done(false)
+		, error()
+		, token()
+		, callback(callback)
+		, task(::std::make_shared<task_t>())
+		, throttle(progressive_dag_t::get_throttle_policy(), token)
 		{
-			throw hash_exception("DAG is corrupt");
 		}
 
-		// data for 64MiB reads
-		// 64MiB was chosen as it is divisible by the constants::CACHE_BYTES_GROWTH and the constants::DATASET_BYTES_GROWTH
-		vector<char> read_buffer(64 * 1024 * 1024, 0);
-		auto buffer_ptr = &read_buffer[0];
-		auto buffer_ptr_end = &read_buffer.back() + 1;
-		// prime the buffer
-		fs.read(buffer_ptr, read_buffer.size());
-		if (fs.fail() && !fs.eof())
+		// a build which has not started yet never will, a running one is waited for
+		~impl_t()
 		{
-			throw hash_exception("Read failure");
+			token.cancel();
+			::std::unique_lock<::std::mutex> lock(task->mutex);
+			task->owner = nullptr;
+			task->cv.wait(lock, [this]() { return !task->running; });
 		}
 
-		// TODO: this func needs to be made endian safe
-		auto read = [&fs, &read_buffer, &buffer_ptr, &buffer_ptr_end](void * dst, size_type count)
+		// the DAG is built as a background task of the pool, so it yields to foreground hashing and verification
+		void start(::std::function<void (progress_callback_type)> build, thread_pool_t const & pool)
 		{
-			// full buffer consumed exactly
-			if ((buffer_ptr_end - buffer_ptr) == 1)
+			task->owner = this;
+			::std::shared_ptr<task_t> const shared_task = task;
+			pool.submit([shared_task, build]()
 			{
-				fs.read(&read_buffer[0], read_buffer.size());
-				if (fs.fail() && !fs.eof())
+				impl_t * owner = nullptr;
 				{
-					throw hash_exception("Read failure");
+					::std::lock_guard<::std::mutex> lock(shared_task->mutex);
+					owner = shared_task->owner;
+					shared_task->running = (owner != nullptr);
 				}
-				buffer_ptr = &read_buffer[0];
-			}
-
-			// need to consume part of the buffer and then read more
-			if (count > static_cast<size_type>(buffer_ptr_end - buffer_ptr))
-			{
-				//::std::cout << ::std::endl << "hit boundary, asked for " << count << " bytes but " << buffer_ptr_end - buffer_ptr << " remaining in buffer." << ::std::endl;
-				::std::memcpy(dst, buffer_ptr, buffer_ptr_end - buffer_ptr);
-				count -= (buffer_ptr_end - buffer_ptr);
-				dst = reinterpret_cast<char*>(dst) + (buffer_ptr_end - buffer_ptr);
-
-				fs.read(&read_buffer[0], read_buffer.size());
-				if (fs.fail() && !fs.eof())
+				if (owner == nullptr)
 				{
-					throw hash_exception("Read failure");
+					return;
 				}
-				buffer_ptr = &read_buffer[0];
-			}
 
-			// copy from the buffer
-			::std::memcpy(dst, buffer_ptr, count);
-			buffer_ptr += count;
-		};
+				progress_callback_type const progress = [owner](size_type step, size_type max, progress_callback_phase phase)
+				{
+					return !owner->token.is_cancelled() && owner->callback(step, max, phase);
+				};
+				try
+				{
+					build(progress);
+				}
+				catch (...)
+				{
+					owner->finish(nullptr, ::std::current_exception());
+				}
 
-		dag_file_header_t header(read);
+				// notified under the lock, as the DAG may be destroyed as soon as running is cleared
+				::std::lock_guard<::std::mutex> lock(shared_task->mutex);
+				shared_task->running = false;
+				shared_task->cv.notify_all();
+			}, priority_background);
+		}
 
-		if ((header.cache_end >= filesize) || (header.dag_end > (filesize + 1)))
+		void generate(uint64_t block_number, progress_callback_type progress)
 		{
-			throw hash_exception("DAG is corrupt");
+			::std::shared_ptr<dag_t::impl_t> impl = find_dag(block_number / constants::EPOCH_LENGTH);
+			if (!impl)
+			{
+				impl.reset(new dag_t::impl_t(block_number, progress, dag_t::impl_t::deferred_t()));
+				publish(impl);
+				throttle.begin();
+				impl->generate(progress, &throttle);
+			}
+			finish(add_to_dag_cache(impl), nullptr);
 		}
 
-		// if we have the correct DAG already loaded, return it from the cache
+		void load(::std::string const & file_path, progress_callback_type progress)
 		{
-			lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
-			auto const dag_cache_iterator = get_dag_cache().find(header.epoch);
-			if (dag_cache_iterator != get_dag_cache().end())
+			fd_source source(file_path);
+			dag_file_header_t header = read_dag_header(source);
+			::std::shared_ptr<dag_t::impl_t> impl = find_dag(header.epoch);
+			if (!impl)
 			{
-				return dag_cache_iterator->second;
+				impl.reset(new dag_t::impl_t(source, header, progress, dag_t::impl_t::deferred_t()));
+				publish(impl);
+				impl->load_items(source, progress);
+				try
+				{
+					check_verify_policy(*impl, progress);
+				}
+				catch (...)
+				{
+					// stop reading items which may be corrupt, hashes carry on from the cache
+					impl->ready.store(0, ::std::memory_order_release);
+					throw;
+				}
+				impl->register_cache();
 			}
+			finish(add_to_dag_cache(impl), nullptr);
 		}
 
-		// otherwise create the dag and add it to the cache
-		// this is not locked as it can be a lengthy process and we don't want to block access to the dag cache
-		shared_ptr<dag_t::impl_t> impl(new dag_t::impl_t(read, header, callback));
-
-		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
-		auto insert_pair = get_dag_cache().insert(make_pair(header.epoch, impl));
+		void publish(::std::shared_ptr<dag_t::impl_t> const & impl)
+		{
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				snapshot.dag = impl;
+				snapshot.cache = ::std::make_shared<cache_t const>(impl->get_cache());
+			}
+			cv.notify_all();
+		}
 
-		// if insert succeded, return the dag
-		if (insert_pair.second)
+		void finish(::std::shared_ptr<dag_t::impl_t> const & impl, ::std::exception_ptr const & e)
 		{
-			return insert_pair.first->second;
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				if (impl && (snapshot.dag != impl))
+				{
+					snapshot.dag = impl;
+					snapshot.cache = ::std::make_shared<cache_t const>(impl->get_cache());
+				}
+				error = e;
+				done = true;
+			}
+			cv.notify_all();
 		}
 
-		// if insert failed, it's probably already been inserted
-		auto const dag_cache_iterator = get_dag_cache().find(header.epoch);
-		if (dag_cache_iterator != get_dag_cache().end())
+		snapshot_t wait_for_cache()
 		{
-			return dag_cache_iterator->second;
+			::std::unique_lock<::std::mutex> lock(mutex);
+			cv.wait(lock, [this]() { return snapshot.dag || done; });
+			if (!snapshot.dag)
+			{
+				::std::rethrow_exception(error);
+			}
+			return snapshot;
 		}
 
-		// we couldn't insert it and it's not in the cache
-		throw hash_exception("Could not get DAG");
-	}
+		// shared with the task building the DAG, which may still be queued on the pool when the DAG is destroyed
+		struct task_t
+		{
+			::std::mutex mutex;
+			::std::condition_variable cv;
+			impl_t * owner = nullptr;
+			bool running = false;
+		};
 
-	dag_t::dag_t(uint64_t block_number, progress_callback_type callback)
-	: impl(get_dag(block_number, callback))
-	{
-	}
+		::std::mutex mutex;
+		::std::condition_variable cv;
+		snapshot_t snapshot;
+		bool done;
+		::std::exception_ptr error;
+		cancel_token_t const token;
+		progress_callback_type const callback;
+		::std::shared_ptr<task_t> const task;
+		generation_throttle_t throttle;
+	};
 
-	dag_t::dag_t(::std::string const & file_path, progress_callback_type callback)
-	: impl(get_dag(file_path, callback))
+	progressive_dag_t::progressive_dag_t(uint64_t const block_number, progress_callback_type callback, thread_pool_t const & pool)
+	: impl(::std::make_shared<impl_t>(callback))
 	{
-
+		impl_t * const p = impl.get();
+		impl->start([p, block_number](progress_callback_type progress) { p->generate(block_number, progress); }, pool);
 	}
 
-	uint64_t dag_t::epoch() const
+	progressive_dag_t::progressive_dag_t(::std::string const & file_path, progress_callback_type callback, thread_pool_t const & pool)
+	: impl(::std::make_shared<impl_t>(callback))
 	{
-		return impl->epoch;
+		impl_t * const p = impl.get();
+		impl->start([p, file_path](progress_callback_type progress) { p->load(file_path, progress); }, pool);
 	}
 
-	dag_t::size_type dag_t::size() const
+	uint64_t progressive_dag_t::epoch() const
 	{
-		return impl->size;
+		return impl->wait_for_cache().dag->epoch;
 	}
 
-	dag_t::data_type const & dag_t::data() const
+	cache_t progressive_dag_t::get_cache() const
 	{
-		return impl->data;
+		return *impl->wait_for_cache().cache;
 	}
 
-	void dag_t::save(::std::string const & file_path, progress_callback_type callback) const
+	uint32_t progressive_dag_t::ready_items() const
 	{
-		impl->save(file_path, callback);
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		return impl->snapshot.dag ? impl->snapshot.dag->ready_items() : 0;
 	}
 
-	cache_t dag_t::get_cache() const
+	bool progressive_dag_t::is_ready() const
 	{
-		return impl->get_cache();
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		return impl->done && !impl->error;
 	}
 
-	void dag_t::unload() const
+	dag_t progressive_dag_t::wait() const
 	{
-		auto const i = get_dag_cache().erase(epoch());
-		if (i == 0)
+		::std::unique_lock<::std::mutex> lock(impl->mutex);
+		impl->cv.wait(lock, [this]() { return impl->done; });
+		if (impl->error)
 		{
-			throw hash_exception("Can not unload DAG - not loaded.");
+			::std::rethrow_exception(impl->error);
 		}
-		get_cache().unload();
-	}
-
-	dag_t::size_type dag_t::get_full_size(uint64_t const block_number) noexcept
-	{
-		return impl_t::get_full_size(block_number);
-	}
-
-	bool dag_t::is_loaded(uint64_t const epoch)
-	{
-		using namespace std;
-		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
-		auto const & dag_cache = get_dag_cache();
-		return (dag_cache.find(epoch) != dag_cache.end());
+		return dag_t(impl->snapshot.dag);
 	}
 
-	::std::vector<uint64_t> dag_t::get_loaded()
+	throttle_stats_t progressive_dag_t::throttle_stats() const
 	{
-		using namespace std;
-		lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
-		auto const & dag_cache = get_dag_cache();
-		::std::vector<uint64_t> loaded_epochs;
-		loaded_epochs.reserve(dag_cache.size());
-		for (auto const & i : dag_cache)
-		{
-			loaded_epochs.push_back(i.first);
-		}
-		return loaded_epochs;
+		return impl->throttle.stats();
 	}
 
 // TODO: reference code, remove me
@@ -1136,52 +4131,131 @@ namespace egihash
 	}
 #endif // 0
 
-	// TODO: unify light & full implementation
 	namespace hashimoto
 	{
-		using mediator_get_dag_size = std::function<dag_t::size_type ()>;
-		using mediator_get_dag_item = std::function<std::vector<node> const (uint32_t index)>;
+		static constexpr uint32_t MIX_WORDS = constants::MIX_BYTES / constants::WORD_BYTES;
+		static constexpr uint32_t MIX_NODES = constants::MIX_BYTES / constants::HASH_BYTES;
+
+		// the state of one hashimoto computation, kept separately so that several can be interleaved
+		struct lane_t
+		{
+			void init(void const * input_data, size_t input_size)
+			{
+				sha3_512_item(s(), input_data, input_size);
+				for (uint32_t i = 0; i < MIX_NODES; i++)
+				{
+					::std::memcpy(mix + (i * constants::HASH_WORDS), s(), constants::HASH_BYTES);
+				}
+			}
+
+			// index of the first DAG item of the page read by access i
+			uint32_t page_item(uint32_t i, fast_divisor_t const & full_page_count) const
+			{
+				return full_page_count.mod(fnv(i ^ combined[0].hword, mix[i % MIX_WORDS].hword)) * MIX_NODES;
+			}
 
-		result_t hash(void const * input_data, dag_t::size_type input_size, mediator_get_dag_size get_dag_size, mediator_get_dag_item get_dag_item)
+			void mix_item(uint32_t j, node const * item)
+			{
+				node * m = mix + (j * constants::HASH_WORDS);
+				for (uint32_t k = 0; k < constants::HASH_WORDS; k++)
+				{
+					m[k].hword = fnv(m[k].hword, item[k].hword);
+				}
+			}
+
+			result_t finish()
+			{
+				node * const cmix = combined + constants::HASH_WORDS;
+				for (uint32_t i = 0; i < MIX_WORDS; i += 4)
+				{
+					cmix[i / 4] = node(fnv(fnv(fnv(mix[i].hword, mix[i+1].hword), mix[i+2].hword), mix[i+3].hword));
+				}
+
+				result_t out;
+				if (::sha3_256(&out.value.b[0], out.value.hash_size, reinterpret_cast<uint8_t const *>(combined), sizeof(combined)) != 0)
+				{
+					throw hash_exception("Keccak-256 computation failed.");
+				}
+				::std::memcpy(&out.mixhash.b[0], cmix, out.mixhash.hash_size);
+				return out;
+			}
+
+			node * s()
+			{
+				return combined;
+			}
+
+			// s followed by the compressed mix is hashed to produce the result
+			node combined[constants::HASH_WORDS + (MIX_WORDS / 4)];
+			node mix[MIX_WORDS];
+		};
+
+		// the result value implied by a claimed mixhash, without reading the DAG
+		inline h256_t value_from_mixhash(void const * input_data, size_t input_size, h256_t const & mixhash)
+		{
+			lane_t lane;
+			sha3_512_item(lane.s(), input_data, input_size);
+			::std::memcpy(lane.combined + constants::HASH_WORDS, mixhash.b, mixhash.hash_size);
+
+			h256_t value;
+			if (::sha3_256(&value.b[0], value.hash_size, reinterpret_cast<uint8_t const *>(lane.combined), sizeof(lane.combined)) != 0)
+			{
+				throw hash_exception("Keccak-256 computation failed.");
+			}
+			return value;
+		}
+
+		// get_dag_item(index, scratch) returns a pointer to DAG item index, which it may compute into scratch
+		// full_page_count is the number of constants::MIX_BYTES pages in the DAG
+		template <typename LookupFunc>
+		result_t hash(void const * input_data, dag_t::size_type input_size, fast_divisor_t const & full_page_count, LookupFunc get_dag_item)
 		{
-			static constexpr auto w = constants::MIX_BYTES / constants::WORD_BYTES;
-			auto MIXNODES = (constants::MIX_BYTES / constants::HASH_BYTES);
+			lane_t lane;
+			lane.init(input_data, input_size);
 
-			auto s = sha3_512(std::string(static_cast<const char*>(input_data), input_size));
-			decltype(s) mix;
-			for (uint32_t i = 0; i < MIXNODES; i++)
+			node scratch[constants::HASH_WORDS];
+			for (uint32_t i = 0; i < constants::ACCESSES; i++)
+			{
+				uint32_t const item = lane.page_item(i, full_page_count);
+				for (uint32_t j = 0; j < MIX_NODES; j++)
+				{
+					lane.mix_item(j, get_dag_item(item + j, scratch));
+				}
+			}
+			return lane.finish();
+		}
+
+		// computes the hashes of several header hash and nonce pairs in lockstep
+		// every lane's page is prefetched before any lane is mixed, so the DAG reads of all lanes overlap
+		inline void hash_lanes(data_view_t const & data, fast_divisor_t const & full_page_count, header_nonce_bytes const * inputs, size_t lane_count, result_t * results)
+		{
+			lane_t lanes[constants::HASH_BATCH_LANES];
+			uint32_t items[constants::HASH_BATCH_LANES];
+			for (size_t l = 0; l < lane_count; l++)
 			{
-				mix.insert(mix.end(), s.begin(), s.end());
+				lanes[l].init(inputs[l], sizeof(inputs[l]));
 			}
 
-			uint32_t const full_page_count = (uint32_t) ( get_dag_size() / constants::MIX_BYTES );
 			for (uint32_t i = 0; i < constants::ACCESSES; i++)
 			{
-				auto p = fnv(i ^ s[0].hword, mix[i % w].hword) % full_page_count;
-				for (uint32_t j = 0; j < MIXNODES; j++)
+				for (size_t l = 0; l < lane_count; l++)
 				{
-					auto h = get_dag_item(p * MIXNODES + j);
-					auto k = h.begin(), kEnd = h.end();
-					for (auto m = mix.begin() + j * w / 2, mEnd = mix.begin() + ( j + 1 ) * w / 2; m != mEnd && k != kEnd; m++, k++)
+					items[l] = lanes[l].page_item(i, full_page_count);
+					prefetch(data[items[l]], constants::MIX_BYTES);
+				}
+				for (size_t l = 0; l < lane_count; l++)
+				{
+					for (uint32_t j = 0; j < MIX_NODES; j++)
 					{
-						m->hword = fnv(m->hword, k->hword);
+						lanes[l].mix_item(j, data[items[l] + j]);
 					}
 				}
 			}
 
-			decltype(s) cmix;
-			for (uint32_t i = 0; i < mix.size(); i += 4)
+			for (size_t l = 0; l < lane_count; l++)
 			{
-				cmix.push_back(node(fnv(fnv(fnv(mix[i].hword, mix[i+1].hword), mix[i+2].hword), mix[i+3].hword)));
+				results[l] = lanes[l].finish();
 			}
-
-			auto combined = std::move(s);
-			combined.insert(combined.end(), cmix.begin(), cmix.end());
-			auto v = sha3_256(combined);
-			result_t out;
-			::std::memcpy(&out.value.b[0], &v[0], ::std::min(sizeof(out.value.b), v.size() * sizeof(node)));
-			::std::memcpy(&out.mixhash.b[0], &cmix[0], ::std::min(sizeof(out.mixhash.b), cmix.size() * sizeof(node)));
-			return out;
 		}
 	}
 	namespace full
@@ -1190,14 +4264,69 @@ namespace egihash
 
 		result_t hash(dag_t const & dag, void const * input_data, dag_t::size_type input_size)
 		{
-			return hashimoto::hash(input_data, input_size
-					, [&]() -> dag_t::size_type { return dag.size(); }
-					, [&](uint32_t index) -> std::vector<node> const { return dag.data()[index]; });
+			count_foreground_hashes(1);
+			auto const data = dag.data();
+			return hashimoto::hash(input_data, input_size, dag.impl->page_divisor
+					, [&](uint32_t index, node *) -> node const * { return data[index]; });
 		}
 		result_t hash(dag_t const & dag, h256_t const & header_hash, uint64_t const nonce)
 		{
 			std::function<result_t (dag_t const &, void const *, dag_t::size_type)> hash_func = static_cast<result_t (*)(dag_t const &, void const *, dag_t::size_type)>(&hash);
-			return hash_header_nonce(hash_func, dag, header_hash, nonce);
+			return cached_hash(dag.epoch(), header_hash, nonce, [&]() { return hash_header_nonce(hash_func, dag, header_hash, nonce); });
+		}
+
+		void hash_batch(dag_t const & dag, h256_t const & header_hash, uint64_t const * nonces, ::std::size_t count, result_t * results)
+		{
+			count_foreground_hashes(count);
+			auto const data = dag.data();
+			fast_divisor_t const & full_page_count = dag.impl->page_divisor;
+			for (size_t first = 0; first < count; first += constants::HASH_BATCH_LANES)
+			{
+				size_t const lane_count = (std::min)(count - first, static_cast<size_t>(constants::HASH_BATCH_LANES));
+				header_nonce_bytes inputs[constants::HASH_BATCH_LANES];
+				for (size_t l = 0; l < lane_count; l++)
+				{
+					combine_header_nonce(header_hash, nonces[first + l], inputs[l]);
+				}
+				hashimoto::hash_lanes(data, full_page_count, inputs, lane_count, results + first);
+			}
+		}
+
+		result_t hash(lazy_dag_t const & dag, void const * input_data, lazy_dag_t::size_type input_size)
+		{
+			lazy_dag_t::impl_t & impl = *dag.impl;
+			return hashimoto::hash(input_data, input_size, dag_t::impl_t::get_cache_impl(impl.cache).page_divisor
+					, [&](uint32_t index, node * scratch) -> node const * { impl.item(index, scratch); return scratch; });
+		}
+
+		result_t hash(lazy_dag_t const & dag, h256_t const & header_hash, uint64_t const nonce)
+		{
+			std::function<result_t (lazy_dag_t const &, void const *, lazy_dag_t::size_type)> hash_func = static_cast<result_t (*)(lazy_dag_t const &, void const *, lazy_dag_t::size_type)>(&hash);
+			return cached_hash(dag.epoch(), header_hash, nonce, [&]() { return hash_header_nonce(hash_func, dag, header_hash, nonce); });
+		}
+
+		result_t hash(progressive_dag_t const & dag, void const * input_data, progressive_dag_t::size_type input_size)
+		{
+			auto const snapshot = dag.impl->wait_for_cache();
+			dag_t::impl_t const & impl = *snapshot.dag;
+			cache_t::impl_t const & cache_impl = dag_t::impl_t::get_cache_impl(*snapshot.cache);
+			auto const cache_data = cache_impl.view();
+			return hashimoto::hash(input_data, input_size, impl.page_divisor
+					, [&](uint32_t index, node * scratch) -> node const *
+					{
+						if (index < impl.ready_items())
+						{
+							return impl.item(index);
+						}
+						dag_t::impl_t::calc_dataset_item(cache_data, cache_impl.item_divisor, index, scratch);
+						return scratch;
+					});
+		}
+
+		result_t hash(progressive_dag_t const & dag, h256_t const & header_hash, uint64_t const nonce)
+		{
+			std::function<result_t (progressive_dag_t const &, void const *, progressive_dag_t::size_type)> hash_func = static_cast<result_t (*)(progressive_dag_t const &, void const *, progressive_dag_t::size_type)>(&hash);
+			return cached_hash(dag.epoch(), header_hash, nonce, [&]() { return hash_header_nonce(hash_func, dag, header_hash, nonce); });
 		}
 	}
 
@@ -1205,16 +4334,193 @@ namespace egihash
 	{
 		result_t hash(cache_t const & cache, void const * input_data, cache_t::size_type input_size)
 		{
-			return hashimoto::hash(input_data, input_size
-					, [&]() -> dag_t::size_type { return dag_t::get_full_size((cache.epoch() * constants::EPOCH_LENGTH)); }
-					, [&](uint32_t index) -> std::vector<node> const { return dag_t::impl_t::calc_dataset_item(cache.data(), index); });
+			// the item cache is looked up once per hash, so resizing it does not affect hashes in progress
+			cache_t::impl_t const & impl = dag_t::impl_t::get_cache_impl(cache);
+			auto const items = impl.get_item_cache();
+			return hashimoto::hash(input_data, input_size, impl.page_divisor
+					, [&](uint32_t index, node * scratch) -> node const * { impl.dataset_item(items.get(), index, scratch); return scratch; });
 		}
 
 		result_t hash(cache_t const & cache, h256_t const & header_hash, uint64_t const nonce)
 		{
 			std::function<result_t (cache_t const &, void const *, cache_t::size_type)> hash_func = static_cast<result_t (*)(cache_t const &, void const *, cache_t::size_type)>(&hash);
-			return hash_header_nonce(hash_func, cache, header_hash, nonce);
+			return cached_hash(cache.epoch(), header_hash, nonce, [&]() { return hash_header_nonce(hash_func, cache, header_hash, nonce); });
+		}
+	}
+
+	bool quick_check(h256_t const & header_hash, uint64_t const nonce, h256_t const & mixhash, h256_t const & boundary)
+	{
+		header_nonce_bytes bytes;
+		combine_header_nonce(header_hash, nonce, bytes);
+		return meets_boundary(hashimoto::value_from_mixhash(bytes, sizeof(bytes), mixhash), boundary);
+	}
+
+	::std::vector<verification_t> verify_batch(submission_t const * submissions, ::std::size_t count, unsigned threads, thread_pool_t const & pool)
+	{
+		using namespace std;
+
+		// submissions of one epoch share a DAG or cache, looked up once
+		struct group_t
+		{
+			shared_ptr<dag_t::impl_t> dag;
+			shared_ptr<cache_t::impl_t> cache;
+		};
+
+		// a task is up to constants::HASH_BATCH_LANES submissions of the same epoch
+		struct task_t
+		{
+			size_t group;
+			size_t begin;
+			size_t end;
+		};
+
+		vector<size_t> order(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			order[i] = i;
+		}
+		stable_sort(order.begin(), order.end(), [submissions](size_t a, size_t b)
+		{
+			return (submissions[a].block_number / constants::EPOCH_LENGTH) < (submissions[b].block_number / constants::EPOCH_LENGTH);
+		});
+
+		vector<group_t> groups;
+		vector<task_t> tasks;
+		for (size_t begin = 0; begin < count; )
+		{
+			uint64_t const block_number = submissions[order[begin]].block_number;
+			uint64_t const epoch = block_number / constants::EPOCH_LENGTH;
+			size_t end = begin;
+			while ((end < count) && ((submissions[order[end]].block_number / constants::EPOCH_LENGTH) == epoch))
+			{
+				end++;
+			}
+
+			group_t group;
+			{
+				lock_guard<recursive_mutex> lock(get_dag_cache_mutex());
+				auto const dag_cache_iterator = get_dag_cache().find(epoch);
+				if (dag_cache_iterator != get_dag_cache().end())
+				{
+					group.dag = dag_cache_iterator->second;
+				}
+			}
+			if (!group.dag)
+			{
+				group.cache = get_cache_from_cache(block_number, [](size_t, size_t, int){ return true; });
+			}
+			groups.push_back(group);
+
+			for (size_t first = begin; first < end; first += constants::HASH_BATCH_LANES)
+			{
+				tasks.push_back(task_t{groups.size() - 1, first, (std::min)(end, first + constants::HASH_BATCH_LANES)});
+			}
+			begin = end;
+		}
+
+		vector<verification_t> verifications(count);
+		auto const results = atomic_load(&get_result_cache());
+		auto verify = [&](task_t const & task)
+		{
+			group_t const & group = groups[task.group];
+			header_nonce_bytes inputs[constants::HASH_BATCH_LANES];
+			result_t lane_results[constants::HASH_BATCH_LANES];
+			size_t indices[constants::HASH_BATCH_LANES];
+			size_t lane_count = 0;
+			for (size_t i = task.begin; i < task.end; i++)
+			{
+				size_t const index = order[i];
+				submission_t const & submission = submissions[index];
+				combine_header_nonce(submission.header_hash, submission.nonce, inputs[lane_count]);
+
+				// submissions whose claimed mixhash can not meet the boundary are rejected without reading the dataset
+				h256_t const value = hashimoto::value_from_mixhash(inputs[lane_count], sizeof(inputs[lane_count]), submission.mixhash);
+				if (!meets_boundary(value, submission.boundary))
+				{
+					verifications[index].valid = false;
+					verifications[index].computed = false;
+					verifications[index].result.value = value;
+					verifications[index].result.mixhash = submission.mixhash;
+					continue;
+				}
+
+				// as are resubmissions whose hash is in the result cache
+				if (results && results->lookup(submission.block_number / constants::EPOCH_LENGTH, submission.header_hash, submission.nonce, verifications[index].result))
+				{
+					verifications[index].valid = (verifications[index].result.mixhash == submission.mixhash) && meets_boundary(verifications[index].result.value, submission.boundary);
+					verifications[index].computed = true;
+					continue;
+				}
+				indices[lane_count++] = index;
+			}
+
+			if (group.dag)
+			{
+				hashimoto::hash_lanes(group.dag->view(), group.dag->page_divisor, inputs, lane_count, lane_results);
+			}
+			else
+			{
+				auto const items = group.cache->get_item_cache();
+				for (size_t l = 0; l < lane_count; l++)
+				{
+					lane_results[l] = hashimoto::hash(inputs[l], sizeof(inputs[l]), group.cache->page_divisor
+							, [&](uint32_t index, node * scratch) -> node const * { group.cache->dataset_item(items.get(), index, scratch); return scratch; });
+				}
+			}
+
+			for (size_t l = 0; l < lane_count; l++)
+			{
+				size_t const index = indices[l];
+				submission_t const & submission = submissions[index];
+				verifications[index].result = lane_results[l];
+				verifications[index].computed = true;
+				verifications[index].valid = (lane_results[l].mixhash == submission.mixhash) && meets_boundary(lane_results[l].value, submission.boundary);
+				if (results)
+				{
+					results->store(submission.block_number / constants::EPOCH_LENGTH, submission.header_hash, submission.nonce, lane_results[l]);
+				}
+			}
+		};
+
+		// fan the tasks out across the pool, the first exception is rethrown once all workers have finished
+		size_t const thread_count = (std::min)(tasks.size(), static_cast<size_t>((threads != 0) ? threads : pool.size()));
+		atomic<size_t> next_task(0);
+		pool.parallel_for(thread_count, [&](size_t)
+		{
+			try
+			{
+				for (size_t i = next_task++; i < tasks.size(); i = next_task++)
+				{
+					verify(tasks[i]);
+				}
+			}
+			catch (...)
+			{
+				next_task = tasks.size();
+				throw;
+			}
+		});
+		return verifications;
+	}
+
+	void set_result_cache_size(::std::size_t capacity)
+	{
+		::std::shared_ptr<result_cache_t> results;
+		if (capacity != 0)
+		{
+			results = ::std::make_shared<result_cache_t>(capacity);
+		}
+		::std::atomic_store(&get_result_cache(), results);
+	}
+
+	result_cache_stats_t get_result_cache_stats()
+	{
+		auto const results = ::std::atomic_load(&get_result_cache());
+		if (!results)
+		{
+			return result_cache_stats_t{0, 0, 0, 0};
 		}
+		return results->stats();
 	}
 
 	bool test_function_()
@@ -0,0 +1,1047 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <stdint.h>
+
+// sizes in bytes of the cache and DAG of each of the first EPOCH_SIZE_TABLE_LENGTH epochs
+// each is the nominal size of its epoch stepped down until the number of items (cache) or pages (DAG) is prime,
+// see cache_t::get_cache_size() and dag_t::get_full_size() which fall back to computing them beyond the table
+namespace egihash
+{
+	static constexpr uint64_t EPOCH_SIZE_TABLE_LENGTH = 2048;
+
+	static constexpr uint64_t cache_sizes[EPOCH_SIZE_TABLE_LENGTH] =
+	{
+		16776896u, 16907456u, 17039296u, 17170112u,
+		17301056u, 17432512u, 17563072u, 17693888u,
+		17824192u, 17955904u, 18087488u, 18218176u,
+		18349504u, 18481088u, 18611392u, 18742336u,
+		18874304u, 19004224u, 19135936u, 19267264u,
+		19398208u, 19529408u, 19660096u, 19791424u,
+		19922752u, 20053952u, 20184896u, 20315968u,
+		20446912u, 20576576u, 20709184u, 20840384u,
+		20971072u, 21102272u, 21233216u, 21364544u,
+		21494848u, 21626816u, 21757376u, 21887552u,
+		22019392u, 22151104u, 22281536u, 22412224u,
+		22543936u, 22675264u, 22806464u, 22935872u,
+		23068096u, 23198272u, 23330752u, 23459008u,
+		23592512u, 23723968u, 23854912u, 23986112u,
+		24116672u, 24247616u, 24378688u, 24509504u,
+		24640832u, 24772544u, 24903488u, 25034432u,
+		25165376u, 25296704u, 25427392u, 25558592u,
+		25690048u, 25820096u, 25951936u, 26081728u,
+		26214208u, 26345024u, 26476096u, 26606656u,
+		26737472u, 26869184u, 26998208u, 27131584u,
+		27262528u, 27393728u, 27523904u, 27655744u,
+		27786688u, 27917888u, 28049344u, 28179904u,
+		28311488u, 28441792u, 28573504u, 28700864u,
+		28835648u, 28966208u, 29096768u, 29228608u,
+		29359808u, 29490752u, 29621824u, 29752256u,
+		29882816u, 30014912u, 30144448u, 30273728u,
+		30406976u, 30538432u, 30670784u, 30799936u,
+		30932672u, 31063744u, 31195072u, 31325248u,
+		31456192u, 31588288u, 31719232u, 31850432u,
+		31981504u, 32110784u, 32243392u, 32372672u,
+		32505664u, 32636608u, 32767808u, 32897344u,
+		33029824u, 33160768u, 33289664u, 33423296u,
+		33554368u, 33683648u, 33816512u, 33947456u,
+		34076992u, 34208704u, 34340032u, 34471744u,
+		34600256u, 34734016u, 34864576u, 34993984u,
+		35127104u, 35258176u, 35386688u, 35518528u,
+		35650624u, 35782336u, 35910976u, 36044608u,
+		36175808u, 36305728u, 36436672u, 36568384u,
+		36699968u, 36830656u, 36961984u, 37093312u,
+		37223488u, 37355072u, 37486528u, 37617472u,
+		37747904u, 37879232u, 38009792u, 38141888u,
+		38272448u, 38403392u, 38535104u, 38660672u,
+		38795584u, 38925632u, 39059264u, 39190336u,
+		39320768u, 39452096u, 39581632u, 39713984u,
+		39844928u, 39974848u, 40107968u, 40238144u,
+		40367168u, 40500032u, 40631744u, 40762816u,
+		40894144u, 41023552u, 41155904u, 41286208u,
+		41418304u, 41547712u, 41680448u, 41811904u,
+		41942848u, 42073792u, 42204992u, 42334912u,
+		42467008u, 42597824u, 42729152u, 42860096u,
+		42991552u, 43122368u, 43253696u, 43382848u,
+		43515712u, 43646912u, 43777088u, 43907648u,
+		44039104u, 44170432u, 44302144u, 44433344u,
+		44564288u, 44694976u, 44825152u, 44956864u,
+		45088448u, 45219008u, 45350464u, 45481024u,
+		45612608u, 45744064u, 45874496u, 46006208u,
+		46136768u, 46267712u, 46399424u, 46529344u,
+		46660672u, 46791488u, 46923328u, 47053504u,
+		47185856u, 47316928u, 47447872u, 47579072u,
+		47710144u, 47839936u, 47971648u, 48103232u,
+		48234176u, 48365248u, 48496192u, 48627136u,
+		48757312u, 48889664u, 49020736u, 49149248u,
+		49283008u, 49413824u, 49545152u, 49675712u,
+		49807168u, 49938368u, 50069056u, 50200256u,
+		50331584u, 50462656u, 50593472u, 50724032u,
+		50853952u, 50986048u, 51117632u, 51248576u,
+		51379904u, 51510848u, 51641792u, 51773248u,
+		51903296u, 52035136u, 52164032u, 52297664u,
+		52427968u, 52557376u, 52690112u, 52821952u,
+		52952896u, 53081536u, 53213504u, 53344576u,
+		53475776u, 53608384u, 53738816u, 53870528u,
+		54000832u, 54131776u, 54263744u, 54394688u,
+		54525248u, 54655936u, 54787904u, 54918592u,
+		55049152u, 55181248u, 55312064u, 55442752u,
+		55574336u, 55705024u, 55836224u, 55967168u,
+		56097856u, 56228672u, 56358592u, 56490176u,
+		56621888u, 56753728u, 56884928u, 57015488u,
+		57146816u, 57278272u, 57409216u, 57540416u,
+		57671104u, 57802432u, 57933632u, 58064576u,
+		58195264u, 58326976u, 58457408u, 58588864u,
+		58720192u, 58849984u, 58981696u, 59113024u,
+		59243456u, 59375552u, 59506624u, 59637568u,
+		59768512u, 59897792u, 60030016u, 60161984u,
+		60293056u, 60423872u, 60554432u, 60683968u,
+		60817216u, 60948032u, 61079488u, 61209664u,
+		61341376u, 61471936u, 61602752u, 61733696u,
+		61865792u, 61996736u, 62127808u, 62259136u,
+		62389568u, 62520512u, 62651584u, 62781632u,
+		62910784u, 63045056u, 63176128u, 63307072u,
+		63438656u, 63569216u, 63700928u, 63831616u,
+		63960896u, 64093888u, 64225088u, 64355392u,
+		64486976u, 64617664u, 64748608u, 64879424u,
+		65009216u, 65142464u, 65273792u, 65402816u,
+		65535424u, 65666752u, 65797696u, 65927744u,
+		66060224u, 66191296u, 66321344u, 66453056u,
+		66584384u, 66715328u, 66846656u, 66977728u,
+		67108672u, 67239104u, 67370432u, 67501888u,
+		67631296u, 67763776u, 67895104u, 68026304u,
+		68157248u, 68287936u, 68419264u, 68548288u,
+		68681408u, 68811968u, 68942912u, 69074624u,
+		69205568u, 69337024u, 69467584u, 69599168u,
+		69729472u, 69861184u, 69989824u, 70122944u,
+		70253888u, 70385344u, 70515904u, 70647232u,
+		70778816u, 70907968u, 71040832u, 71171648u,
+		71303104u, 71432512u, 71564992u, 71695168u,
+		71826368u, 71958464u, 72089536u, 72219712u,
+		72350144u, 72482624u, 72613568u, 72744512u,
+		72875584u, 73006144u, 73138112u, 73268672u,
+		73400128u, 73530944u, 73662272u, 73793344u,
+		73924544u, 74055104u, 74185792u, 74316992u,
+		74448832u, 74579392u, 74710976u, 74841664u,
+		74972864u, 75102784u, 75233344u, 75364544u,
+		75497024u, 75627584u, 75759296u, 75890624u,
+		76021696u, 76152256u, 76283072u, 76414144u,
+		76545856u, 76676672u, 76806976u, 76937792u,
+		77070016u, 77200832u, 77331392u, 77462464u,
+		77593664u, 77725376u, 77856448u, 77987776u,
+		78118336u, 78249664u, 78380992u, 78511424u,
+		78642496u, 78773056u, 78905152u, 79033664u,
+		79166656u, 79297472u, 79429568u, 79560512u,
+		79690816u, 79822784u, 79953472u, 80084672u,
+		80214208u, 80346944u, 80477632u, 80608576u,
+		80740288u, 80870848u, 81002048u, 81133504u,
+		81264448u, 81395648u, 81525952u, 81657536u,
+		81786304u, 81919808u, 82050112u, 82181312u,
+		82311616u, 82443968u, 82573376u, 82705984u,
+		82835776u, 82967744u, 83096768u, 83230528u,
+		83359552u, 83491264u, 83622464u, 83753536u,
+		83886016u, 84015296u, 84147776u, 84277184u,
+		84409792u, 84540608u, 84672064u, 84803008u,
+		84934336u, 85065152u, 85193792u, 85326784u,
+		85458496u, 85589312u, 85721024u, 85851968u,
+		85982656u, 86112448u, 86244416u, 86370112u,
+		86506688u, 86637632u, 86769344u, 86900672u,
+		87031744u, 87162304u, 87293632u, 87424576u,
+		87555392u, 87687104u, 87816896u, 87947968u,
+		88079168u, 88211264u, 88341824u, 88473152u,
+		88603712u, 88735424u, 88862912u, 88996672u,
+		89128384u, 89259712u, 89390272u, 89521984u,
+		89652544u, 89783872u, 89914816u, 90045376u,
+		90177088u, 90307904u, 90438848u, 90569152u,
+		90700096u, 90832832u, 90963776u, 91093696u,
+		91223744u, 91356992u, 91486784u, 91618496u,
+		91749824u, 91880384u, 92012224u, 92143552u,
+		92273344u, 92405696u, 92536768u, 92666432u,
+		92798912u, 92926016u, 93060544u, 93192128u,
+		93322816u, 93453632u, 93583936u, 93715136u,
+		93845056u, 93977792u, 94109504u, 94240448u,
+		94371776u, 94501184u, 94632896u, 94764224u,
+		94895552u, 95023424u, 95158208u, 95287744u,
+		95420224u, 95550016u, 95681216u, 95811904u,
+		95943872u, 96075328u, 96203584u, 96337856u,
+		96468544u, 96599744u, 96731072u, 96860992u,
+		96992576u, 97124288u, 97254848u, 97385536u,
+		97517248u, 97647808u, 97779392u, 97910464u,
+		98041408u, 98172608u, 98303168u, 98434496u,
+		98565568u, 98696768u, 98827328u, 98958784u,
+		99089728u, 99220928u, 99352384u, 99482816u,
+		99614272u, 99745472u, 99876416u, 100007104u,
+		100138048u, 100267072u, 100401088u, 100529984u,
+		100662592u, 100791872u, 100925248u, 101056064u,
+		101187392u, 101317952u, 101449408u, 101580608u,
+		101711296u, 101841728u, 101973824u, 102104896u,
+		102235712u, 102366016u, 102498112u, 102628672u,
+		102760384u, 102890432u, 103021888u, 103153472u,
+		103284032u, 103415744u, 103545152u, 103677248u,
+		103808576u, 103939648u, 104070976u, 104201792u,
+		104332736u, 104462528u, 104594752u, 104725952u,
+		104854592u, 104988608u, 105118912u, 105247808u,
+		105381184u, 105511232u, 105643072u, 105774784u,
+		105903296u, 106037056u, 106167872u, 106298944u,
+		106429504u, 106561472u, 106691392u, 106822592u,
+		106954304u, 107085376u, 107216576u, 107346368u,
+		107478464u, 107609792u, 107739712u, 107872192u,
+		108003136u, 108131392u, 108265408u, 108396224u,
+		108527168u, 108657344u, 108789568u, 108920384u,
+		109049792u, 109182272u, 109312576u, 109444928u,
+		109572928u, 109706944u, 109837888u, 109969088u,
+		110099648u, 110230976u, 110362432u, 110492992u,
+		110624704u, 110755264u, 110886208u, 111017408u,
+		111148864u, 111279296u, 111410752u, 111541952u,
+		111673024u, 111803456u, 111933632u, 112066496u,
+		112196416u, 112328512u, 112457792u, 112590784u,
+		112715968u, 112852672u, 112983616u, 113114944u,
+		113244224u, 113376448u, 113505472u, 113639104u,
+		113770304u, 113901376u, 114031552u, 114163264u,
+		114294592u, 114425536u, 114556864u, 114687424u,
+		114818624u, 114948544u, 115080512u, 115212224u,
+		115343296u, 115473472u, 115605184u, 115736128u,
+		115867072u, 115997248u, 116128576u, 116260288u,
+		116391488u, 116522944u, 116652992u, 116784704u,
+		116915648u, 117046208u, 117178304u, 117308608u,
+		117440192u, 117569728u, 117701824u, 117833024u,
+		117964096u, 118094656u, 118225984u, 118357312u,
+		118489024u, 118617536u, 118749632u, 118882112u,
+		119012416u, 119144384u, 119275328u, 119406016u,
+		119537344u, 119668672u, 119798464u, 119928896u,
+		120061376u, 120192832u, 120321728u, 120454336u,
+		120584512u, 120716608u, 120848192u, 120979136u,
+		121109056u, 121241408u, 121372352u, 121502912u,
+		121634752u, 121764416u, 121895744u, 122027072u,
+		122157632u, 122289088u, 122421184u, 122550592u,
+		122682944u, 122813888u, 122945344u, 123075776u,
+		123207488u, 123338048u, 123468736u, 123600704u,
+		123731264u, 123861952u, 123993664u, 124124608u,
+		124256192u, 124386368u, 124518208u, 124649024u,
+		124778048u, 124911296u, 125041088u, 125173696u,
+		125303744u, 125432896u, 125566912u, 125696576u,
+		125829056u, 125958592u, 126090304u, 126221248u,
+		126352832u, 126483776u, 126615232u, 126746432u,
+		126876608u, 127008704u, 127139392u, 127270336u,
+		127401152u, 127532224u, 127663552u, 127794752u,
+		127925696u, 128055232u, 128188096u, 128319424u,
+		128449856u, 128581312u, 128712256u, 128843584u,
+		128973632u, 129103808u, 129236288u, 129365696u,
+		129498944u, 129629888u, 129760832u, 129892288u,
+		130023104u, 130154048u, 130283968u, 130416448u,
+		130547008u, 130678336u, 130807616u, 130939456u,
+		131071552u, 131202112u, 131331776u, 131464384u,
+		131594048u, 131727296u, 131858368u, 131987392u,
+		132120256u, 132250816u, 132382528u, 132513728u,
+		132644672u, 132774976u, 132905792u, 133038016u,
+		133168832u, 133299392u, 133429312u, 133562048u,
+		133692992u, 133823296u, 133954624u, 134086336u,
+		134217152u, 134348608u, 134479808u, 134607296u,
+		134741056u, 134872384u, 135002944u, 135134144u,
+		135265472u, 135396544u, 135527872u, 135659072u,
+		135787712u, 135921472u, 136052416u, 136182848u,
+		136313792u, 136444864u, 136576448u, 136707904u,
+		136837952u, 136970048u, 137099584u, 137232064u,
+		137363392u, 137494208u, 137625536u, 137755712u,
+		137887424u, 138018368u, 138149824u, 138280256u,
+		138411584u, 138539584u, 138672832u, 138804928u,
+		138936128u, 139066688u, 139196864u, 139328704u,
+		139460032u, 139590208u, 139721024u, 139852864u,
+		139984576u, 140115776u, 140245696u, 140376512u,
+		140508352u, 140640064u, 140769856u, 140902336u,
+		141032768u, 141162688u, 141294016u, 141426496u,
+		141556544u, 141687488u, 141819584u, 141949888u,
+		142080448u, 142212544u, 142342336u, 142474432u,
+		142606144u, 142736192u, 142868288u, 142997824u,
+		143129408u, 143258944u, 143392448u, 143523136u,
+		143653696u, 143785024u, 143916992u, 144045632u,
+		144177856u, 144309184u, 144440768u, 144570688u,
+		144701888u, 144832448u, 144965056u, 145096384u,
+		145227584u, 145358656u, 145489856u, 145620928u,
+		145751488u, 145883072u, 146011456u, 146144704u,
+		146275264u, 146407232u, 146538176u, 146668736u,
+		146800448u, 146931392u, 147062336u, 147193664u,
+		147324224u, 147455936u, 147586624u, 147717056u,
+		147848768u, 147979456u, 148110784u, 148242368u,
+		148373312u, 148503232u, 148635584u, 148766144u,
+		148897088u, 149028416u, 149159488u, 149290688u,
+		149420224u, 149551552u, 149683136u, 149814976u,
+		149943616u, 150076352u, 150208064u, 150338624u,
+		150470464u, 150600256u, 150732224u, 150862784u,
+		150993088u, 151125952u, 151254976u, 151388096u,
+		151519168u, 151649728u, 151778752u, 151911104u,
+		152042944u, 152174144u, 152304704u, 152435648u,
+		152567488u, 152698816u, 152828992u, 152960576u,
+		153091648u, 153222976u, 153353792u, 153484096u,
+		153616192u, 153747008u, 153878336u, 154008256u,
+		154139968u, 154270912u, 154402624u, 154533824u,
+		154663616u, 154795712u, 154926272u, 155057984u,
+		155188928u, 155319872u, 155450816u, 155580608u,
+		155712064u, 155843392u, 155971136u, 156106688u,
+		156237376u, 156367424u, 156499264u, 156630976u,
+		156761536u, 156892352u, 157024064u, 157155008u,
+		157284416u, 157415872u, 157545536u, 157677248u,
+		157810496u, 157938112u, 158071744u, 158203328u,
+		158334656u, 158464832u, 158596288u, 158727616u,
+		158858048u, 158988992u, 159121216u, 159252416u,
+		159381568u, 159513152u, 159645632u, 159776192u,
+		159906496u, 160038464u, 160169536u, 160300352u,
+		160430656u, 160563008u, 160693952u, 160822208u,
+		160956352u, 161086784u, 161217344u, 161349184u,
+		161480512u, 161611456u, 161742272u, 161873216u,
+		162002752u, 162135872u, 162266432u, 162397888u,
+		162529216u, 162660032u, 162790976u, 162922048u,
+		163052096u, 163184576u, 163314752u, 163446592u,
+		163577408u, 163707968u, 163839296u, 163969984u,
+		164100928u, 164233024u, 164364224u, 164494912u,
+		164625856u, 164756672u, 164887616u, 165019072u,
+		165150016u, 165280064u, 165412672u, 165543104u,
+		165674944u, 165805888u, 165936832u, 166067648u,
+		166198336u, 166330048u, 166461248u, 166591552u,
+		166722496u, 166854208u, 166985408u, 167116736u,
+		167246656u, 167378368u, 167508416u, 167641024u,
+		167771584u, 167903168u, 168034112u, 168164032u,
+		168295744u, 168427456u, 168557632u, 168688448u,
+		168819136u, 168951616u, 169082176u, 169213504u,
+		169344832u, 169475648u, 169605952u, 169738048u,
+		169866304u, 169999552u, 170131264u, 170262464u,
+		170393536u, 170524352u, 170655424u, 170782016u,
+		170917696u, 171048896u, 171179072u, 171310784u,
+		171439936u, 171573184u, 171702976u, 171835072u,
+		171966272u, 172097216u, 172228288u, 172359232u,
+		172489664u, 172621376u, 172747712u, 172883264u,
+		173014208u, 173144512u, 173275072u, 173407424u,
+		173539136u, 173669696u, 173800768u, 173931712u,
+		174063424u, 174193472u, 174325696u, 174455744u,
+		174586816u, 174718912u, 174849728u, 174977728u,
+		175109696u, 175242688u, 175374272u, 175504832u,
+		175636288u, 175765696u, 175898432u, 176028992u,
+		176159936u, 176291264u, 176422592u, 176552512u,
+		176684864u, 176815424u, 176946496u, 177076544u,
+		177209152u, 177340096u, 177470528u, 177600704u,
+		177731648u, 177864256u, 177994816u, 178126528u,
+		178257472u, 178387648u, 178518464u, 178650176u,
+		178781888u, 178912064u, 179044288u, 179174848u,
+		179305024u, 179436736u, 179568448u, 179698496u,
+		179830208u, 179960512u, 180092608u, 180223808u,
+		180354752u, 180485696u, 180617152u, 180748096u,
+		180877504u, 181009984u, 181139264u, 181272512u,
+		181402688u, 181532608u, 181663168u, 181795136u,
+		181926592u, 182057536u, 182190016u, 182320192u,
+		182451904u, 182582336u, 182713792u, 182843072u,
+		182976064u, 183107264u, 183237056u, 183368384u,
+		183494848u, 183631424u, 183762752u, 183893824u,
+		184024768u, 184154816u, 184286656u, 184417984u,
+		184548928u, 184680128u, 184810816u, 184941248u,
+		185072704u, 185203904u, 185335616u, 185465408u,
+		185596352u, 185727296u, 185859904u, 185989696u,
+		186121664u, 186252992u, 186383552u, 186514112u,
+		186645952u, 186777152u, 186907328u, 187037504u,
+		187170112u, 187301824u, 187429184u, 187562048u,
+		187693504u, 187825472u, 187957184u, 188087104u,
+		188218304u, 188349376u, 188481344u, 188609728u,
+		188743616u, 188874304u, 189005248u, 189136448u,
+		189265088u, 189396544u, 189528128u, 189660992u,
+		189791936u, 189923264u, 190054208u, 190182848u,
+		190315072u, 190447424u, 190577984u, 190709312u,
+		190840768u, 190971328u, 191102656u, 191233472u,
+		191364032u, 191495872u, 191626816u, 191758016u,
+		191888192u, 192020288u, 192148928u, 192282176u,
+		192413504u, 192542528u, 192674752u, 192805952u,
+		192937792u, 193068608u, 193198912u, 193330496u,
+		193462208u, 193592384u, 193723456u, 193854272u,
+		193985984u, 194116672u, 194247232u, 194379712u,
+		194508352u, 194641856u, 194772544u, 194900672u,
+		195035072u, 195166016u, 195296704u, 195428032u,
+		195558592u, 195690304u, 195818176u, 195952576u,
+		196083392u, 196214336u, 196345792u, 196476736u,
+		196607552u, 196739008u, 196869952u, 197000768u,
+		197130688u, 197262784u, 197394368u, 197523904u,
+		197656384u, 197787584u, 197916608u, 198049472u,
+		198180544u, 198310208u, 198442432u, 198573632u,
+		198705088u, 198834368u, 198967232u, 199097792u,
+		199228352u, 199360192u, 199491392u, 199621696u,
+		199751744u, 199883968u, 200014016u, 200146624u,
+		200276672u, 200408128u, 200540096u, 200671168u,
+		200801984u, 200933312u, 201062464u, 201194944u,
+		201326144u, 201457472u, 201588544u, 201719744u,
+		201850816u, 201981632u, 202111552u, 202244032u,
+		202374464u, 202505152u, 202636352u, 202767808u,
+		202898368u, 203030336u, 203159872u, 203292608u,
+		203423296u, 203553472u, 203685824u, 203816896u,
+		203947712u, 204078272u, 204208192u, 204341056u,
+		204472256u, 204603328u, 204733888u, 204864448u,
+		204996544u, 205125568u, 205258304u, 205388864u,
+		205517632u, 205650112u, 205782208u, 205913536u,
+		206044736u, 206176192u, 206307008u, 206434496u,
+		206569024u, 206700224u, 206831168u, 206961856u,
+		207093056u, 207223616u, 207355328u, 207486784u,
+		207616832u, 207749056u, 207879104u, 208010048u,
+		208141888u, 208273216u, 208404032u, 208534336u,
+		208666048u, 208796864u, 208927424u, 209059264u,
+		209189824u, 209321792u, 209451584u, 209582656u,
+		209715136u, 209845568u, 209976896u, 210106432u,
+		210239296u, 210370112u, 210501568u, 210630976u,
+		210763712u, 210894272u, 211024832u, 211156672u,
+		211287616u, 211418176u, 211549376u, 211679296u,
+		211812032u, 211942592u, 212074432u, 212204864u,
+		212334016u, 212467648u, 212597824u, 212727616u,
+		212860352u, 212991424u, 213120832u, 213253952u,
+		213385024u, 213515584u, 213645632u, 213777728u,
+		213909184u, 214040128u, 214170688u, 214302656u,
+		214433728u, 214564544u, 214695232u, 214826048u,
+		214956992u, 215089088u, 215219776u, 215350592u,
+		215482304u, 215613248u, 215743552u, 215874752u,
+		216005312u, 216137024u, 216267328u, 216399296u,
+		216530752u, 216661696u, 216790592u, 216923968u,
+		217054528u, 217183168u, 217316672u, 217448128u,
+		217579072u, 217709504u, 217838912u, 217972672u,
+		218102848u, 218233024u, 218364736u, 218496832u,
+		218627776u, 218759104u, 218888896u, 219021248u,
+		219151936u, 219281728u, 219413056u, 219545024u,
+		219675968u, 219807296u, 219938624u, 220069312u,
+		220200128u, 220331456u, 220461632u, 220592704u,
+		220725184u, 220855744u, 220987072u, 221117888u,
+		221249216u, 221378368u, 221510336u, 221642048u,
+		221772736u, 221904832u, 222031808u, 222166976u,
+		222297536u, 222428992u, 222559936u, 222690368u,
+		222820672u, 222953152u, 223083968u, 223213376u,
+		223345984u, 223476928u, 223608512u, 223738688u,
+		223869376u, 224001472u, 224132672u, 224262848u,
+		224394944u, 224524864u, 224657344u, 224788288u,
+		224919488u, 225050432u, 225181504u, 225312704u,
+		225443776u, 225574592u, 225704768u, 225834176u,
+		225966784u, 226097216u, 226229824u, 226360384u,
+		226491712u, 226623424u, 226754368u, 226885312u,
+		227015104u, 227147456u, 227278528u, 227409472u,
+		227539904u, 227669696u, 227802944u, 227932352u,
+		228065216u, 228196288u, 228326464u, 228457792u,
+		228588736u, 228720064u, 228850112u, 228981056u,
+		229113152u, 229243328u, 229375936u, 229505344u,
+		229636928u, 229769152u, 229894976u, 230030272u,
+		230162368u, 230292416u, 230424512u, 230553152u,
+		230684864u, 230816704u, 230948416u, 231079616u,
+		231210944u, 231342016u, 231472448u, 231603776u,
+		231733952u, 231866176u, 231996736u, 232127296u,
+		232259392u, 232388672u, 232521664u, 232652608u,
+		232782272u, 232914496u, 233043904u, 233175616u,
+		233306816u, 233438528u, 233569984u, 233699776u,
+		233830592u, 233962688u, 234092224u, 234221888u,
+		234353984u, 234485312u, 234618304u, 234749888u,
+		234880832u, 235011776u, 235142464u, 235274048u,
+		235403456u, 235535936u, 235667392u, 235797568u,
+		235928768u, 236057152u, 236190272u, 236322752u,
+		236453312u, 236583616u, 236715712u, 236846528u,
+		236976448u, 237108544u, 237239104u, 237371072u,
+		237501632u, 237630784u, 237764416u, 237895232u,
+		238026688u, 238157632u, 238286912u, 238419392u,
+		238548032u, 238681024u, 238812608u, 238941632u,
+		239075008u, 239206336u, 239335232u, 239466944u,
+		239599168u, 239730496u, 239861312u, 239992384u,
+		240122816u, 240254656u, 240385856u, 240516928u,
+		240647872u, 240779072u, 240909632u, 241040704u,
+		241171904u, 241302848u, 241433408u, 241565248u,
+		241696192u, 241825984u, 241958848u, 242088256u,
+		242220224u, 242352064u, 242481856u, 242611648u,
+		242744896u, 242876224u, 243005632u, 243138496u,
+		243268672u, 243400384u, 243531712u, 243662656u,
+		243793856u, 243924544u, 244054592u, 244187072u,
+		244316608u, 244448704u, 244580032u, 244710976u,
+		244841536u, 244972864u, 245104448u, 245233984u,
+		245365312u, 245497792u, 245628736u, 245759936u,
+		245889856u, 246021056u, 246152512u, 246284224u,
+		246415168u, 246545344u, 246675904u, 246808384u,
+		246939584u, 247070144u, 247199552u, 247331648u,
+		247463872u, 247593536u, 247726016u, 247857088u,
+		247987648u, 248116928u, 248249536u, 248380736u,
+		248512064u, 248643008u, 248773312u, 248901056u,
+		249036608u, 249167552u, 249298624u, 249429184u,
+		249560512u, 249692096u, 249822784u, 249954112u,
+		250085312u, 250215488u, 250345792u, 250478528u,
+		250608704u, 250739264u, 250870976u, 251002816u,
+		251133632u, 251263552u, 251395136u, 251523904u,
+		251657792u, 251789248u, 251919424u, 252051392u,
+		252182464u, 252313408u, 252444224u, 252575552u,
+		252706624u, 252836032u, 252968512u, 253099712u,
+		253227584u, 253361728u, 253493056u, 253623488u,
+		253754432u, 253885504u, 254017216u, 254148032u,
+		254279488u, 254410432u, 254541376u, 254672576u,
+		254803264u, 254933824u, 255065792u, 255196736u,
+		255326528u, 255458752u, 255589952u, 255721408u,
+		255851072u, 255983296u, 256114624u, 256244416u,
+		256374208u, 256507712u, 256636096u, 256768832u,
+		256900544u, 257031616u, 257162176u, 257294272u,
+		257424448u, 257555776u, 257686976u, 257818432u,
+		257949632u, 258079552u, 258211136u, 258342464u,
+		258473408u, 258603712u, 258734656u, 258867008u,
+		258996544u, 259127744u, 259260224u, 259391296u,
+		259522112u, 259651904u, 259784384u, 259915328u,
+		260045888u, 260175424u, 260308544u, 260438336u,
+		260570944u, 260700992u, 260832448u, 260963776u,
+		261092672u, 261226304u, 261356864u, 261487936u,
+		261619648u, 261750592u, 261879872u, 262011968u,
+		262143424u, 262274752u, 262404416u, 262537024u,
+		262667968u, 262799296u, 262928704u, 263061184u,
+		263191744u, 263322944u, 263454656u, 263585216u,
+		263716672u, 263847872u, 263978944u, 264108608u,
+		264241088u, 264371648u, 264501184u, 264632768u,
+		264764096u, 264895936u, 265024576u, 265158464u,
+		265287488u, 265418432u, 265550528u, 265681216u,
+		265813312u, 265943488u, 266075968u, 266206144u,
+		266337728u, 266468032u, 266600384u, 266731072u,
+		266862272u, 266993344u, 267124288u, 267255616u,
+		267386432u, 267516992u, 267648704u, 267777728u,
+		267910592u, 268040512u, 268172096u, 268302784u,
+		268435264u, 268566208u, 268696256u, 268828096u,
+		268959296u, 269090368u, 269221312u, 269352256u,
+		269482688u, 269614784u, 269745856u, 269876416u,
+		270007616u, 270139328u, 270270272u, 270401216u,
+		270531904u, 270663616u, 270791744u, 270924736u,
+		271056832u, 271186112u, 271317184u, 271449536u,
+		271580992u, 271711936u, 271843136u, 271973056u,
+		272105408u, 272236352u, 272367296u, 272498368u,
+		272629568u, 272759488u, 272891456u, 273022784u,
+		273153856u, 273284672u, 273415616u, 273547072u,
+		273677632u, 273808448u, 273937088u, 274071488u,
+		274200896u, 274332992u, 274463296u, 274595392u,
+		274726208u, 274857536u, 274988992u, 275118656u,
+		275250496u, 275382208u, 275513024u, 275643968u,
+		275775296u, 275906368u, 276037184u, 276167872u,
+		276297664u, 276429376u, 276560576u, 276692672u,
+		276822976u, 276955072u, 277085632u, 277216832u,
+		277347008u, 277478848u, 277609664u, 277740992u,
+		277868608u, 278002624u, 278134336u, 278265536u,
+		278395328u, 278526784u, 278657728u, 278789824u,
+		278921152u, 279052096u, 279182912u, 279313088u,
+		279443776u, 279576256u, 279706048u, 279838528u,
+		279969728u, 280099648u, 280230976u, 280361408u,
+		280493632u, 280622528u, 280755392u, 280887104u,
+		281018176u, 281147968u, 281278912u, 281411392u,
+		281542592u, 281673152u, 281803712u, 281935552u,
+		282066496u, 282197312u, 282329024u, 282458816u,
+		282590272u, 282720832u, 282853184u, 282983744u,
+		283115072u, 283246144u, 283377344u, 283508416u,
+		283639744u, 283770304u, 283901504u, 284032576u,
+		284163136u, 284294848u, 284426176u, 284556992u,
+		284687296u, 284819264u, 284950208u, 285081536u
+	};
+
+	static constexpr uint64_t dag_sizes[EPOCH_SIZE_TABLE_LENGTH] =
+	{
+		1073739904u, 1082130304u, 1090514816u, 1098906752u,
+		1107293056u, 1115684224u, 1124070016u, 1132461952u,
+		1140849536u, 1149232768u, 1157627776u, 1166013824u,
+		1174404736u, 1182786944u, 1191180416u, 1199568512u,
+		1207958912u, 1216345216u, 1224732032u, 1233124736u,
+		1241513344u, 1249902464u, 1258290304u, 1266673792u,
+		1275067264u, 1283453312u, 1291844992u, 1300234112u,
+		1308619904u, 1317010048u, 1325397376u, 1333787776u,
+		1342176128u, 1350561664u, 1358954368u, 1367339392u,
+		1375731584u, 1384118144u, 1392507008u, 1400897408u,
+		1409284736u, 1417673344u, 1426062464u, 1434451072u,
+		1442839168u, 1451229056u, 1459615616u, 1468006016u,
+		1476394112u, 1484782976u, 1493171584u, 1501559168u,
+		1509948032u, 1518337664u, 1526726528u, 1535114624u,
+		1543503488u, 1551892096u, 1560278656u, 1568669056u,
+		1577056384u, 1585446272u, 1593831296u, 1602219392u,
+		1610610304u, 1619000192u, 1627386752u, 1635773824u,
+		1644164224u, 1652555648u, 1660943488u, 1669332608u,
+		1677721216u, 1686109312u, 1694497664u, 1702886272u,
+		1711274624u, 1719661184u, 1728047744u, 1736434816u,
+		1744829056u, 1753218944u, 1761606272u, 1769995904u,
+		1778382464u, 1786772864u, 1795157888u, 1803550592u,
+		1811937664u, 1820327552u, 1828711552u, 1837102976u,
+		1845488768u, 1853879936u, 1862269312u, 1870656896u,
+		1879048064u, 1887431552u, 1895825024u, 1904212096u,
+		1912601216u, 1920988544u, 1929379456u, 1937765504u,
+		1946156672u, 1954543232u, 1962932096u, 1971321728u,
+		1979707264u, 1988093056u, 1996487552u, 2004874624u,
+		2013262208u, 2021653888u, 2030039936u, 2038430848u,
+		2046819968u, 2055208576u, 2063596672u, 2071981952u,
+		2080373632u, 2088762752u, 2097149056u, 2105539712u,
+		2113928576u, 2122315136u, 2130700672u, 2139092608u,
+		2147483264u, 2155872128u, 2164257664u, 2172642176u,
+		2181035392u, 2189426048u, 2197814912u, 2206203008u,
+		2214587264u, 2222979712u, 2231367808u, 2239758208u,
+		2248145024u, 2256527744u, 2264922752u, 2273312128u,
+		2281701248u, 2290086272u, 2298476672u, 2306867072u,
+		2315251072u, 2323639168u, 2332032128u, 2340420224u,
+		2348808064u, 2357196416u, 2365580416u, 2373966976u,
+		2382363008u, 2390748544u, 2399139968u, 2407530368u,
+		2415918976u, 2424307328u, 2432695424u, 2441084288u,
+		2449472384u, 2457861248u, 2466247808u, 2474637184u,
+		2483026816u, 2491414144u, 2499803776u, 2508191872u,
+		2516582272u, 2524970368u, 2533359232u, 2541743488u,
+		2550134144u, 2558525056u, 2566913408u, 2575301504u,
+		2583686528u, 2592073856u, 2600467328u, 2608856192u,
+		2617240448u, 2625631616u, 2634022016u, 2642407552u,
+		2650796416u, 2659188352u, 2667574912u, 2675965312u,
+		2684352896u, 2692738688u, 2701130624u, 2709518464u,
+		2717907328u, 2726293376u, 2734685056u, 2743073152u,
+		2751462016u, 2759851648u, 2768232832u, 2776625536u,
+		2785017728u, 2793401984u, 2801794432u, 2810182016u,
+		2818571648u, 2826959488u, 2835349376u, 2843734144u,
+		2852121472u, 2860514432u, 2868900992u, 2877286784u,
+		2885676928u, 2894069632u, 2902451584u, 2910843008u,
+		2919234688u, 2927622784u, 2936011648u, 2944400768u,
+		2952789376u, 2961177728u, 2969565568u, 2977951616u,
+		2986338944u, 2994731392u, 3003120256u, 3011508352u,
+		3019895936u, 3028287104u, 3036675968u, 3045063808u,
+		3053452928u, 3061837696u, 3070228352u, 3078615424u,
+		3087003776u, 3095394944u, 3103782272u, 3112173184u,
+		3120562048u, 3128944768u, 3137339264u, 3145725056u,
+		3154109312u, 3162505088u, 3170893184u, 3179280256u,
+		3187669376u, 3196056704u, 3204445568u, 3212836736u,
+		3221224064u, 3229612928u, 3238002304u, 3246391168u,
+		3254778496u, 3263165824u, 3271556224u, 3279944576u,
+		3288332416u, 3296719232u, 3305110912u, 3313500032u,
+		3321887104u, 3330273152u, 3338658944u, 3347053184u,
+		3355440512u, 3363827072u, 3372220288u, 3380608384u,
+		3388997504u, 3397384576u, 3405774208u, 3414163072u,
+		3422551936u, 3430937984u, 3439328384u, 3447714176u,
+		3456104576u, 3464493952u, 3472883584u, 3481268864u,
+		3489655168u, 3498048896u, 3506434432u, 3514826368u,
+		3523213952u, 3531603584u, 3539987072u, 3548380288u,
+		3556763264u, 3565157248u, 3573545344u, 3581934464u,
+		3590324096u, 3598712704u, 3607098752u, 3615488384u,
+		3623877248u, 3632265856u, 3640646528u, 3649043584u,
+		3657430144u, 3665821568u, 3674207872u, 3682597504u,
+		3690984832u, 3699367808u, 3707764352u, 3716152448u,
+		3724541056u, 3732925568u, 3741318016u, 3749706368u,
+		3758091136u, 3766481536u, 3774872704u, 3783260032u,
+		3791650432u, 3800036224u, 3808427648u, 3816815488u,
+		3825204608u, 3833592704u, 3841981568u, 3850370432u,
+		3858755968u, 3867147904u, 3875536256u, 3883920512u,
+		3892313728u, 3900702592u, 3909087872u, 3917478784u,
+		3925868416u, 3934256512u, 3942645376u, 3951032192u,
+		3959422336u, 3967809152u, 3976200064u, 3984588416u,
+		3992974976u, 4001363584u, 4009751168u, 4018141312u,
+		4026530432u, 4034911616u, 4043308928u, 4051695488u,
+		4060084352u, 4068472448u, 4076862848u, 4085249408u,
+		4093640576u, 4102028416u, 4110413696u, 4118805632u,
+		4127194496u, 4135583104u, 4143971968u, 4152360832u,
+		4160746112u, 4169135744u, 4177525888u, 4185912704u,
+		4194303616u, 4202691968u, 4211076736u, 4219463552u,
+		4227855488u, 4236246656u, 4244633728u, 4253022848u,
+		4261412224u, 4269799808u, 4278184832u, 4286578048u,
+		4294962304u, 4303349632u, 4311743104u, 4320130432u,
+		4328521088u, 4336909184u, 4345295488u, 4353687424u,
+		4362073472u, 4370458496u, 4378852736u, 4387238528u,
+		4395630208u, 4404019072u, 4412407424u, 4420790656u,
+		4429182848u, 4437571456u, 4445962112u, 4454344064u,
+		4462738048u, 4471119232u, 4479516544u, 4487904128u,
+		4496289664u, 4504682368u, 4513068416u, 4521459584u,
+		4529846144u, 4538232704u, 4546619776u, 4555010176u,
+		4563402112u, 4571790208u, 4580174464u, 4588567936u,
+		4596957056u, 4605344896u, 4613734016u, 4622119808u,
+		4630511488u, 4638898816u, 4647287936u, 4655675264u,
+		4664065664u, 4672451968u, 4680842624u, 4689231488u,
+		4697620352u, 4706007424u, 4714397056u, 4722786176u,
+		4731173248u, 4739562368u, 4747951744u, 4756340608u,
+		4764727936u, 4773114496u, 4781504384u, 4789894784u,
+		4798283648u, 4806667648u, 4815059584u, 4823449472u,
+		4831835776u, 4840226176u, 4848612224u, 4857003392u,
+		4865391488u, 4873780096u, 4882169728u, 4890557312u,
+		4898946944u, 4907333248u, 4915722368u, 4924110976u,
+		4932499328u, 4940889728u, 4949276032u, 4957666432u,
+		4966054784u, 4974438016u, 4982831488u, 4991221376u,
+		4999607168u, 5007998848u, 5016386432u, 5024763776u,
+		5033164672u, 5041544576u, 5049941888u, 5058329728u,
+		5066717056u, 5075107456u, 5083494272u, 5091883904u,
+		5100273536u, 5108662144u, 5117048192u, 5125436032u,
+		5133827456u, 5142215296u, 5150605184u, 5158993024u,
+		5167382144u, 5175769472u, 5184157568u, 5192543872u,
+		5200936064u, 5209324928u, 5217711232u, 5226102656u,
+		5234490496u, 5242877312u, 5251263872u, 5259654016u,
+		5268040832u, 5276434304u, 5284819328u, 5293209728u,
+		5301598592u, 5309986688u, 5318374784u, 5326764416u,
+		5335151488u, 5343542144u, 5351929472u, 5360319872u,
+		5368706944u, 5377096576u, 5385484928u, 5393871232u,
+		5402263424u, 5410650496u, 5419040384u, 5427426944u,
+		5435816576u, 5444205952u, 5452594816u, 5460981376u,
+		5469367936u, 5477760896u, 5486148736u, 5494536832u,
+		5502925952u, 5511315328u, 5519703424u, 5528089984u,
+		5536481152u, 5544869504u, 5553256064u, 5561645696u,
+		5570032768u, 5578423936u, 5586811264u, 5595193216u,
+		5603585408u, 5611972736u, 5620366208u, 5628750464u,
+		5637143936u, 5645528192u, 5653921408u, 5662310272u,
+		5670694784u, 5679082624u, 5687474048u, 5695864448u,
+		5704251008u, 5712641408u, 5721030272u, 5729416832u,
+		5737806208u, 5746194304u, 5754583936u, 5762969984u,
+		5771358592u, 5779748224u, 5788137856u, 5796527488u,
+		5804911232u, 5813300608u, 5821692544u, 5830082176u,
+		5838468992u, 5846855552u, 5855247488u, 5863636096u,
+		5872024448u, 5880411008u, 5888799872u, 5897186432u,
+		5905576832u, 5913966976u, 5922352768u, 5930744704u,
+		5939132288u, 5947522432u, 5955911296u, 5964299392u,
+		5972688256u, 5981074304u, 5989465472u, 5997851008u,
+		6006241408u, 6014627968u, 6023015552u, 6031408256u,
+		6039796096u, 6048185216u, 6056574848u, 6064963456u,
+		6073351808u, 6081736064u, 6090128768u, 6098517632u,
+		6106906496u, 6115289216u, 6123680896u, 6132070016u,
+		6140459648u, 6148849024u, 6157237376u, 6165624704u,
+		6174009728u, 6182403712u, 6190792064u, 6199176064u,
+		6207569792u, 6215952256u, 6224345216u, 6232732544u,
+		6241124224u, 6249510272u, 6257899136u, 6266287744u,
+		6274676864u, 6283065728u, 6291454336u, 6299843456u,
+		6308232064u, 6316620928u, 6325006208u, 6333395584u,
+		6341784704u, 6350174848u, 6358562176u, 6366951296u,
+		6375337856u, 6383729536u, 6392119168u, 6400504192u,
+		6408895616u, 6417283456u, 6425673344u, 6434059136u,
+		6442444672u, 6450837376u, 6459223424u, 6467613056u,
+		6476004224u, 6484393088u, 6492781952u, 6501170048u,
+		6509555072u, 6517947008u, 6526336384u, 6534725504u,
+		6543112832u, 6551500672u, 6559888768u, 6568278656u,
+		6576662912u, 6585055616u, 6593443456u, 6601834112u,
+		6610219648u, 6618610304u, 6626999168u, 6635385472u,
+		6643777408u, 6652164224u, 6660552832u, 6668941952u,
+		6677330048u, 6685719424u, 6694107776u, 6702493568u,
+		6710882176u, 6719274112u, 6727662976u, 6736052096u,
+		6744437632u, 6752825984u, 6761213824u, 6769604224u,
+		6777993856u, 6786383488u, 6794770816u, 6803158144u,
+		6811549312u, 6819937664u, 6828326528u, 6836706176u,
+		6845101696u, 6853491328u, 6861880448u, 6870269312u,
+		6878655104u, 6887046272u, 6895433344u, 6903822208u,
+		6912212864u, 6920596864u, 6928988288u, 6937377152u,
+		6945764992u, 6954149248u, 6962544256u, 6970928768u,
+		6979317376u, 6987709312u, 6996093824u, 7004487296u,
+		7012875392u, 7021258624u, 7029652352u, 7038038912u,
+		7046427776u, 7054818944u, 7063207808u, 7071595136u,
+		7079980928u, 7088372608u, 7096759424u, 7105149824u,
+		7113536896u, 7121928064u, 7130315392u, 7138699648u,
+		7147092352u, 7155479168u, 7163865728u, 7172249984u,
+		7180648064u, 7189036672u, 7197424768u, 7205810816u,
+		7214196608u, 7222589824u, 7230975104u, 7239367552u,
+		7247755904u, 7256145536u, 7264533376u, 7272921472u,
+		7281308032u, 7289694848u, 7298088832u, 7306471808u,
+		7314864512u, 7323253888u, 7331643008u, 7340029568u,
+		7348419712u, 7356808832u, 7365196672u, 7373585792u,
+		7381973888u, 7390362752u, 7398750592u, 7407138944u,
+		7415528576u, 7423915648u, 7432302208u, 7440690304u,
+		7449080192u, 7457472128u, 7465860992u, 7474249088u,
+		7482635648u, 7491023744u, 7499412608u, 7507803008u,
+		7516192384u, 7524579968u, 7532967296u, 7541358464u,
+		7549745792u, 7558134656u, 7566524032u, 7574912896u,
+		7583300992u, 7591690112u, 7600075136u, 7608466816u,
+		7616854912u, 7625244544u, 7633629824u, 7642020992u,
+		7650410368u, 7658794112u, 7667187328u, 7675574912u,
+		7683961984u, 7692349568u, 7700739712u, 7709130368u,
+		7717519232u, 7725905536u, 7734295424u, 7742683264u,
+		7751069056u, 7759457408u, 7767849088u, 7776238208u,
+		7784626816u, 7793014912u, 7801405312u, 7809792128u,
+		7818179968u, 7826571136u, 7834957184u, 7843347328u,
+		7851732352u, 7860124544u, 7868512384u, 7876902016u,
+		7885287808u, 7893679744u, 7902067072u, 7910455936u,
+		7918844288u, 7927230848u, 7935622784u, 7944009344u,
+		7952400256u, 7960786048u, 7969176704u, 7977565312u,
+		7985953408u, 7994339968u, 8002730368u, 8011119488u,
+		8019508096u, 8027896192u, 8036285056u, 8044674688u,
+		8053062272u, 8061448832u, 8069838464u, 8078227328u,
+		8086616704u, 8095006592u, 8103393664u, 8111783552u,
+		8120171392u, 8128560256u, 8136949376u, 8145336704u,
+		8153726848u, 8162114944u, 8170503296u, 8178891904u,
+		8187280768u, 8195669632u, 8204058496u, 8212444544u,
+		8220834176u, 8229222272u, 8237612672u, 8246000768u,
+		8254389376u, 8262775168u, 8271167104u, 8279553664u,
+		8287944064u, 8296333184u, 8304715136u, 8313108352u,
+		8321497984u, 8329885568u, 8338274432u, 8346663296u,
+		8355052928u, 8363441536u, 8371828352u, 8380217984u,
+		8388606592u, 8396996224u, 8405384576u, 8413772672u,
+		8422161536u, 8430549376u, 8438939008u, 8447326592u,
+		8455715456u, 8464104832u, 8472492928u, 8480882048u,
+		8489270656u, 8497659776u, 8506045312u, 8514434944u,
+		8522823808u, 8531208832u, 8539602304u, 8547990656u,
+		8556378752u, 8564768384u, 8573154176u, 8581542784u,
+		8589933952u, 8598322816u, 8606705024u, 8615099264u,
+		8623487872u, 8631876992u, 8640264064u, 8648653952u,
+		8657040256u, 8665430656u, 8673820544u, 8682209152u,
+		8690592128u, 8698977152u, 8707374464u, 8715763328u,
+		8724151424u, 8732540032u, 8740928384u, 8749315712u,
+		8757704576u, 8766089344u, 8774480768u, 8782871936u,
+		8791260032u, 8799645824u, 8808034432u, 8816426368u,
+		8824812928u, 8833199488u, 8841591424u, 8849976448u,
+		8858366336u, 8866757248u, 8875147136u, 8883532928u,
+		8891923328u, 8900306816u, 8908700288u, 8917088384u,
+		8925478784u, 8933867392u, 8942250368u, 8950644608u,
+		8959032704u, 8967420544u, 8975809664u, 8984197504u,
+		8992584064u, 9000976256u, 9009362048u, 9017752448u,
+		9026141312u, 9034530688u, 9042917504u, 9051307904u,
+		9059694208u, 9068084864u, 9076471424u, 9084861824u,
+		9093250688u, 9101638528u, 9110027648u, 9118416512u,
+		9126803584u, 9135188096u, 9143581312u, 9151969664u,
+		9160356224u, 9168747136u, 9177134464u, 9185525632u,
+		9193910144u, 9202302848u, 9210690688u, 9219079552u,
+		9227465344u, 9235854464u, 9244244864u, 9252633472u,
+		9261021824u, 9269411456u, 9277799296u, 9286188928u,
+		9294574208u, 9302965888u, 9311351936u, 9319740032u,
+		9328131968u, 9336516736u, 9344907392u, 9353296768u,
+		9361685888u, 9370074752u, 9378463616u, 9386849408u,
+		9395239808u, 9403629184u, 9412016512u, 9420405376u,
+		9428795008u, 9437181568u, 9445570688u, 9453960832u,
+		9462346624u, 9470738048u, 9479121536u, 9487515008u,
+		9495903616u, 9504289664u, 9512678528u, 9521067904u,
+		9529456256u, 9537843584u, 9546233728u, 9554621312u,
+		9563011456u, 9571398784u, 9579788672u, 9588178304u,
+		9596567168u, 9604954496u, 9613343104u, 9621732992u,
+		9630121856u, 9638508416u, 9646898816u, 9655283584u,
+		9663675776u, 9672061312u, 9680449664u, 9688840064u,
+		9697230464u, 9705617536u, 9714003584u, 9722393984u,
+		9730772608u, 9739172224u, 9747561088u, 9755945344u,
+		9764338816u, 9772726144u, 9781116544u, 9789503872u,
+		9797892992u, 9806282624u, 9814670464u, 9823056512u,
+		9831439232u, 9839833984u, 9848224384u, 9856613504u,
+		9865000576u, 9873391232u, 9881772416u, 9890162816u,
+		9898556288u, 9906940544u, 9915333248u, 9923721088u,
+		9932108672u, 9940496512u, 9948888448u, 9957276544u,
+		9965666176u, 9974048384u, 9982441088u, 9990830464u,
+		9999219584u, 10007602816u, 10015996544u, 10024385152u,
+		10032774016u, 10041163648u, 10049548928u, 10057940096u,
+		10066329472u, 10074717824u, 10083105152u, 10091495296u,
+		10099878784u, 10108272256u, 10116660608u, 10125049216u,
+		10133437312u, 10141825664u, 10150213504u, 10158601088u,
+		10166991232u, 10175378816u, 10183766144u, 10192157312u,
+		10200545408u, 10208935552u, 10217322112u, 10225712768u,
+		10234099328u, 10242489472u, 10250876032u, 10259264896u,
+		10267656064u, 10276042624u, 10284429184u, 10292820352u,
+		10301209472u, 10309598848u, 10317987712u, 10326375296u,
+		10334763392u, 10343153536u, 10351541632u, 10359930752u,
+		10368318592u, 10376707456u, 10385096576u, 10393484672u,
+		10401867136u, 10410262144u, 10418647424u, 10427039104u,
+		10435425664u, 10443810176u, 10452203648u, 10460589952u,
+		10468982144u, 10477369472u, 10485759104u, 10494147712u,
+		10502533504u, 10510923392u, 10519313536u, 10527702656u,
+		10536091264u, 10544478592u, 10552867712u, 10561255808u,
+		10569642368u, 10578032768u, 10586423168u, 10594805632u,
+		10603200128u, 10611588992u, 10619976064u, 10628361344u,
+		10636754048u, 10645143424u, 10653531776u, 10661920384u,
+		10670307968u, 10678696832u, 10687086464u, 10695475072u,
+		10703863168u, 10712246144u, 10720639616u, 10729026688u,
+		10737414784u, 10745806208u, 10754190976u, 10762581376u,
+		10770971264u, 10779356288u, 10787747456u, 10796135552u,
+		10804525184u, 10812915584u, 10821301888u, 10829692288u,
+		10838078336u, 10846469248u, 10854858368u, 10863247232u,
+		10871631488u, 10880023424u, 10888412032u, 10896799616u,
+		10905188992u, 10913574016u, 10921964672u, 10930352768u,
+		10938742912u, 10947132544u, 10955518592u, 10963909504u,
+		10972298368u, 10980687488u, 10989074816u, 10997462912u,
+		11005851776u, 11014241152u, 11022627712u, 11031017344u,
+		11039403904u, 11047793024u, 11056184704u, 11064570752u,
+		11072960896u, 11081343872u, 11089737856u, 11098128256u,
+		11106514816u, 11114904448u, 11123293568u, 11131680128u,
+		11140065152u, 11148458368u, 11156845696u, 11165236864u,
+		11173624192u, 11182013824u, 11190402688u, 11198790784u,
+		11207179136u, 11215568768u, 11223957376u, 11232345728u,
+		11240734592u, 11249122688u, 11257511296u, 11265899648u,
+		11274285952u, 11282675584u, 11291065472u, 11299452544u,
+		11307842432u, 11316231296u, 11324616832u, 11333009024u,
+		11341395584u, 11349782656u, 11358172288u, 11366560384u,
+		11374950016u, 11383339648u, 11391721856u, 11400117376u,
+		11408504192u, 11416893568u, 11425283456u, 11433671552u,
+		11442061184u, 11450444672u, 11458837888u, 11467226752u,
+		11475611776u, 11484003968u, 11492392064u, 11500780672u,
+		11509169024u, 11517550976u, 11525944448u, 11534335616u,
+		11542724224u, 11551111808u, 11559500672u, 11567890304u,
+		11576277376u, 11584667008u, 11593056128u, 11601443456u,
+		11609830016u, 11618221952u, 11626607488u, 11634995072u,
+		11643387776u, 11651775104u, 11660161664u, 11668552576u,
+		11676940928u, 11685330304u, 11693718656u, 11702106496u,
+		11710496128u, 11718882688u, 11727273088u, 11735660416u,
+		11744050048u, 11752437376u, 11760824704u, 11769216128u,
+		11777604736u, 11785991296u, 11794381952u, 11802770048u,
+		11811157888u, 11819548544u, 11827932544u, 11836324736u,
+		11844713344u, 11853100928u, 11861486464u, 11869879936u,
+		11878268032u, 11886656896u, 11895044992u, 11903433088u,
+		11911822976u, 11920210816u, 11928600448u, 11936987264u,
+		11945375872u, 11953761152u, 11962151296u, 11970543488u,
+		11978928512u, 11987320448u, 11995708288u, 12004095104u,
+		12012486272u, 12020875136u, 12029255552u, 12037652096u,
+		12046039168u, 12054429568u, 12062813824u, 12071206528u,
+		12079594624u, 12087983744u, 12096371072u, 12104759936u,
+		12113147264u, 12121534592u, 12129924992u, 12138314624u,
+		12146703232u, 12155091584u, 12163481216u, 12171864704u,
+		12180255872u, 12188643968u, 12197034112u, 12205424512u,
+		12213811328u, 12222199424u, 12230590336u, 12238977664u,
+		12247365248u, 12255755392u, 12264143488u, 12272531584u,
+		12280920448u, 12289309568u, 12297694592u, 12306086528u,
+		12314475392u, 12322865024u, 12331253632u, 12339640448u,
+		12348029312u, 12356418944u, 12364805248u, 12373196672u,
+		12381580928u, 12389969024u, 12398357632u, 12406750592u,
+		12415138432u, 12423527552u, 12431916416u, 12440304512u,
+		12448692352u, 12457081216u, 12465467776u, 12473859968u,
+		12482245504u, 12490636672u, 12499025536u, 12507411584u,
+		12515801728u, 12524190592u, 12532577152u, 12540966272u,
+		12549354368u, 12557743232u, 12566129536u, 12574523264u,
+		12582911872u, 12591299456u, 12599688064u, 12608074624u,
+		12616463488u, 12624845696u, 12633239936u, 12641631616u,
+		12650019968u, 12658407296u, 12666795136u, 12675183232u,
+		12683574656u, 12691960192u, 12700350592u, 12708740224u,
+		12717128576u, 12725515904u, 12733906816u, 12742295168u,
+		12750680192u, 12759071872u, 12767460736u, 12775848832u,
+		12784236928u, 12792626816u, 12801014656u, 12809404288u,
+		12817789312u, 12826181504u, 12834568832u, 12842954624u,
+		12851345792u, 12859732352u, 12868122496u, 12876512128u,
+		12884901248u, 12893289088u, 12901672832u, 12910067584u,
+		12918455168u, 12926842496u, 12935232896u, 12943620736u,
+		12952009856u, 12960396928u, 12968786816u, 12977176192u,
+		12985563776u, 12993951104u, 13002341504u, 13010730368u,
+		13019115392u, 13027506304u, 13035895168u, 13044272512u,
+		13052673152u, 13061062528u, 13069446272u, 13077838976u,
+		13086227072u, 13094613632u, 13103000192u, 13111393664u,
+		13119782528u, 13128157568u, 13136559232u, 13144945024u,
+		13153329536u, 13161724288u, 13170111872u, 13178502784u,
+		13186884736u, 13195279744u, 13203667072u, 13212057472u,
+		13220445824u, 13228832128u, 13237221248u, 13245610624u,
+		13254000512u, 13262388352u, 13270777472u, 13279166336u,
+		13287553408u, 13295943296u, 13304331904u, 13312719488u,
+		13321108096u, 13329494656u, 13337885824u, 13346274944u,
+		13354663808u, 13363051136u, 13371439232u, 13379825024u,
+		13388210816u, 13396605056u, 13404995456u, 13413380224u,
+		13421771392u, 13430159744u, 13438546048u, 13446937216u,
+		13455326848u, 13463708288u, 13472103808u, 13480492672u,
+		13488875648u, 13497269888u, 13505657728u, 13514045312u,
+		13522435712u, 13530824576u, 13539210112u, 13547599232u,
+		13555989376u, 13564379008u, 13572766336u, 13581154432u,
+		13589544832u, 13597932928u, 13606320512u, 13614710656u,
+		13623097472u, 13631477632u, 13639874944u, 13648264064u,
+		13656652928u, 13665041792u, 13673430656u, 13681818496u,
+		13690207616u, 13698595712u, 13706982272u, 13715373184u,
+		13723762048u, 13732150144u, 13740536704u, 13748926592u,
+		13757316224u, 13765700992u, 13774090112u, 13782477952u,
+		13790869376u, 13799259008u, 13807647872u, 13816036736u,
+		13824425344u, 13832814208u, 13841202304u, 13849591424u,
+		13857978752u, 13866368896u, 13874754688u, 13883145344u,
+		13891533184u, 13899919232u, 13908311168u, 13916692096u,
+		13925085056u, 13933473152u, 13941866368u, 13950253696u,
+		13958643584u, 13967032192u, 13975417216u, 13983807616u,
+		13992197504u, 14000582272u, 14008973696u, 14017363072u,
+		14025752192u, 14034137984u, 14042528384u, 14050918016u,
+		14059301504u, 14067691648u, 14076083584u, 14084470144u,
+		14092852352u, 14101249664u, 14109635968u, 14118024832u,
+		14126407552u, 14134804352u, 14143188608u, 14151577984u,
+		14159968384u, 14168357248u, 14176741504u, 14185127296u,
+		14193521024u, 14201911424u, 14210301824u, 14218685056u,
+		14227067264u, 14235467392u, 14243855488u, 14252243072u,
+		14260630144u, 14269021568u, 14277409408u, 14285799296u,
+		14294187904u, 14302571392u, 14310961792u, 14319353728u,
+		14327738752u, 14336130944u, 14344518784u, 14352906368u,
+		14361296512u, 14369685376u, 14378071424u, 14386462592u,
+		14394848128u, 14403230848u, 14411627392u, 14420013952u,
+		14428402304u, 14436793472u, 14445181568u, 14453569664u,
+		14461959808u, 14470347904u, 14478737024u, 14487122816u,
+		14495511424u, 14503901824u, 14512291712u, 14520677504u,
+		14529064832u, 14537456768u, 14545845632u, 14554234496u,
+		14562618496u, 14571011456u, 14579398784u, 14587789184u,
+		14596172672u, 14604564608u, 14612953984u, 14621341312u,
+		14629724288u, 14638120832u, 14646503296u, 14654897536u,
+		14663284864u, 14671675264u, 14680061056u, 14688447616u,
+		14696835968u, 14705228416u, 14713616768u, 14722003328u,
+		14730392192u, 14738784128u, 14747172736u, 14755561088u,
+		14763947648u, 14772336512u, 14780725376u, 14789110144u,
+		14797499776u, 14805892736u, 14814276992u, 14822670208u,
+		14831056256u, 14839444352u, 14847836032u, 14856222848u,
+		14864612992u, 14872997504u, 14881388672u, 14889775744u,
+		14898165376u, 14906553472u, 14914944896u, 14923329664u,
+		14931721856u, 14940109696u, 14948497024u, 14956887424u,
+		14965276544u, 14973663616u, 14982053248u, 14990439808u,
+		14998830976u, 15007216768u, 15015605888u, 15023995264u,
+		15032385152u, 15040768384u, 15049154944u, 15057549184u,
+		15065939072u, 15074328448u, 15082715008u, 15091104128u,
+		15099493504u, 15107879296u, 15116269184u, 15124659584u,
+		15133042304u, 15141431936u, 15149824384u, 15158214272u,
+		15166602368u, 15174991232u, 15183378304u, 15191760512u,
+		15200154496u, 15208542592u, 15216931712u, 15225323392u,
+		15233708416u, 15242098048u, 15250489216u, 15258875264u,
+		15267265408u, 15275654528u, 15284043136u, 15292431488u,
+		15300819584u, 15309208192u, 15317596544u, 15325986176u,
+		15334374784u, 15342763648u, 15351151744u, 15359540608u,
+		15367929728u, 15376318336u, 15384706432u, 15393092992u,
+		15401481856u, 15409869952u, 15418258816u, 15426649984u,
+		15435037568u, 15443425664u, 15451815296u, 15460203392u,
+		15468589184u, 15476979328u, 15485369216u, 15493755776u,
+		15502146944u, 15510534272u, 15518924416u, 15527311232u,
+		15535699072u, 15544089472u, 15552478336u, 15560866688u,
+		15569254528u, 15577642624u, 15586031488u, 15594419072u,
+		15602809472u, 15611199104u, 15619586432u, 15627975296u,
+		15636364928u, 15644753792u, 15653141888u, 15661529216u,
+		15669918848u, 15678305152u, 15686696576u, 15695083136u,
+		15703474048u, 15711861632u, 15720251264u, 15728636288u,
+		15737027456u, 15745417088u, 15753804928u, 15762194048u,
+		15770582656u, 15778971008u, 15787358336u, 15795747712u,
+		15804132224u, 15812523392u, 15820909696u, 15829300096u,
+		15837691264u, 15846071936u, 15854466944u, 15862855808u,
+		15871244672u, 15879634816u, 15888020608u, 15896409728u,
+		15904799104u, 15913185152u, 15921577088u, 15929966464u,
+		15938354816u, 15946743424u, 15955129472u, 15963519872u,
+		15971907968u, 15980296064u, 15988684928u, 15997073024u,
+		16005460864u, 16013851264u, 16022241152u, 16030629248u,
+		16039012736u, 16047406976u, 16055794816u, 16064181376u,
+		16072571264u, 16080957824u, 16089346688u, 16097737856u,
+		16106125184u, 16114514816u, 16122904192u, 16131292544u,
+		16139678848u, 16148066944u, 16156453504u, 16164839552u,
+		16173236096u, 16181623424u, 16190012032u, 16198401152u,
+		16206790528u, 16215177344u, 16223567744u, 16231956352u,
+		16240344704u, 16248731008u, 16257117824u, 16265504384u,
+		16273898624u, 16282281856u, 16290668672u, 16299064192u,
+		16307449216u, 16315842176u, 16324230016u, 16332613504u,
+		16341006464u, 16349394304u, 16357783168u, 16366172288u,
+		16374561664u, 16382951296u, 16391337856u, 16399726208u,
+		16408116352u, 16416505472u, 16424892032u, 16433282176u,
+		16441668224u, 16450058624u, 16458448768u, 16466836864u,
+		16475224448u, 16483613056u, 16492001408u, 16500391808u,
+		16508779648u, 16517166976u, 16525555328u, 16533944192u,
+		16542330752u, 16550719616u, 16559110528u, 16567497088u,
+		16575888512u, 16584274816u, 16592665472u, 16601051008u,
+		16609442944u, 16617832064u, 16626218624u, 16634607488u,
+		16642996096u, 16651385728u, 16659773824u, 16668163712u,
+		16676552576u, 16684938112u, 16693328768u, 16701718144u,
+		16710095488u, 16718492288u, 16726883968u, 16735272832u,
+		16743661184u, 16752049792u, 16760436608u, 16768827008u,
+		16777214336u, 16785599104u, 16793992832u, 16802381696u,
+		16810768768u, 16819151744u, 16827542656u, 16835934848u,
+		16844323712u, 16852711552u, 16861101952u, 16869489536u,
+		16877876864u, 16886265728u, 16894653056u, 16903044736u,
+		16911431296u, 16919821696u, 16928207488u, 16936592768u,
+		16944987776u, 16953375616u, 16961763968u, 16970152832u,
+		16978540928u, 16986929536u, 16995319168u, 17003704448u,
+		17012096896u, 17020481152u, 17028870784u, 17037262208u,
+		17045649536u, 17054039936u, 17062426496u, 17070814336u,
+		17079205504u, 17087592064u, 17095978112u, 17104369024u,
+		17112759424u, 17121147776u, 17129536384u, 17137926016u,
+		17146314368u, 17154700928u, 17163089792u, 17171480192u,
+		17179864192u, 17188256896u, 17196644992u, 17205033856u,
+		17213423488u, 17221811072u, 17230198912u, 17238588032u,
+		17246976896u, 17255360384u, 17263754624u, 17272143232u,
+		17280530048u, 17288918912u, 17297309312u, 17305696384u,
+		17314085504u, 17322475136u, 17330863744u, 17339252096u,
+		17347640192u, 17356026496u, 17364413824u, 17372796544u,
+		17381190016u, 17389583488u, 17397972608u, 17406360704u,
+		17414748544u, 17423135872u, 17431527296u, 17439915904u,
+		17448303232u, 17456691584u, 17465081728u, 17473468288u,
+		17481857408u, 17490247552u, 17498635904u, 17507022464u,
+		17515409024u, 17523801728u, 17532189824u, 17540577664u,
+		17548966016u, 17557353344u, 17565741184u, 17574131584u,
+		17582519168u, 17590907008u, 17599296128u, 17607687808u,
+		17616076672u, 17624455808u, 17632852352u, 17641238656u,
+		17649630848u, 17658018944u, 17666403968u, 17674794112u,
+		17683178368u, 17691573376u, 17699962496u, 17708350592u,
+		17716739968u, 17725126528u, 17733517184u, 17741898112u,
+		17750293888u, 17758673024u, 17767070336u, 17775458432u,
+		17783848832u, 17792236928u, 17800625536u, 17809012352u,
+		17817402752u, 17825785984u, 17834178944u, 17842563968u,
+		17850955648u, 17859344512u, 17867732864u, 17876119424u,
+		17884511872u, 17892900224u, 17901287296u, 17909677696u,
+		17918058112u, 17926451072u, 17934843776u, 17943230848u,
+		17951609216u, 17960008576u, 17968397696u, 17976784256u,
+		17985175424u, 17993564032u, 18001952128u, 18010339712u,
+		18018728576u, 18027116672u, 18035503232u, 18043894144u,
+		18052283264u, 18060672128u, 18069056384u, 18077449856u,
+		18085837184u, 18094225792u, 18102613376u, 18111004544u,
+		18119388544u, 18127781248u, 18136170368u, 18144558976u,
+		18152947328u, 18161336192u, 18169724288u, 18178108544u,
+		18186498944u, 18194886784u, 18203275648u, 18211666048u,
+		18220048768u, 18228444544u, 18236833408u, 18245220736u
+	};
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <stdint.h>
+
+// remainder by a fixed divisor using multiplications instead of a division, after Lemire, Kaser & Kurz "Faster Remainder by Direct Computation"
+// every divisor used while hashing is an item or page count of an epoch, so it is computed once when the cache or DAG is built
+namespace egihash
+{
+	class fast_divisor_t
+	{
+	public:
+		explicit fast_divisor_t(uint32_t divisor) noexcept
+		: divisor(divisor)
+		, reciprocal((divisor != 0) ? ((~uint64_t(0) / divisor) + 1) : 0)
+		{
+		}
+
+		uint32_t mod(uint32_t dividend) const noexcept
+		{
+#if defined(__SIZEOF_INT128__)
+			return static_cast<uint32_t>((static_cast<unsigned __int128>(reciprocal * dividend) * divisor) >> 64);
+#else
+			return mod_split(dividend);
+#endif
+		}
+
+		// the same remainder without 128-bit integers, taking the high half of the product from two 32-bit halves
+		uint32_t mod_split(uint32_t dividend) const noexcept
+		{
+			uint64_t const fraction = reciprocal * dividend;
+			uint64_t const high = (fraction >> 32) * divisor;
+			uint64_t const low = (fraction & 0xffffffff) * divisor;
+			return static_cast<uint32_t>((high + (low >> 32)) >> 32);
+		}
+
+		uint32_t value() const noexcept
+		{
+			return divisor;
+		}
+
+	private:
+		uint32_t divisor;
+		uint64_t reciprocal;
+	};
+}
@@ -0,0 +1,347 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "egihash.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	using namespace egihash;
+
+	// size of a regular file, or unknown_size for pipes, sockets and the like
+	source_t::size_type regular_file_size(int fd)
+	{
+		struct stat st;
+		if ((::fstat(fd, &st) != 0) || !S_ISREG(st.st_mode))
+		{
+			return source_t::unknown_size;
+		}
+		return static_cast<source_t::size_type>(st.st_size);
+	}
+}
+
+namespace egihash
+{
+	constexpr source_t::size_type source_t::unknown_size;
+
+	void source_t::skip(size_type count)
+	{
+		char buffer[constants::IO_CHUNK_BYTES];
+		while (count > 0)
+		{
+			size_type const chunk = (std::min)(count, sizeof(buffer));
+			read(buffer, chunk);
+			count -= chunk;
+		}
+	}
+
+	void const * source_t::view(size_type)
+	{
+		return nullptr;
+	}
+
+	::std::shared_ptr<void const> source_t::view_owner() const
+	{
+		return nullptr;
+	}
+
+	source_t::size_type source_t::remaining() const
+	{
+		return unknown_size;
+	}
+
+	void sink_t::flush()
+	{
+	}
+
+	fd_source::fd_source(int fd)
+	: fd(fd)
+	, owned(false)
+	, size(regular_file_size(fd))
+	, position(0)
+	{
+		// a regular file may already have been partially read
+		if (size != unknown_size)
+		{
+			off_t const offset = ::lseek(fd, 0, SEEK_CUR);
+			position = (offset < 0) ? 0 : static_cast<size_type>(offset);
+		}
+	}
+
+	fd_source::fd_source(::std::string const & file_path)
+	: fd(::open(file_path.c_str(), O_RDONLY))
+	, owned(true)
+	, size(unknown_size)
+	, position(0)
+	{
+		if (fd < 0)
+		{
+			throw hash_exception("Could not open file for reading.");
+		}
+		size = regular_file_size(fd);
+	}
+
+	fd_source::~fd_source()
+	{
+		if (owned)
+		{
+			::close(fd);
+		}
+	}
+
+	void fd_source::read(void * dst, size_type count)
+	{
+		char * ptr = reinterpret_cast<char *>(dst);
+		while (count > 0)
+		{
+			ssize_t const result = ::read(fd, ptr, count);
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				throw hash_exception("Read failure");
+			}
+			if (result == 0)
+			{
+				throw hash_exception("Read failure - unexpected end of file");
+			}
+			ptr += result;
+			count -= static_cast<size_type>(result);
+			position += static_cast<size_type>(result);
+		}
+	}
+
+	void fd_source::skip(size_type count)
+	{
+		if (size == unknown_size)
+		{
+			source_t::skip(count);
+			return;
+		}
+
+		if (count > remaining())
+		{
+			throw hash_exception("Read failure - unexpected end of file");
+		}
+		if (::lseek(fd, static_cast<off_t>(count), SEEK_CUR) < 0)
+		{
+			throw hash_exception("Seek failure");
+		}
+		position += count;
+	}
+
+	fd_source::size_type fd_source::remaining() const
+	{
+		if (size == unknown_size)
+		{
+			return unknown_size;
+		}
+		return (position < size) ? (size - position) : 0;
+	}
+
+	fd_sink::fd_sink(int fd)
+	: fd(fd)
+	, owned(false)
+	{
+	}
+
+	fd_sink::fd_sink(::std::string const & file_path)
+	: fd(::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644))
+	, owned(true)
+	{
+		if (fd < 0)
+		{
+			throw hash_exception("Could not open file for writing.");
+		}
+	}
+
+	fd_sink::~fd_sink()
+	{
+		if (owned)
+		{
+			::close(fd);
+		}
+	}
+
+	void fd_sink::write(void const * src, size_type count)
+	{
+		char const * ptr = reinterpret_cast<char const *>(src);
+		while (count > 0)
+		{
+			ssize_t const result = ::write(fd, ptr, count);
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				throw hash_exception("Write failure");
+			}
+			ptr += result;
+			count -= static_cast<size_type>(result);
+		}
+	}
+
+	void fd_sink::flush()
+	{
+		if ((::fsync(fd) != 0) && (errno != EINVAL))
+		{
+			throw hash_exception("Flush failure");
+		}
+	}
+
+	memory_source::memory_source(void const * data, size_type size, ::std::shared_ptr<void const> owner) noexcept
+	: begin(reinterpret_cast<uint8_t const *>(data))
+	, end(reinterpret_cast<uint8_t const *>(data) + size)
+	, owner(owner)
+	{
+	}
+
+	void memory_source::read(void * dst, size_type count)
+	{
+		::std::memcpy(dst, memory_source::view(count), count);
+	}
+
+	void const * memory_source::view(size_type count)
+	{
+		if (count > remaining())
+		{
+			throw hash_exception("Read failure - unexpected end of data");
+		}
+		void const * const ret = begin;
+		begin += count;
+		return ret;
+	}
+
+	::std::shared_ptr<void const> memory_source::view_owner() const
+	{
+		return owner;
+	}
+
+	void memory_source::skip(size_type count)
+	{
+		memory_source::view(count);
+	}
+
+	memory_source::size_type memory_source::remaining() const
+	{
+		return static_cast<size_type>(end - begin);
+	}
+
+	mmap_source::mmap_source(::std::string const & file_path, bool lend)
+	: memory_source(nullptr, 0)
+	, lend(lend)
+	{
+		int const fd = ::open(file_path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw hash_exception("Could not open file for reading.");
+		}
+
+		// a lent mapping is writable, so memory loaded from it behaves like any other memory once it has been handed on
+		size_type const mapping_size = regular_file_size(fd);
+		void * mapping = MAP_FAILED;
+		if ((mapping_size != unknown_size) && (mapping_size > 0))
+		{
+			mapping = ::mmap(nullptr, mapping_size, lend ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd);
+
+		if (mapping == MAP_FAILED)
+		{
+			throw hash_exception("Could not map file.");
+		}
+
+		// caches and DAGs are read front to back
+		::madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+		owner = ::std::shared_ptr<void const>(mapping, [mapping_size](void const * p) { ::munmap(const_cast<void *>(p), mapping_size); });
+		begin = reinterpret_cast<uint8_t const *>(mapping);
+		end = begin + mapping_size;
+	}
+
+	void const * mmap_source::view(size_type count)
+	{
+		void const * const ret = memory_source::view(count);
+
+		// viewed memory may be kept and read in any order, so it is no longer dropped behind the reader, and is read ahead now
+		uintptr_t const page_size = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+		uintptr_t const first = reinterpret_cast<uintptr_t>(ret) & ~(page_size - 1);
+		size_t const length = static_cast<size_t>(reinterpret_cast<uintptr_t>(ret) + count - first);
+		::madvise(reinterpret_cast<void *>(first), length, MADV_NORMAL);
+		::madvise(reinterpret_cast<void *>(first), length, MADV_WILLNEED);
+		return ret;
+	}
+
+	::std::shared_ptr<void const> mmap_source::view_owner() const
+	{
+		return lend ? owner : nullptr;
+	}
+
+	memory_sink::memory_sink(void * data, size_type size) noexcept
+	: begin(reinterpret_cast<uint8_t *>(data))
+	, position(reinterpret_cast<uint8_t *>(data))
+	, end(reinterpret_cast<uint8_t *>(data) + size)
+	{
+	}
+
+	void memory_sink::write(void const * src, size_type count)
+	{
+		if (count > static_cast<size_type>(end - position))
+		{
+			throw hash_exception("Write failure - out of space");
+		}
+		::std::memcpy(position, src, count);
+		position += count;
+	}
+
+	memory_sink::size_type memory_sink::written() const noexcept
+	{
+		return static_cast<size_type>(position - begin);
+	}
+
+	callback_source::callback_source(read_function_type read, size_type size)
+	: read_function(read)
+	, size(size)
+	{
+	}
+
+	void callback_source::read(void * dst, size_type count)
+	{
+		if (size != unknown_size)
+		{
+			if (count > size)
+			{
+				throw hash_exception("Read failure - unexpected end of data");
+			}
+			size -= count;
+		}
+		read_function(dst, count);
+	}
+
+	callback_source::size_type callback_source::remaining() const
+	{
+		return size;
+	}
+
+	callback_sink::callback_sink(write_function_type write)
+	: write_function(write)
+	{
+	}
+
+	void callback_sink::write(void const * src, size_type count)
+	{
+		write_function(src, count);
+	}
+}
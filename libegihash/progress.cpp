@@ -0,0 +1,149 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "egihash.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+	using namespace egihash;
+
+	static constexpr size_t phase_count = static_cast<size_t>(dag_verification) + 1;
+}
+
+namespace egihash
+{
+	struct cancel_token_t::impl_t
+	{
+		impl_t()
+		: cancelled(false)
+		{
+		}
+
+		::std::atomic<bool> cancelled;
+	};
+
+	cancel_token_t::cancel_token_t()
+	: impl(new impl_t())
+	{
+	}
+
+	void cancel_token_t::cancel() const noexcept
+	{
+		impl->cancelled.store(true, ::std::memory_order_release);
+	}
+
+	bool cancel_token_t::is_cancelled() const noexcept
+	{
+		return impl->cancelled.load(::std::memory_order_acquire);
+	}
+
+	struct progress_t::impl_t
+	{
+		impl_t(cancel_token_t const & token, progress_callback_type const & observer)
+		: token(token)
+		, observer(observer)
+		, observer_mutex()
+		, current(cache_seeding)
+		{
+			for (size_t i = 0; i < phase_count; i++)
+			{
+				steps[i].store(0, ::std::memory_order_relaxed);
+				maxes[i].store(0, ::std::memory_order_relaxed);
+			}
+		}
+
+		bool report(size_t step, size_t max, progress_callback_phase phase)
+		{
+			maxes[phase].store(max, ::std::memory_order_relaxed);
+			current.store(phase, ::std::memory_order_relaxed);
+			if (observer)
+			{
+				// reporting threads don't queue up behind a slow observer, as the next report carries a later count anyway,
+				// except with the last report of a phase, which nothing comes after
+				::std::unique_lock<::std::mutex> lock(observer_mutex, ::std::defer_lock);
+				if (step >= max)
+				{
+					lock.lock();
+				}
+				else
+				{
+					lock.try_lock();
+				}
+				if (lock.owns_lock() && !observer(step, max, phase))
+				{
+					token.cancel();
+				}
+			}
+			return !token.is_cancelled();
+		}
+
+		cancel_token_t const token;
+		progress_callback_type const observer;
+		::std::mutex observer_mutex;
+		::std::atomic<size_t> steps[phase_count];
+		::std::atomic<size_t> maxes[phase_count];
+		::std::atomic<progress_callback_phase> current;
+	};
+
+	progress_t::progress_t()
+	: progress_t(cancel_token_t())
+	{
+	}
+
+	progress_t::progress_t(cancel_token_t const & token, progress_callback_type observer)
+	: impl(new impl_t(token, observer))
+	{
+	}
+
+	bool progress_t::operator()(::std::size_t step, ::std::size_t max, progress_callback_phase phase) const
+	{
+		impl->steps[phase].store(step, ::std::memory_order_relaxed);
+		return impl->report(step, max, phase);
+	}
+
+	bool progress_t::advance(::std::size_t count, ::std::size_t max, progress_callback_phase phase) const
+	{
+		size_t const step = impl->steps[phase].fetch_add(count, ::std::memory_order_relaxed) + count;
+		return impl->report(step, max, phase);
+	}
+
+	::std::size_t progress_t::step(progress_callback_phase phase) const noexcept
+	{
+		return impl->steps[phase].load(::std::memory_order_relaxed);
+	}
+
+	::std::size_t progress_t::max(progress_callback_phase phase) const noexcept
+	{
+		return impl->maxes[phase].load(::std::memory_order_relaxed);
+	}
+
+	progress_callback_phase progress_t::phase() const noexcept
+	{
+		return impl->current.load(::std::memory_order_relaxed);
+	}
+
+	cancel_token_t progress_t::get_cancel_token() const
+	{
+		return impl->token;
+	}
+
+	void progress_t::cancel() const noexcept
+	{
+		impl->token.cancel();
+	}
+
+	bool progress_t::is_cancelled() const noexcept
+	{
+		return impl->token.is_cancelled();
+	}
+
+	progress_t progress_t::from_callback(progress_callback_type const & callback)
+	{
+		progress_t const * const progress = callback.target<progress_t>();
+		return progress ? *progress : progress_t(cancel_token_t(), callback);
+	}
+}
@@ -0,0 +1,430 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "egihash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	using namespace egihash;
+
+	// nonces are handed out and stolen in chunks of at least this many nonces
+	static constexpr uint64_t search_chunk_size = 64;
+
+	// number of solutions which may be waiting to be popped before workers pause
+	static constexpr size_t solution_queue_size = 1024;
+
+	inline uint64_t load_be64(uint8_t const * p) noexcept
+	{
+		uint64_t ret = 0;
+		for (size_t i = 0; i < sizeof(ret); i++)
+		{
+			ret = (ret << 8) | p[i];
+		}
+		return ret;
+	}
+
+	// bounded multi-producer multi-consumer queue, after Dmitry Vyukov
+	template <typename T>
+	class mpmc_queue
+	{
+	public:
+		explicit mpmc_queue(size_t size)
+		: buffer(new cell[size])
+		, mask(size - 1)
+		, enqueue_pos(0)
+		, padding{0}
+		, dequeue_pos(0)
+		{
+			static_assert(::std::is_default_constructible<T>::value, "Queue elements must be default constructible.");
+			for (size_t i = 0; i < size; i++)
+			{
+				buffer[i].sequence.store(i, ::std::memory_order_relaxed);
+			}
+		}
+
+		bool push(T const & data)
+		{
+			size_t pos = enqueue_pos.load(::std::memory_order_relaxed);
+			for (;;)
+			{
+				cell & c = buffer[pos & mask];
+				size_t const seq = c.sequence.load(::std::memory_order_acquire);
+				intptr_t const diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0)
+				{
+					if (enqueue_pos.compare_exchange_weak(pos, pos + 1, ::std::memory_order_relaxed))
+					{
+						c.data = data;
+						c.sequence.store(pos + 1, ::std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = enqueue_pos.load(::std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool pop(T & data)
+		{
+			size_t pos = dequeue_pos.load(::std::memory_order_relaxed);
+			for (;;)
+			{
+				cell & c = buffer[pos & mask];
+				size_t const seq = c.sequence.load(::std::memory_order_acquire);
+				intptr_t const diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0)
+				{
+					if (dequeue_pos.compare_exchange_weak(pos, pos + 1, ::std::memory_order_relaxed))
+					{
+						data = c.data;
+						c.sequence.store(pos + mask + 1, ::std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = dequeue_pos.load(::std::memory_order_relaxed);
+				}
+			}
+		}
+
+	private:
+		struct cell
+		{
+			::std::atomic<size_t> sequence;
+			T data;
+		};
+
+		::std::unique_ptr<cell[]> buffer;
+		size_t const mask;
+		::std::atomic<size_t> enqueue_pos;
+		char padding[64]; // keeps producers and consumers off each other's cache line
+		::std::atomic<size_t> dequeue_pos;
+	};
+
+	// a job's nonce range is divided into chunks, and each worker owns a range of chunk indices [lo, hi)
+	// packed into a single word, so that the owner taking from the front and thieves taking from the back are a single CAS
+	struct job_t
+	{
+		job_t(uint64_t generation, h256_t const & header_hash, uint64_t start_nonce, uint64_t count, h256_t const & boundary, unsigned threads)
+		: generation(generation)
+		, header_hash(header_hash)
+		, boundary(boundary)
+		, start_nonce(start_nonce)
+		, count(count)
+		, chunk_size((std::max)(search_chunk_size, (count / ::std::numeric_limits<uint32_t>::max()) + 1))
+		, ranges(new ::std::atomic<uint64_t>[threads])
+		, running(threads)
+		{
+			// rounded up without forming count + chunk_size, which wraps for unbounded jobs
+			uint64_t const chunk_count = (count / chunk_size) + ((count % chunk_size) != 0);
+			for (unsigned i = 0; i < threads; i++)
+			{
+				ranges[i].store(pack((chunk_count * i) / threads, (chunk_count * (i + 1)) / threads), ::std::memory_order_relaxed);
+			}
+		}
+
+		static uint64_t pack(uint64_t lo, uint64_t hi) noexcept
+		{
+			return (lo << 32) | hi;
+		}
+
+		// take the next chunk from the front of the worker's own range
+		bool take(unsigned worker, uint64_t & chunk)
+		{
+			uint64_t range = ranges[worker].load(::std::memory_order_acquire);
+			for (;;)
+			{
+				uint64_t const lo = range >> 32, hi = range & 0xffffffff;
+				if (lo >= hi)
+				{
+					return false;
+				}
+				if (ranges[worker].compare_exchange_weak(range, pack(lo + 1, hi), ::std::memory_order_acq_rel))
+				{
+					chunk = lo;
+					return true;
+				}
+			}
+		}
+
+		// take the back half of another worker's range, keeping the first chunk of it and making the rest our own
+		bool steal(unsigned worker, unsigned threads, uint64_t & chunk)
+		{
+			for (unsigned i = 1; i < threads; i++)
+			{
+				unsigned const victim = (worker + i) % threads;
+				uint64_t range = ranges[victim].load(::std::memory_order_acquire);
+				for (;;)
+				{
+					uint64_t const lo = range >> 32, hi = range & 0xffffffff;
+					if (lo >= hi)
+					{
+						break;
+					}
+					uint64_t const mid = lo + ((hi - lo) / 2);
+					if (ranges[victim].compare_exchange_weak(range, pack(lo, mid), ::std::memory_order_acq_rel))
+					{
+						ranges[worker].store(pack(mid + 1, hi), ::std::memory_order_release);
+						chunk = mid;
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		uint64_t const generation;
+		h256_t const header_hash;
+		h256_t const boundary;
+		uint64_t const start_nonce;
+		uint64_t const count;
+		uint64_t const chunk_size;
+		::std::unique_ptr<::std::atomic<uint64_t>[]> ranges;
+		::std::atomic<unsigned> running;
+	};
+}
+
+namespace egihash
+{
+	bool meets_boundary(h256_t const & hash, h256_t const & boundary) noexcept
+	{
+		for (size_t i = 0; i < hash.hash_size; i += sizeof(uint64_t))
+		{
+			uint64_t const h = load_be64(&hash.b[i]);
+			uint64_t const b = load_be64(&boundary.b[i]);
+			if (h != b)
+			{
+				return h < b;
+			}
+		}
+		return true;
+	}
+
+	namespace full
+	{
+		struct search_t::impl_t
+		{
+			impl_t(dag_t const & dag, unsigned threads, thread_pool_t const & pool)
+			: dag(dag)
+			, pool(pool)
+			, thread_count((threads != 0) ? threads : pool.size())
+			, generation(0)
+			, hashes(0)
+			, solutions(solution_queue_size)
+			, mutex()
+			, done_cv()
+			, current()
+			, tasks(0)
+			{
+			}
+
+			// the workers of an abandoned job return within a batch, but they refer to this search until they do
+			~impl_t()
+			{
+				stop();
+				::std::unique_lock<::std::mutex> lock(mutex);
+				done_cv.wait(lock, [this]() { return tasks == 0; });
+			}
+
+			void set_job(h256_t const & header_hash, uint64_t start_nonce, uint64_t count, h256_t const & boundary)
+			{
+				::std::shared_ptr<job_t> job;
+				{
+					::std::lock_guard<::std::mutex> lock(mutex);
+					uint64_t const next = generation.load(::std::memory_order_relaxed) + 1;
+					job = ::std::make_shared<job_t>(next, header_hash, start_nonce, count, boundary, thread_count);
+					current = job;
+					generation.store(next, ::std::memory_order_release);
+					tasks += thread_count;
+				}
+				done_cv.notify_all();
+
+				for (unsigned i = 0; i < thread_count; i++)
+				{
+					pool.submit([this, job, i]() { work(*job, i); });
+				}
+			}
+
+			void stop()
+			{
+				{
+					::std::lock_guard<::std::mutex> lock(mutex);
+					current.reset();
+					generation.fetch_add(1, ::std::memory_order_release);
+				}
+				done_cv.notify_all();
+			}
+
+			bool finished() const
+			{
+				return !current || (current->running.load(::std::memory_order_acquire) == 0);
+			}
+
+			void work(job_t & job, unsigned worker)
+			{
+				bool const completed = run(job, worker) && (job.running.fetch_sub(1, ::std::memory_order_acq_rel) == 1);
+
+				// notified under the lock, as the search may be destroyed as soon as the last task is accounted for
+				::std::lock_guard<::std::mutex> lock(mutex);
+				tasks--;
+				if (completed || (tasks == 0))
+				{
+					done_cv.notify_all();
+				}
+			}
+
+			bool superseded(job_t const & job) const
+			{
+				return generation.load(::std::memory_order_relaxed) != job.generation;
+			}
+
+			// returns false if the job was replaced before it was finished
+			bool run(job_t & job, unsigned worker)
+			{
+				uint64_t chunk = 0;
+				while (job.take(worker, chunk) || job.steal(worker, thread_count, chunk))
+				{
+					uint64_t const first = chunk * job.chunk_size;
+					uint64_t const last = first + (std::min)(job.chunk_size, job.count - first);
+					for (uint64_t i = first; i < last; i += constants::HASH_BATCH_LANES)
+					{
+						if (superseded(job))
+						{
+							return false;
+						}
+
+						uint64_t nonces[constants::HASH_BATCH_LANES];
+						result_t results[constants::HASH_BATCH_LANES];
+						size_t const lane_count = static_cast<size_t>((std::min)(last - i, static_cast<uint64_t>(constants::HASH_BATCH_LANES)));
+						for (size_t l = 0; l < lane_count; l++)
+						{
+							nonces[l] = job.start_nonce + i + l;
+						}
+						full::hash_batch(dag, job.header_hash, nonces, lane_count, results);
+						hashes.fetch_add(lane_count, ::std::memory_order_relaxed);
+
+						for (size_t l = 0; l < lane_count; l++)
+						{
+							if (!meets_boundary(results[l].value, job.boundary))
+							{
+								continue;
+							}
+
+							solution_t solution;
+							solution.header_hash = job.header_hash;
+							solution.nonce = nonces[l];
+							solution.result = results[l];
+							while (!solutions.push(solution))
+							{
+								if (superseded(job))
+								{
+									return false;
+								}
+								::std::this_thread::yield();
+							}
+						}
+					}
+				}
+				return true;
+			}
+
+			dag_t const dag;
+			thread_pool_t const pool;
+			unsigned const thread_count;
+			::std::atomic<uint64_t> generation;
+			::std::atomic<uint64_t> hashes;
+			mpmc_queue<solution_t> solutions;
+			::std::mutex mutex;
+			::std::condition_variable done_cv;
+			::std::shared_ptr<job_t> current;
+			size_t tasks;
+		};
+
+		search_t::search_t(dag_t const & dag, unsigned threads, thread_pool_t const & pool)
+		: impl(new impl_t(dag, threads, pool))
+		{
+		}
+
+		search_t::~search_t()
+		{
+		}
+
+		void search_t::set_job(h256_t const & header_hash, uint64_t start_nonce, uint64_t count, h256_t const & boundary)
+		{
+			impl->set_job(header_hash, start_nonce, count, boundary);
+		}
+
+		void search_t::stop()
+		{
+			impl->stop();
+		}
+
+		void search_t::wait()
+		{
+			::std::unique_lock<::std::mutex> lock(impl->mutex);
+			impl->done_cv.wait(lock, [this]() { return impl->finished(); });
+		}
+
+		bool search_t::wait_for(::std::chrono::microseconds timeout)
+		{
+			::std::unique_lock<::std::mutex> lock(impl->mutex);
+			return impl->done_cv.wait_for(lock, timeout, [this]() { return impl->finished(); });
+		}
+
+		bool search_t::pop(solution_t & solution)
+		{
+			return impl->solutions.pop(solution);
+		}
+
+		uint64_t search_t::hash_count() const
+		{
+			return impl->hashes.load(::std::memory_order_relaxed);
+		}
+
+		unsigned search_t::threads() const
+		{
+			return impl->thread_count;
+		}
+
+		::std::vector<solution_t> search(dag_t const & dag, h256_t const & header_hash, uint64_t start_nonce, uint64_t count, h256_t const & boundary, unsigned threads, thread_pool_t const & pool)
+		{
+			search_t engine(dag, threads, pool);
+			engine.set_job(header_hash, start_nonce, count, boundary);
+
+			// drain while searching, as workers pause when the solution queue is full
+			::std::vector<solution_t> solutions;
+			solution_t solution;
+			bool finished = false;
+			while (!finished)
+			{
+				finished = engine.wait_for(::std::chrono::milliseconds(1));
+				while (engine.pop(solution))
+				{
+					solutions.push_back(solution);
+				}
+			}
+
+			::std::sort(solutions.begin(), solutions.end(), [](solution_t const & a, solution_t const & b) { return a.nonce < b.nonce; });
+			return solutions;
+		}
+	}
+}
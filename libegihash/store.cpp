@@ -0,0 +1,520 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "egihash.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace
+{
+	using namespace egihash;
+
+	static constexpr char file_prefix[] = "egihash-";
+	static constexpr char dag_extension[] = ".dag";
+	static constexpr char cache_extension[] = ".cache";
+	static constexpr char temp_extension[] = ".tmp";
+	static constexpr char resident_file_name[] = "resident";
+
+	// number of hex digits of the seedhash which are part of a file name
+	static constexpr size_t seedhash_digits = 16;
+
+	char const * extension(dag_store::file_kind kind)
+	{
+		return (kind == dag_store::dag_file) ? dag_extension : cache_extension;
+	}
+
+	bool ends_with(::std::string const & s, ::std::string const & suffix)
+	{
+		return (s.size() >= suffix.size()) && (s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0);
+	}
+
+	::std::string file_name(dag_store::file_kind kind, uint64_t epoch)
+	{
+		::std::ostringstream name;
+		name << file_prefix << epoch << "-" << cache_t::get_seedhash(epoch * constants::EPOCH_LENGTH).to_hex().substr(0, seedhash_digits) << extension(kind);
+		return name.str();
+	}
+
+	// parses egihash-<epoch>-<seedhash><extension>, checking that the seedhash belongs to the epoch
+	bool parse_file_name(::std::string const & name, dag_store::file_kind & kind, uint64_t & epoch)
+	{
+		if (name.compare(0, sizeof(file_prefix) - 1, file_prefix) != 0)
+		{
+			return false;
+		}
+
+		if (ends_with(name, dag_extension))
+		{
+			kind = dag_store::dag_file;
+		}
+		else if (ends_with(name, cache_extension))
+		{
+			kind = dag_store::cache_file;
+		}
+		else
+		{
+			return false;
+		}
+
+		char const * const digits = name.c_str() + sizeof(file_prefix) - 1;
+		if ((*digits < '0') || (*digits > '9'))
+		{
+			return false;
+		}
+		char * digits_end = nullptr;
+		errno = 0;
+		unsigned long long const parsed = ::std::strtoull(digits, &digits_end, 10);
+		if ((errno != 0) || (*digits_end != '-'))
+		{
+			return false;
+		}
+		epoch = static_cast<uint64_t>(parsed);
+
+		// the seedhash of an epoch is found by hashing forward from epoch 0, so the epoch of a stray file is bounded first
+		if (epoch >= constants::SEEDHASH_SEARCH_EPOCHS)
+		{
+			return false;
+		}
+
+		// checked against the name we would give this file rather than parsing the seedhash
+		return name == file_name(kind, epoch);
+	}
+
+	// partial writes are named .<name>.<pid>.tmp
+	bool is_abandoned_temp_file(::std::string const & name)
+	{
+		if ((name.empty()) || (name[0] != '.') || !ends_with(name, temp_extension))
+		{
+			return false;
+		}
+
+		::std::string const stem = name.substr(0, name.size() - (sizeof(temp_extension) - 1));
+		size_t const dot = stem.rfind('.');
+		if ((dot == ::std::string::npos) || (dot == 0))
+		{
+			return false;
+		}
+		char * pid_end = nullptr;
+		long const pid = ::std::strtol(stem.c_str() + dot + 1, &pid_end, 10);
+		if ((pid <= 0) || (*pid_end != '\0'))
+		{
+			return false;
+		}
+		return (::kill(static_cast<pid_t>(pid), 0) != 0) && (errno == ESRCH);
+	}
+
+	void make_directories(::std::string const & directory)
+	{
+		for (size_t pos = directory.find('/', 1); ; pos = directory.find('/', pos + 1))
+		{
+			::std::string const parent = directory.substr(0, pos);
+			if ((::mkdir(parent.c_str(), 0755) != 0) && (errno != EEXIST))
+			{
+				throw hash_exception("Could not create store directory.");
+			}
+			if (pos == ::std::string::npos)
+			{
+				break;
+			}
+		}
+	}
+
+	// makes renames within the directory durable
+	void sync_directory(::std::string const & directory)
+	{
+		int const fd = ::open(directory.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			::fsync(fd);
+			::close(fd);
+		}
+	}
+}
+
+namespace egihash
+{
+	constexpr dag_store::size_type dag_store::unlimited;
+
+	struct dag_store::impl_t
+	{
+		using entry_map = ::std::map<::std::pair<uint64_t /* epoch */, file_kind>, entry_t>;
+
+		impl_t(::std::string const & directory, size_type quota)
+		: directory(directory)
+		, quota(quota)
+		, entries()
+		, mutex()
+		{
+			while ((this->directory.size() > 1) && (this->directory.back() == '/'))
+			{
+				this->directory.pop_back();
+			}
+			if (this->directory.empty())
+			{
+				this->directory = ".";
+			}
+			make_directories(this->directory);
+			rescan();
+		}
+
+		void rescan()
+		{
+			DIR * dir = ::opendir(directory.c_str());
+			if (dir == nullptr)
+			{
+				throw hash_exception("Could not read store directory.");
+			}
+
+			entry_map found;
+			for (dirent * d = ::readdir(dir); d != nullptr; d = ::readdir(dir))
+			{
+				::std::string const name(d->d_name);
+				entry_t entry;
+				if (parse_file_name(name, entry.kind, entry.epoch))
+				{
+					struct stat st;
+					entry.path = directory + "/" + name;
+					if ((::stat(entry.path.c_str(), &st) == 0) && S_ISREG(st.st_mode))
+					{
+						entry.size = static_cast<size_type>(st.st_size);
+						found[::std::make_pair(entry.epoch, entry.kind)] = entry;
+					}
+				}
+				else if (is_abandoned_temp_file(name))
+				{
+					::unlink((directory + "/" + name).c_str());
+				}
+			}
+			::closedir(dir);
+
+			::std::lock_guard<::std::mutex> lock(mutex);
+			entries.swap(found);
+		}
+
+		::std::string path(file_kind kind, uint64_t epoch) const
+		{
+			return directory + "/" + file_name(kind, epoch);
+		}
+
+		size_type usage() const
+		{
+			size_type total = 0;
+			for (auto const & i : entries)
+			{
+				total += i.second.size;
+			}
+			return total;
+		}
+
+		// chooses entries to remove until the store would hold total bytes within its quota, the oldest epochs first, and the DAG
+		// of an epoch before its cache as it is the larger file. With newer_than, only epochs older than that entry are chosen.
+		// returns false if removing every candidate would not be enough, mutex must be held by the caller
+		bool choose_victims(size_type total, entry_map::key_type const * newer_than, ::std::vector<entry_map::key_type> & victims) const
+		{
+			if (quota == unlimited)
+			{
+				return true;
+			}
+
+			for (auto i = entries.begin(); (i != entries.end()) && (total > quota); ++i)
+			{
+				if ((newer_than != nullptr) && (i->first.first >= newer_than->first))
+				{
+					break;
+				}
+				total -= i->second.size;
+				victims.push_back(i->first);
+			}
+			return total <= quota;
+		}
+
+		// mutex must be held by the caller
+		::std::vector<entry_t> remove(::std::vector<entry_map::key_type> const & victims)
+		{
+			::std::vector<entry_t> removed;
+			for (auto const & key : victims)
+			{
+				auto const i = entries.find(key);
+				if ((::unlink(i->second.path.c_str()) != 0) && (errno != ENOENT))
+				{
+					throw hash_exception("Could not remove file from store.");
+				}
+				removed.push_back(i->second);
+				entries.erase(i);
+			}
+			return removed;
+		}
+
+		// the file is only written if it fits within the quota without removing newer epochs, and older epochs are only removed
+		// once it has been written, so a save which fails or is cancelled leaves the store as it was
+		template <typename SaveFunc>
+		bool store(file_kind kind, uint64_t epoch, size_type size, SaveFunc save)
+		{
+			auto const key = ::std::make_pair(epoch, kind);
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				auto const existing = entries.find(key);
+				size_type const replaced = (existing != entries.end()) ? existing->second.size : 0;
+				::std::vector<entry_map::key_type> victims;
+				if (!choose_victims(usage() - replaced + size, &key, victims))
+				{
+					return false;
+				}
+			}
+
+			::std::string const name = file_name(kind, epoch);
+			::std::ostringstream temp_name;
+			temp_name << directory << "/." << name << "." << ::getpid() << temp_extension;
+			::std::string const temp_path = temp_name.str();
+			try
+			{
+				fd_sink sink(temp_path);
+				save(sink);
+			}
+			catch (...)
+			{
+				::unlink(temp_path.c_str());
+				throw;
+			}
+
+			// the file only becomes visible under its final name once it has been completely written
+			entry_t entry{kind, epoch, directory + "/" + name, size};
+			if (::rename(temp_path.c_str(), entry.path.c_str()) != 0)
+			{
+				::unlink(temp_path.c_str());
+				throw hash_exception("Could not move file into store.");
+			}
+			sync_directory(directory);
+
+			// chosen again, as other writers may have changed the store meanwhile
+			::std::lock_guard<::std::mutex> lock(mutex);
+			entries[key] = entry;
+			::std::vector<entry_map::key_type> victims;
+			choose_victims(usage(), &key, victims);
+			remove(victims);
+			return true;
+		}
+
+		void record_resident() const
+		{
+			::std::string const final_path = directory + "/" + resident_file_name;
+			::std::ostringstream temp_name;
+			temp_name << directory << "/." << resident_file_name << "." << ::getpid() << temp_extension;
+			::std::string const temp_path = temp_name.str();
+
+			::std::ostringstream record;
+			for (auto const epoch : dag_t::get_loaded())
+			{
+				record << "dag " << epoch << "\n";
+			}
+			for (auto const epoch : cache_t::get_loaded())
+			{
+				record << "cache " << epoch << "\n";
+			}
+			::std::string const contents = record.str();
+
+			try
+			{
+				fd_sink sink(temp_path);
+				sink.write(contents.data(), contents.size());
+				sink.flush();
+			}
+			catch (...)
+			{
+				::unlink(temp_path.c_str());
+				throw;
+			}
+			if (::rename(temp_path.c_str(), final_path.c_str()) != 0)
+			{
+				::unlink(temp_path.c_str());
+				throw hash_exception("Could not record resident epochs.");
+			}
+			sync_directory(directory);
+		}
+
+		::std::vector<uint64_t> resident(file_kind kind) const
+		{
+			::std::vector<uint64_t> epochs;
+			::std::ifstream record(directory + "/" + resident_file_name);
+			::std::string kind_name;
+			uint64_t epoch = 0;
+			while (record >> kind_name >> epoch)
+			{
+				if (kind_name == ((kind == dag_file) ? "dag" : "cache"))
+				{
+					epochs.push_back(epoch);
+				}
+			}
+			return epochs;
+		}
+
+		::std::string directory;
+		size_type quota;
+		entry_map entries;
+		mutable ::std::mutex mutex;
+	};
+
+	dag_store::dag_store(::std::string const & directory, size_type quota)
+	: impl(new impl_t(directory, quota))
+	{
+		prune();
+	}
+
+	::std::string dag_store::directory() const
+	{
+		return impl->directory;
+	}
+
+	dag_store::size_type dag_store::quota() const
+	{
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		return impl->quota;
+	}
+
+	void dag_store::set_quota(size_type quota)
+	{
+		{
+			::std::lock_guard<::std::mutex> lock(impl->mutex);
+			impl->quota = quota;
+		}
+		prune();
+	}
+
+	dag_store::size_type dag_store::usage() const
+	{
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		return impl->usage();
+	}
+
+	void dag_store::rescan()
+	{
+		impl->rescan();
+	}
+
+	::std::vector<dag_store::entry_t> dag_store::entries() const
+	{
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		::std::vector<entry_t> ret;
+		ret.reserve(impl->entries.size());
+		for (auto const & i : impl->entries)
+		{
+			ret.push_back(i.second);
+		}
+		return ret;
+	}
+
+	bool dag_store::contains(file_kind kind, uint64_t epoch) const
+	{
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		return impl->entries.find(::std::make_pair(epoch, kind)) != impl->entries.end();
+	}
+
+	::std::string dag_store::path(file_kind kind, uint64_t epoch) const
+	{
+		return impl->path(kind, epoch);
+	}
+
+	dag_t dag_store::get_dag(uint64_t epoch, progress_callback_type callback)
+	{
+		if (contains(dag_file, epoch))
+		{
+			return dag_t(path(dag_file, epoch), callback);
+		}
+
+		dag_t dag(epoch * constants::EPOCH_LENGTH, callback);
+		store(dag, callback);
+		return dag;
+	}
+
+	cache_t dag_store::get_cache(uint64_t epoch, progress_callback_type callback)
+	{
+		if (contains(cache_file, epoch))
+		{
+			return cache_t(path(cache_file, epoch), callback);
+		}
+
+		cache_t cache(epoch * constants::EPOCH_LENGTH, callback);
+		store(cache, callback);
+		return cache;
+	}
+
+	bool dag_store::store(dag_t const & dag, progress_callback_type callback)
+	{
+		size_type const size = constants::DAG_FILE_HEADER_SIZE + dag.get_cache().size() + dag.size() + constants::DAG_FILE_TRAILER_SIZE;
+		return impl->store(dag_file, dag.epoch(), size, [&](sink_t & sink) { dag.save(sink, callback); });
+	}
+
+	bool dag_store::store(cache_t const & cache, progress_callback_type callback)
+	{
+		size_type const size = constants::CACHE_FILE_HEADER_SIZE + cache.size();
+		return impl->store(cache_file, cache.epoch(), size, [&](sink_t & sink) { cache.save(sink, callback); });
+	}
+
+	::std::vector<dag_store::entry_t> dag_store::prune()
+	{
+		::std::lock_guard<::std::mutex> lock(impl->mutex);
+		::std::vector<impl_t::entry_map::key_type> victims;
+		impl->choose_victims(impl->usage(), nullptr, victims);
+		return impl->remove(victims);
+	}
+
+	void dag_store::record_resident() const
+	{
+		impl->record_resident();
+	}
+
+	::std::vector<uint64_t> dag_store::resident(file_kind kind) const
+	{
+		return impl->resident(kind);
+	}
+
+	::std::future<void> dag_store::warm(progress_callback_type callback, thread_pool_t const & pool) const
+	{
+		dag_store const store(*this);
+		auto const promise = ::std::make_shared<::std::promise<void>>();
+		::std::future<void> ret = promise->get_future();
+		pool.submit([store, callback, promise]()
+		{
+			try
+			{
+				// DAGs first, as loading a DAG file also loads its cache
+				for (auto const epoch : store.resident(dag_file))
+				{
+					if (store.contains(dag_file, epoch) && !dag_t::is_loaded(epoch))
+					{
+						dag_t(store.path(dag_file, epoch), callback);
+					}
+				}
+				for (auto const epoch : store.resident(cache_file))
+				{
+					if (store.contains(cache_file, epoch) && !cache_t::is_loaded(epoch))
+					{
+						cache_t(store.path(cache_file, epoch), callback);
+					}
+				}
+				promise->set_value();
+			}
+			catch (...)
+			{
+				promise->set_exception(::std::current_exception());
+			}
+		}, priority_background);
+		return ret;
+	}
+}
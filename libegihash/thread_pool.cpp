@@ -0,0 +1,424 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "egihash.h"
+#include "topology.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace
+{
+	using namespace egihash;
+
+	// the tasks of one thread, which takes the newest while thieves take the oldest
+	class task_queue_t
+	{
+	public:
+		void push(thread_pool_t::task_type const & task)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			tasks.push_back(task);
+		}
+
+		bool pop(thread_pool_t::task_type & task)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			if (tasks.empty())
+			{
+				return false;
+			}
+			task = ::std::move(tasks.back());
+			tasks.pop_back();
+			return true;
+		}
+
+		bool steal(thread_pool_t::task_type & task)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			if (tasks.empty())
+			{
+				return false;
+			}
+			task = ::std::move(tasks.front());
+			tasks.pop_front();
+			return true;
+		}
+
+	private:
+		::std::mutex mutex;
+		::std::deque<thread_pool_t::task_type> tasks;
+	};
+
+	// the CPUs the process may run on
+	::std::vector<uint32_t> usable_cpus()
+	{
+		::std::vector<uint32_t> cpus;
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+		{
+			for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			{
+				if (CPU_ISSET(cpu, &set))
+				{
+					cpus.push_back(cpu);
+				}
+			}
+		}
+#endif
+		return cpus;
+	}
+
+	// keeps the first hardware thread of each core, CPUs whose siblings are unknown are kept
+	::std::vector<uint32_t> one_per_core(::std::vector<uint32_t> const & cpus)
+	{
+		::std::vector<uint32_t> ret;
+		for (auto const cpu : cpus)
+		{
+			auto const siblings = topology::parse_id_list(topology::read_sysfs_line("/sys/devices/system/cpu/cpu" + ::std::to_string(cpu) + "/topology/thread_siblings_list"));
+			if (siblings.empty() || (cpu == *::std::min_element(siblings.begin(), siblings.end())))
+			{
+				ret.push_back(cpu);
+			}
+		}
+		return ret;
+	}
+
+	// construct on first use ensures safe static initialization order
+	::std::mutex & get_default_pool_mutex()
+	{
+		static ::std::mutex mutex;
+		return mutex;
+	}
+
+	::std::shared_ptr<thread_pool_t> & get_default_pool()
+	{
+		static ::std::shared_ptr<thread_pool_t> pool;
+		return pool;
+	}
+}
+
+namespace egihash
+{
+	struct thread_pool_t::impl_t
+	{
+		explicit impl_t(thread_pool_options_t const & options)
+		: queues()
+		, background()
+		, mutex()
+		, cv()
+		, background_cv()
+		, queued(0)
+		, background_queued(0)
+		, next_queue(0)
+		, stopping(false)
+		, has_background(options.background_threads != 0)
+		, workers()
+		{
+			using namespace std;
+
+			vector<uint32_t> cpus(options.cpus.begin(), options.cpus.end());
+			bool const pin = !cpus.empty() || (options.smt == smt_one_per_core);
+			if (cpus.empty() && pin)
+			{
+				cpus = usable_cpus();
+			}
+			if (options.smt == smt_one_per_core)
+			{
+				cpus = one_per_core(cpus);
+			}
+
+			unsigned const thread_count = (options.threads != 0) ? options.threads
+					: ((pin && !cpus.empty()) ? static_cast<unsigned>(cpus.size()) : (max)(1u, thread::hardware_concurrency()));
+			queues.reserve(thread_count);
+			for (unsigned i = 0; i < thread_count; i++)
+			{
+				queues.emplace_back(new task_queue_t());
+			}
+
+			workers.reserve(thread_count + options.background_threads);
+			for (unsigned i = 0; i < thread_count; i++)
+			{
+				vector<uint32_t> const cpu = (pin && !cpus.empty()) ? vector<uint32_t>{ cpus[i % cpus.size()] } : vector<uint32_t>();
+				workers.emplace_back([this, i, cpu]()
+				{
+					if (!cpu.empty())
+					{
+						topology::pin_thread(cpu);
+					}
+					work(i);
+				});
+			}
+			for (unsigned i = 0; i < options.background_threads; i++)
+			{
+				workers.emplace_back([this]()
+				{
+					topology::lower_thread_priority();
+					work_background();
+				});
+			}
+		}
+
+		// every task which was submitted is run before the threads exit
+		~impl_t()
+		{
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				stopping = true;
+			}
+			cv.notify_all();
+			background_cv.notify_all();
+			for (auto & worker : workers)
+			{
+				// the last copy of a pool may be dropped by one of its own tasks
+				if (worker.get_id() == ::std::this_thread::get_id())
+				{
+					worker.detach();
+				}
+				else
+				{
+					worker.join();
+				}
+			}
+		}
+
+		void submit(task_type const & task, task_priority priority)
+		{
+			if ((priority == priority_background) && has_background)
+			{
+				background.push(task);
+				background_queued.fetch_add(1, ::std::memory_order_release);
+				{
+					::std::lock_guard<::std::mutex> lock(mutex);
+				}
+				background_cv.notify_one();
+				return;
+			}
+
+			size_t const index = (current_pool == this) ? current_index : (next_queue.fetch_add(1, ::std::memory_order_relaxed) % queues.size());
+			queues[index]->push(task);
+			queued.fetch_add(1, ::std::memory_order_release);
+			{
+				// waiting threads check queued under the mutex, so the notification can not slip in between their check and their wait
+				::std::lock_guard<::std::mutex> lock(mutex);
+			}
+			cv.notify_one();
+		}
+
+		bool take(size_t index, task_type & task)
+		{
+			if (queues[index]->pop(task))
+			{
+				return true;
+			}
+			for (size_t i = 1; i < queues.size(); i++)
+			{
+				if (queues[(index + i) % queues.size()]->steal(task))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		static void run(task_type const & task) noexcept
+		{
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+			}
+		}
+
+		void work(size_t index)
+		{
+			current_pool = this;
+			current_index = index;
+			for (;;)
+			{
+				task_type task;
+				if (take(index, task))
+				{
+					queued.fetch_sub(1, ::std::memory_order_relaxed);
+					run(task);
+					continue;
+				}
+
+				::std::unique_lock<::std::mutex> lock(mutex);
+				cv.wait(lock, [this]() { return stopping || (queued.load(::std::memory_order_acquire) != 0); });
+				if (stopping && (queued.load(::std::memory_order_acquire) == 0))
+				{
+					return;
+				}
+			}
+		}
+
+		void work_background()
+		{
+			for (;;)
+			{
+				task_type task;
+				if (background.steal(task))
+				{
+					background_queued.fetch_sub(1, ::std::memory_order_relaxed);
+					run(task);
+					continue;
+				}
+
+				::std::unique_lock<::std::mutex> lock(mutex);
+				background_cv.wait(lock, [this]() { return stopping || (background_queued.load(::std::memory_order_acquire) != 0); });
+				if (stopping && (background_queued.load(::std::memory_order_acquire) == 0))
+				{
+					return;
+				}
+			}
+		}
+
+		// the pool and queue of the calling thread, if it is a foreground thread of a pool
+		static thread_local impl_t const * current_pool;
+		static thread_local size_t current_index;
+
+		::std::vector<::std::unique_ptr<task_queue_t>> queues;
+		task_queue_t background;
+		::std::mutex mutex;
+		::std::condition_variable cv;
+		::std::condition_variable background_cv;
+		::std::atomic<size_t> queued;
+		::std::atomic<size_t> background_queued;
+		::std::atomic<size_t> next_queue;
+		bool stopping;
+		bool const has_background;
+		::std::vector<::std::thread> workers;
+	};
+
+	thread_local thread_pool_t::impl_t const * thread_pool_t::impl_t::current_pool = nullptr;
+	thread_local size_t thread_pool_t::impl_t::current_index = 0;
+
+	thread_pool_t::thread_pool_t()
+	: thread_pool_t(thread_pool_options_t{ 0, 2, {}, smt_all })
+	{
+	}
+
+	thread_pool_t::thread_pool_t(thread_pool_options_t const & options)
+	: impl(new impl_t(options))
+	{
+	}
+
+	unsigned thread_pool_t::size() const
+	{
+		return static_cast<unsigned>(impl->queues.size());
+	}
+
+	void thread_pool_t::submit(task_type const & task, task_priority priority) const
+	{
+		impl->submit(task, priority);
+	}
+
+	void thread_pool_t::parallel_for(::std::size_t count, ::std::function<void(::std::size_t index)> const & body) const
+	{
+		using namespace std;
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		// indices are handed out one at a time, so whichever threads get to the tasks first share out the work
+		// helpers which start after every index was handed out return without touching the body, but the state outlives this call for them
+		struct state_t
+		{
+			explicit state_t(size_t count, function<void(size_t)> const & body)
+			: body(body)
+			, count(count)
+			, next(0)
+			, active(0)
+			, mutex()
+			, cv()
+			, error()
+			{
+			}
+
+			void run()
+			{
+				active.fetch_add(1, memory_order_acq_rel);
+				for (size_t i = next++; i < count; i = next++)
+				{
+					try
+					{
+						body(i);
+					}
+					catch (...)
+					{
+						lock_guard<std::mutex> lock(mutex);
+						if (!error)
+						{
+							error = current_exception();
+						}
+						next = count;
+					}
+				}
+				if (active.fetch_sub(1, memory_order_acq_rel) == 1)
+				{
+					lock_guard<std::mutex> lock(mutex);
+					cv.notify_all();
+				}
+			}
+
+			function<void(size_t)> const body;
+			size_t const count;
+			atomic<size_t> next;
+			atomic<size_t> active;
+			std::mutex mutex;
+			condition_variable cv;
+			exception_ptr error;
+		};
+
+		auto const state = make_shared<state_t>(count, body);
+		size_t const helpers = (min)(count, static_cast<size_t>(size())) - 1;
+		for (size_t i = 0; i < helpers; i++)
+		{
+			impl->submit([state]() { state->run(); }, priority_foreground);
+		}
+		state->run();
+
+		unique_lock<std::mutex> lock(state->mutex);
+		state->cv.wait(lock, [&state]() { return state->active.load(memory_order_acquire) == 0; });
+		if (state->error)
+		{
+			rethrow_exception(state->error);
+		}
+	}
+
+	thread_pool_t thread_pool_t::get_default()
+	{
+		::std::lock_guard<::std::mutex> lock(get_default_pool_mutex());
+		auto & pool = get_default_pool();
+		if (!pool)
+		{
+			pool = ::std::make_shared<thread_pool_t>();
+		}
+		return *pool;
+	}
+
+	void thread_pool_t::set_default(thread_pool_t const & pool)
+	{
+		::std::lock_guard<::std::mutex> lock(get_default_pool_mutex());
+		get_default_pool() = ::std::make_shared<thread_pool_t>(pool);
+	}
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2017 Ryan Lucchese
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// reading the CPU and NUMA topology of the system from sysfs, and pinning threads to CPUs or lowering their priority
+namespace egihash
+{
+	namespace topology
+	{
+		// CPU and node lists in the format of sysfs, e.g. "0-3,8-11"
+		inline ::std::vector<uint32_t> parse_id_list(::std::string const & list)
+		{
+			::std::vector<uint32_t> ids;
+			::std::istringstream ss(list);
+			::std::string range;
+			while (::std::getline(ss, range, ','))
+			{
+				unsigned long first = 0;
+				unsigned long last = 0;
+				int const fields = ::std::sscanf(range.c_str(), "%lu-%lu", &first, &last);
+				if (fields < 1)
+				{
+					continue;
+				}
+				for (unsigned long i = first; i <= ((fields == 2) ? last : first); i++)
+				{
+					ids.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			return ids;
+		}
+
+		inline ::std::string read_sysfs_line(::std::string const & path)
+		{
+			::std::ifstream file(path);
+			::std::string line;
+			::std::getline(file, line);
+			return line;
+		}
+
+		// restricts the calling thread to a set of CPUs, fails for an empty set
+		inline bool pin_thread(::std::vector<uint32_t> const & cpus) noexcept
+		{
+#if defined(__linux__)
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			bool any = false;
+			for (auto const cpu : cpus)
+			{
+				if (cpu < CPU_SETSIZE)
+				{
+					CPU_SET(cpu, &set);
+					any = true;
+				}
+			}
+			return any && (::sched_setaffinity(0, sizeof(set), &set) == 0);
+#else
+			(void)cpus;
+			return false;
+#endif
+		}
+
+		// background threads run this much nicer than the process, so the scheduler favours foreground threads over them
+		static constexpr int background_nice = 10;
+
+		// lowers the scheduling priority of the calling thread only, on a best effort basis
+		inline void lower_thread_priority() noexcept
+		{
+#if defined(__linux__) && defined(SYS_gettid)
+			id_t const thread_id = static_cast<id_t>(::syscall(SYS_gettid));
+			errno = 0;
+			int const nice = ::getpriority(PRIO_PROCESS, thread_id);
+			if (errno == 0)
+			{
+				::setpriority(PRIO_PROCESS, thread_id, (::std::min)(nice + background_nice, 19));
+			}
+#endif
+		}
+	}
+}
@@ -16,19 +16,29 @@
 #include <cstdint>
 #include <iomanip>
 #include "egihash.h"
+#include "../libegihash/fast_divisor.h"
 
 #ifdef _WIN32
 #include <windows.h>
 #include <Shlobj.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 
 #include <iostream>
 #include <functional>
+#include <limits>
 #include <fstream>
 #include <vector>
 #include <memory>
 #include <tuple>
 #include <random>
+#include <thread>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <boost/filesystem.hpp>
 #include <boost/tokenizer.hpp>
 
@@ -132,11 +142,24 @@ namespace
 		for (size_t i = 0; i < 32; i++)
 		{
 			auto const ptr = hex.c_str();
-			char hexpair[] = { ptr[i*2], ptr[i*2 + 1] };
+			char hexpair[] = { ptr[i*2], ptr[i*2 + 1], 0 };
 			ret.b[i] = static_cast<uint8_t>(stoi(hexpair, nullptr, 16));
 		}
 		return ret;
 	}
+
+	// the first header hash test vector for epoch 0, which is hashed with nonce 0
+	egihash::h256_t epoch0_header_hash()
+	{
+		return HashFromHex("9fa68736cb13eb975356e1f9abd403219557b3b9ec5b3d483130c12ced9efd82");
+	}
+
+	// checks a hash of epoch0_header_hash() with nonce 0 against the first test vector for epoch 0
+	void check_epoch0_vector(egihash::result_t const & actual)
+	{
+		BOOST_CHECK(actual.value.to_hex() == "fbf6ec7e3b9d667583f260d7c6b1eaf46092438c5e67533d612e045e3b7a294a");
+		BOOST_CHECK(actual.mixhash.to_hex() == "57560655785659264cd68c6835c6e8faa5e7c134f4fe18ae869c22b37707b04f");
+	}
 }
 
 BOOST_AUTO_TEST_SUITE(Keccak);
@@ -306,6 +329,53 @@ BOOST_AUTO_TEST_CASE(headerhashes)
 	}
 }
 
+// test generating the caches of several epochs at once, within the cache cache budget
+BOOST_AUTO_TEST_CASE(cache_prepare_range)
+{
+	using namespace std;
+	using namespace egihash;
+
+	auto const unload_all = []()
+	{
+		for (auto const epoch : cache_t::get_loaded())
+		{
+			cache_t(epoch * constants::EPOCH_LENGTH).unload();
+		}
+	};
+	unload_all();
+
+	h256_t const header_hash = epoch0_header_hash();
+	BOOST_CHECK(cache_t::prepare_range(2, 4, 2) == (vector<uint64_t>{ 2, 3, 4 }));
+	BOOST_CHECK(cache_t::get_loaded() == (vector<uint64_t>{ 2, 3, 4 }));
+	BOOST_CHECK(cache_t::prepare_range(3, 2).empty());
+
+	// caches prepared together are the same as a cache generated on its own
+	result_t const prepared = light::hash(cache_t(3 * constants::EPOCH_LENGTH), header_hash, 0);
+	unload_all();
+	BOOST_CHECK(light::hash(cache_t(3 * constants::EPOCH_LENGTH), header_hash, 0) == prepared);
+	unload_all();
+
+	// preparing stops at the first epoch which does not fit in the budget
+	cache_t::size_type const sizes[] =
+	{
+		cache_t::get_cache_size(2 * constants::EPOCH_LENGTH),
+		cache_t::get_cache_size(3 * constants::EPOCH_LENGTH),
+		cache_t::get_cache_size(4 * constants::EPOCH_LENGTH)
+	};
+	cache_t::set_memory_budget(sizes[0] + sizes[1] + (sizes[2] / 2));
+	BOOST_CHECK(cache_t::get_memory_budget() == (sizes[0] + sizes[1] + (sizes[2] / 2)));
+	BOOST_CHECK(cache_t::prepare_range(2, 5) == (vector<uint64_t>{ 2, 3 }));
+	BOOST_CHECK(!cache_t::is_loaded(4));
+
+	// a cache which takes the cache cache over budget unloads the least recently used
+	BOOST_CHECK(cache_t(2 * constants::EPOCH_LENGTH).epoch() == 2);
+	cache_t const c4(4 * constants::EPOCH_LENGTH);
+	BOOST_CHECK(cache_t::get_loaded() == (vector<uint64_t>{ 2, 4 }));
+
+	cache_t::set_memory_budget(0);
+	unload_all();
+}
+
 BOOST_AUTO_TEST_CASE(seedhash_test)
 {
 	using namespace egihash;
@@ -587,4 +657,1345 @@ BOOST_AUTO_TEST_CASE(cache_cache)
 	BOOST_ASSERT(success);
 }
 
+// test that DAG verification passes on a good DAG and rejects a corrupted DAG file
+BOOST_AUTO_TEST_CASE(dag_verification)
+{
+	using namespace std;
+	using namespace egihash;
+
+	if (!boost::filesystem::exists( "data/egihash.dag" ))
+	{
+		egihash::dag_t dag(0, dag_progress);
+		dag.save("data/egihash.dag");
+	}
+
+	{
+		dag_t d("data/egihash.dag", dag_progress);
+		BOOST_ASSERT(d.verify(verify_none));
+		BOOST_ASSERT(d.verify(verify_sampled));
+		BOOST_ASSERT(d.verify(verify_checksum));
+
+		// full verification is cancellable
+		auto cancel = [](::std::size_t, ::std::size_t, int) -> bool { return false; };
+		BOOST_CHECK_THROW(d.verify(verify_full, constants::VERIFY_SAMPLE_COUNT, cancel), hash_exception);
+		d.unload();
+	}
+
+	// zero a region near the end of the DAG data as if the file had been truncated and padded
+	fs::path const corruptPath = fs::current_path() / "data" / "egihash_corrupt.dag";
+	fs::remove(corruptPath);
+	fs::copy_file("data/egihash.dag", corruptPath);
+	{
+		constexpr size_t CORRUPT_SIZE = 16 * 1024 * 1024;
+		auto const filesize = fs::file_size(corruptPath);
+		fstream corrupt(corruptPath.string().c_str(), ios::in | ios::out | ios::binary);
+		BOOST_REQUIRE(corrupt.is_open());
+		corrupt.seekp(filesize - (2 * CORRUPT_SIZE));
+		vector<char> const zeroes(CORRUPT_SIZE, 0);
+		corrupt.write(zeroes.data(), zeroes.size());
+	}
+
+	auto const policy = dag_t::get_verify_policy();
+	BOOST_ASSERT(policy.mode == verify_sampled);
+	BOOST_CHECK_THROW(dag_t(corruptPath.string(), dag_progress), hash_exception);
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+
+	fs::remove(corruptPath);
+}
+
+// test polling progress from another thread, and cancelling work through a token
+BOOST_AUTO_TEST_CASE(progress_cancel_token)
+{
+	using namespace std;
+	using namespace egihash;
+
+	// counters are kept per phase, and a cancelled token stops the next report
+	progress_t const progress;
+	BOOST_CHECK(progress(10, 100, cache_seeding));
+	BOOST_CHECK(progress.advance(5, 100, cache_seeding));
+	BOOST_CHECK(progress.step(cache_seeding) == 15);
+	BOOST_CHECK(progress.max(cache_seeding) == 100);
+	BOOST_CHECK(progress.step(dag_loading) == 0);
+	BOOST_CHECK(progress.phase() == cache_seeding);
+	progress.get_cancel_token().cancel();
+	BOOST_CHECK(progress.is_cancelled());
+	BOOST_CHECK(!progress(20, 100, cache_seeding));
+
+	// a callback is adapted by progress which it observes, and returning false from it cancels
+	size_t observed = 0;
+	progress_t const adapted = progress_t::from_callback([&observed](size_t step, size_t, progress_callback_phase) { observed = step; return step < 50; });
+	BOOST_CHECK(adapted(10, 100, dag_generation));
+	BOOST_CHECK(observed == 10);
+	BOOST_CHECK(!adapted(60, 100, dag_generation));
+	BOOST_CHECK(adapted.is_cancelled());
+	progress_callback_type const callback = progress;
+	BOOST_CHECK(progress_t::from_callback(callback).impl == progress.impl);
+
+	// reports may be dropped while the observer is busy with another one, but never the last one of a phase
+	atomic<bool> entered(false);
+	atomic<bool> release(false);
+	size_t last_observed = 0;
+	progress_t const busy(cancel_token_t(), [&](size_t step, size_t, progress_callback_phase)
+	{
+		entered = true;
+		while (!release)
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+		last_observed = step;
+		return true;
+	});
+	thread first([&busy]() { busy.advance(1, 2, dag_generation); });
+	while (!entered)
+	{
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	thread releaser([&release]()
+	{
+		this_thread::sleep_for(chrono::milliseconds(50));
+		release = true;
+	});
+	BOOST_CHECK(busy.advance(1, 2, dag_generation));
+	first.join();
+	releaser.join();
+	BOOST_CHECK(last_observed == 2);
+
+	// the last report of a generation is the whole phase, so a monitor sees it complete
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	progress_t const generating;
+	dag_t const d(0, generating);
+	BOOST_CHECK(generating.max(dag_generation) == (dag_t::get_full_size(0) / constants::HASH_BYTES));
+	BOOST_CHECK(generating.step(dag_generation) == generating.max(dag_generation));
+
+	// every worker of a full verification checks the token, so cancelling from a monitor thread stops it part way through
+	// the phase is qualified, as the dag_verification test case hides it
+	size_t const item_count = dag_t::get_full_size(0) / constants::HASH_BYTES;
+	cancel_token_t const token;
+	progress_t const verifying(token);
+	thread monitor([&]()
+	{
+		while ((verifying.step(egihash::dag_verification) < (item_count / 8)) && !verifying.is_cancelled())
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+		token.cancel();
+	});
+	BOOST_CHECK_THROW(d.verify(verify_full, constants::VERIFY_SAMPLE_COUNT, verifying), hash_exception);
+	monitor.join();
+	BOOST_CHECK(verifying.max(egihash::dag_verification) == item_count);
+	BOOST_CHECK(verifying.step(egihash::dag_verification) >= (item_count / 8));
+	BOOST_CHECK(verifying.step(egihash::dag_verification) < item_count);
+
+	// work which reports in one thread is cancelled by the token too
+	progress_t const saving;
+	saving.cancel();
+	boost::filesystem::path const path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	BOOST_CHECK_THROW(d.save(path.string(), saving), hash_exception);
+	boost::filesystem::remove(path);
+	d.unload();
+}
+
+// test saving a cache to a standalone cache file and loading it back through the cache cache
+BOOST_AUTO_TEST_CASE(cache_file)
+{
+	using namespace std;
+	using namespace egihash;
+
+	fs::path const cachePath = fs::current_path() / "data" / "egihash_test.cache";
+	{
+		cache_t c(0, dag_progress);
+		c.save(cachePath.string());
+		c.unload();
+	}
+	BOOST_ASSERT(fs::file_size(cachePath) == (constants::CACHE_FILE_HEADER_SIZE + cache_t::get_cache_size(0)));
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+
+	bool loaded = false;
+	auto loading = [&loaded](::std::size_t, ::std::size_t, int phase) -> bool
+	{
+		loaded = loaded || (phase == cache_loading);
+		return true;
+	};
+
+	cache_t c1(cachePath.string(), loading);
+	BOOST_ASSERT(loaded);
+	BOOST_ASSERT(cache_t::is_loaded(0));
+	BOOST_ASSERT(c1.seedhash() == cache_t::get_seedhash(0));
+
+	h256_t const headerhash = epoch0_header_hash();
+	check_epoch0_vector(light::hash(c1, headerhash, 0));
+
+	// an already loaded cache is returned from the cache cache without reading the file
+	loaded = false;
+	cache_t c2(cachePath.string(), loading);
+	BOOST_ASSERT(!loaded);
+	BOOST_ASSERT(c1.data().data() == c2.data().data());
+
+	// saving back to the file a cache was loaded from replaces the file rather than rewriting the loaded pages
+	c1.save(cachePath.string());
+	check_epoch0_vector(light::hash(c1, headerhash, 0));
+	c1.save(cachePath.string());
+	BOOST_CHECK(fs::file_size(cachePath) == (constants::CACHE_FILE_HEADER_SIZE + cache_t::get_cache_size(0)));
+	c1.unload();
+	{
+		cache_t const reloaded(cachePath.string());
+		check_epoch0_vector(light::hash(reloaded, headerhash, 0));
+		reloaded.unload();
+	}
+
+	// corrupt a byte of cache data
+	{
+		fstream corrupt(cachePath.string().c_str(), ios::in | ios::out | ios::binary);
+		BOOST_REQUIRE(corrupt.is_open());
+		corrupt.seekg(constants::CACHE_FILE_HEADER_SIZE + 1000);
+		char const byte = static_cast<char>(corrupt.get());
+		corrupt.seekp(constants::CACHE_FILE_HEADER_SIZE + 1000);
+		corrupt.put(static_cast<char>(~byte));
+	}
+	BOOST_CHECK_THROW(cache_t(cachePath.string()), hash_exception);
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+
+	fs::remove(cachePath);
+	BOOST_CHECK_THROW(cache_t(cachePath.string()), hash_exception);
+}
+
+// test streaming a cache through the memory, callback and file descriptor sources and sinks
+BOOST_AUTO_TEST_CASE(bulk_io)
+{
+	using namespace std;
+	using namespace egihash;
+
+	auto const fileSize = constants::CACHE_FILE_HEADER_SIZE + cache_t::get_cache_size(0);
+	vector<uint8_t> saved(fileSize);
+	{
+		cache_t c(0, dag_progress);
+		memory_sink sink(saved.data(), saved.size());
+		c.save(sink);
+		BOOST_ASSERT(sink.written() == fileSize);
+
+		// a sink which runs out of space fails instead of truncating
+		vector<uint8_t> small(fileSize / 2);
+		memory_sink small_sink(small.data(), small.size());
+		BOOST_CHECK_THROW(c.save(small_sink), hash_exception);
+
+		// the callback sink sees exactly the same bytes
+		vector<uint8_t> streamed;
+		callback_sink stream_sink([&streamed](void const * src, size_t count)
+		{
+			uint8_t const * ptr = reinterpret_cast<uint8_t const *>(src);
+			streamed.insert(streamed.end(), ptr, ptr + count);
+		});
+		c.save(stream_sink);
+		BOOST_ASSERT(streamed == saved);
+		c.unload();
+	}
+
+	h256_t const headerhash = epoch0_header_hash();
+	auto check_cache = [&headerhash](cache_t const & c)
+	{
+		check_epoch0_vector(light::hash(c, headerhash, 0));
+	};
+
+	{
+		memory_source source(saved.data(), saved.size());
+		cache_t c(source);
+		BOOST_ASSERT(source.remaining() == 0);
+		BOOST_CHECK(reinterpret_cast<uint8_t const *>(c.data().data()) != (saved.data() + constants::CACHE_FILE_HEADER_SIZE));
+		check_cache(c);
+		c.unload();
+	}
+
+	// memory with an owner is pointed at rather than copied, and outlives the source
+	{
+		shared_ptr<vector<uint8_t>> const owned = make_shared<vector<uint8_t>>(saved);
+		unique_ptr<memory_source> source(new memory_source(owned->data(), owned->size(), owned));
+		cache_t c(*source);
+		source.reset();
+		BOOST_CHECK(reinterpret_cast<uint8_t const *>(c.data().data()) == (owned->data() + constants::CACHE_FILE_HEADER_SIZE));
+		check_cache(c);
+		c.unload();
+	}
+
+	{
+		size_t offset = 0;
+		callback_source source([&saved, &offset](void * dst, size_t count)
+		{
+			memcpy(dst, saved.data() + offset, count);
+			offset += count;
+		});
+		cache_t c(source);
+		BOOST_ASSERT(offset == fileSize);
+		check_cache(c);
+		c.unload();
+	}
+
+	fs::path const cachePath = fs::current_path() / "data" / "egihash_bulk_io.cache";
+	{
+		fd_sink sink(cachePath.string());
+		sink.write(saved.data(), saved.size());
+		sink.flush();
+	}
+	BOOST_ASSERT(fs::file_size(cachePath) == fileSize);
+	{
+		fd_source source(cachePath.string());
+		BOOST_ASSERT(source.remaining() == fileSize);
+		BOOST_CHECK(source.view(1) == nullptr);
+		BOOST_CHECK(!source.view_owner());
+		BOOST_ASSERT(source.remaining() == fileSize);
+		cache_t c(source);
+		check_cache(c);
+		c.unload();
+	}
+
+	// a cache loaded from a mapped file copies the file's pages, unless the mapping is lent to it
+	{
+		mmap_source source(cachePath.string());
+		BOOST_CHECK(!source.view_owner());
+		cache_t c(source);
+		check_cache(c);
+		c.unload();
+	}
+	{
+		unique_ptr<mmap_source> source(new mmap_source(cachePath.string(), true));
+		shared_ptr<void const> const mapping = source->view_owner();
+		BOOST_REQUIRE(mapping);
+		cache_t c(*source);
+		source.reset();
+		BOOST_CHECK(reinterpret_cast<uint8_t const *>(c.data().data()) == (reinterpret_cast<uint8_t const *>(mapping.get()) + constants::CACHE_FILE_HEADER_SIZE));
+		check_cache(c);
+
+		// the lent pages stay valid when the file is saved over
+		c.save(cachePath.string());
+		check_cache(c);
+		c.unload();
+	}
+
+	// a truncated stream is rejected
+	{
+		memory_source source(saved.data(), saved.size() - 1);
+		BOOST_CHECK_THROW(cache_t c(source), hash_exception);
+		BOOST_ASSERT(!cache_t::is_loaded(0));
+	}
+
+	fs::remove(cachePath);
+
+	// a DAG loaded from a lent mapping of a file points at the pages of the file
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	{
+		unique_ptr<mmap_source> source(new mmap_source("data/egihash.dag", true));
+		shared_ptr<void const> const mapping = source->view_owner();
+		dag_t const d(*source);
+		source.reset();
+		size_t const items_offset = constants::DAG_FILE_HEADER_SIZE + cache_t::get_cache_size(0);
+		BOOST_CHECK(reinterpret_cast<uint8_t const *>(d.data().data()) == (reinterpret_cast<uint8_t const *>(mapping.get()) + items_offset));
+		check_epoch0_vector(full::hash(d, headerhash, 0));
+		d.unload();
+	}
+}
+
+// test that loading a DAG file shares its embedded cache with the cache cache
+BOOST_AUTO_TEST_CASE(dag_file_cache_registration)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	for (auto const epoch : cache_t::get_loaded())
+	{
+		cache_t(epoch * constants::EPOCH_LENGTH).unload();
+	}
+
+	bool cache_loaded = false;
+	auto loading = [&cache_loaded](::std::size_t, ::std::size_t, int phase) -> bool
+	{
+		cache_loaded = cache_loaded || (phase == cache_loading);
+		return true;
+	};
+	auto never = [](::std::size_t, ::std::size_t, int) -> bool
+	{
+		return false;
+	};
+
+	// the embedded cache is loaded from the DAG file and registered
+	{
+		dag_t d("data/egihash.dag", loading);
+		BOOST_ASSERT(cache_loaded);
+		BOOST_ASSERT(cache_t::is_loaded(0));
+		cache_t c(0, never);
+		BOOST_ASSERT(c.data().data() == d.get_cache().data().data());
+		d.unload();
+	}
+
+	// unloading the DAG also unloads its cache
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+
+	// an already registered cache is reused instead of being loaded again
+	{
+		cache_t c(0, dag_progress);
+		cache_loaded = false;
+		dag_t d("data/egihash.dag", loading);
+		BOOST_ASSERT(!cache_loaded);
+		BOOST_ASSERT(c.data().data() == d.get_cache().data().data());
+		d.unload();
+	}
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+}
+
+// test hashing with a DAG which is still being loaded
+BOOST_AUTO_TEST_CASE(progressive_dag_loading)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+
+	// hold loading half way through until the test has hashed with a partial DAG
+	size_t const item_count = dag_t::get_full_size(0) / constants::HASH_BYTES;
+	atomic<bool> release(false);
+	auto paused = [&](::std::size_t step, ::std::size_t, int phase) -> bool
+	{
+		while ((phase == dag_loading) && (step >= (item_count / 2)) && !release)
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+		return true;
+	};
+
+	progressive_dag_t const progressive("data/egihash.dag", paused);
+	BOOST_ASSERT(progressive.epoch() == 0);
+	while (progressive.ready_items() < (item_count / 2))
+	{
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	BOOST_ASSERT(!progressive.is_ready());
+	BOOST_ASSERT(progressive.ready_items() < item_count);
+
+	h256_t const header_hash = epoch0_header_hash();
+	auto check = [&]()
+	{
+		check_epoch0_vector(full::hash(progressive, header_hash, 0));
+	};
+	check();
+
+	release = true;
+	dag_t const d = progressive.wait();
+	BOOST_ASSERT(progressive.is_ready());
+	BOOST_ASSERT(progressive.ready_items() == item_count);
+	BOOST_ASSERT(dag_t::is_loaded(0));
+	check();
+	BOOST_CHECK(full::hash(d, header_hash, 0) == full::hash(progressive, header_hash, 0));
+
+	// a DAG which is already loaded is complete straight away
+	progressive_dag_t const loaded(0);
+	BOOST_ASSERT(loaded.wait().get_cache().data().data() == d.get_cache().data().data());
+	d.unload();
+}
+
+// test that background DAG generation keeps to the rate it is throttled to
+BOOST_AUTO_TEST_CASE(progressive_dag_throttling)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(progressive_dag_t::get_throttle_policy().mode == throttle_none);
+
+	auto const wait_until = [](function<bool ()> const & condition)
+	{
+		auto const deadline = chrono::steady_clock::now() + chrono::seconds(60);
+		while (!condition() && (chrono::steady_clock::now() < deadline))
+		{
+			this_thread::sleep_for(chrono::milliseconds(10));
+		}
+		return condition();
+	};
+
+	double const target = 5000;
+	progressive_dag_t::set_throttle_policy(throttle_policy_t{ throttle_items_per_second, target, 0, 0 });
+	{
+		progressive_dag_t const progressive(0);
+		BOOST_REQUIRE(wait_until([&]() { return progressive.ready_items() > (4 * constants::CALLBACK_FREQUENCY); }));
+		this_thread::sleep_for(chrono::milliseconds(200));
+		throttle_stats_t const stats = progressive.throttle_stats();
+		BOOST_CHECK(stats.target_items_per_second == target);
+		BOOST_CHECK(stats.items_per_second <= (target * 1.5));
+		BOOST_CHECK(stats.duty_cycle > 0);
+		BOOST_CHECK(stats.duty_cycle < 1);
+		BOOST_CHECK(stats.bytes_per_second > stats.items_per_second);
+		BOOST_CHECK(!progressive.is_ready());
+
+		// a DAG loaded meanwhile is not held up behind the generation
+		progressive_dag_t const loading("data/egihash.dag");
+		BOOST_REQUIRE(wait_until([&]() { return loading.is_ready(); }));
+		BOOST_CHECK(!progressive.is_ready());
+
+		// the hashes of foreground work are counted, and correct while generation is held back
+		dag_t const d = loading.wait();
+		h256_t const header_hash = epoch0_header_hash();
+		BOOST_CHECK(full::hash(progressive, header_hash, 0) == full::hash(d, header_hash, 0));
+		d.unload();
+	}
+
+	// a fraction of the bandwidth is relative to a rate measured once generation starts
+	progressive_dag_t::set_throttle_policy(throttle_policy_t{ throttle_bandwidth_fraction, 0, 0.25, 0.05 });
+	{
+		progressive_dag_t const progressive(0);
+		BOOST_CHECK(wait_until([&]() { return progressive.throttle_stats().target_items_per_second > 0; }));
+		BOOST_CHECK(progressive.throttle_stats().duty_cycle < 1);
+	}
+	progressive_dag_t::set_throttle_policy(throttle_policy_t{ throttle_none, 0, 0, 0 });
+
+	// loading from a file is not paced
+	progressive_dag_t const loaded("data/egihash.dag");
+	dag_t const d = loaded.wait();
+	BOOST_CHECK(loaded.throttle_stats().items_per_second == 0);
+	BOOST_CHECK(loaded.throttle_stats().duty_cycle == 0);
+	d.unload();
+}
+
+// test allocating caches and DAGs in huge pages, whichever kind this system provides
+BOOST_AUTO_TEST_CASE(huge_page_backing)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+	BOOST_ASSERT(dag_t::get_page_mode() == pages_normal);
+	BOOST_ASSERT(cache_t::get_page_mode() == pages_normal);
+
+	h256_t normal_checksum;
+	{
+		cache_t const c(0, dag_progress);
+		BOOST_CHECK(c.backing() == page_backing_normal);
+		normal_checksum = h256_t(c.data().data(), c.data().size_bytes());
+		c.unload();
+	}
+
+	cache_t::set_page_mode(pages_huge);
+	dag_t::set_page_mode(pages_huge);
+	{
+		dag_t const d("data/egihash.dag", dag_progress);
+		BOOST_TEST_MESSAGE("DAG page backing: " << d.backing() << ", cache page backing: " << d.get_cache().backing());
+		BOOST_CHECK(h256_t(d.get_cache().data().data(), d.get_cache().data().size_bytes()) == normal_checksum);
+
+		check_epoch0_vector(full::hash(d, epoch0_header_hash(), 0));
+		d.unload();
+	}
+	cache_t::set_page_mode(pages_normal);
+	dag_t::set_page_mode(pages_normal);
+}
+
+// test storing caches and DAGs through a custom allocator, and adopting DAG data owned by the caller
+BOOST_AUTO_TEST_CASE(dag_allocator_adopt)
+{
+	using namespace std;
+	using namespace egihash;
+
+	struct counting_allocator_t : allocator_t
+	{
+		void * allocate(size_t bytes, page_mode mode, page_backing & backing) override
+		{
+			allocated += bytes;
+			return allocator_t::get_page_allocator()->allocate(bytes, mode, backing);
+		}
+
+		void deallocate(void * memory, size_t bytes, page_backing backing) noexcept override
+		{
+			deallocated += bytes;
+			allocator_t::get_page_allocator()->deallocate(memory, bytes, backing);
+		}
+
+		atomic<size_t> allocated{0};
+		atomic<size_t> deallocated{0};
+	};
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+
+	auto const allocator = make_shared<counting_allocator_t>();
+	dag_t::set_allocator(allocator);
+	cache_t::set_allocator(allocator);
+	vector<node> items;
+	{
+		dag_t const d("data/egihash.dag", dag_progress);
+		BOOST_CHECK(allocator->allocated == (d.size() + cache_t::get_cache_size(0)));
+		items.assign(d.data().data(), d.data().data() + (d.size() / sizeof(node)));
+		d.unload();
+	}
+	dag_t::set_allocator(nullptr);
+	cache_t::set_allocator(nullptr);
+	BOOST_CHECK(allocator->deallocated == allocator->allocated);
+	BOOST_CHECK(dag_t::get_allocator() == allocator_t::get_page_allocator());
+
+	// items of the wrong size are refused, but still released
+	size_t released = 0;
+	auto const release = [&released](void *, size_t bytes) { released += bytes; };
+	BOOST_CHECK_THROW(dag_t(0, items.data(), sizeof(node), release, dag_progress), hash_exception);
+	BOOST_CHECK(released == sizeof(node));
+
+	released = 0;
+	{
+		dag_t const d(0, items.data(), items.size() * sizeof(node), release, dag_progress);
+		BOOST_CHECK(d.data().data() == items.data());
+
+		check_epoch0_vector(full::hash(d, epoch0_header_hash(), 0));
+		d.unload();
+		BOOST_CHECK(released == 0);
+	}
+	BOOST_CHECK(released == (items.size() * sizeof(node)));
+}
+
+// test sharing a DAG through POSIX shared memory, a DAG which was unloaded but is still referenced stands in for another process
+BOOST_AUTO_TEST_CASE(dag_shared_memory)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(dag_t::get_shared_memory_prefix().empty());
+
+	string const prefix = "/egihash-test-" + to_string(random_device{}());
+	fs::path const segment = fs::path("/dev/shm") / (prefix.substr(1) + "-0");
+	dag_t::set_shared_memory_prefix(prefix);
+	{
+		dag_t const creator("data/egihash.dag", dag_progress);
+		BOOST_CHECK(fs::exists(segment));
+		creator.unload();
+		BOOST_CHECK(!dag_t::is_loaded(0));
+
+		// the items are mapped from the segment the creator built rather than loaded again
+		dag_t const mapped("data/egihash.dag", dag_progress);
+		BOOST_CHECK(mapped.data().data() != creator.data().data());
+		BOOST_CHECK(std::memcmp(mapped.data().data(), creator.data().data(), mapped.size()) == 0);
+
+		check_epoch0_vector(full::hash(mapped, epoch0_header_hash(), 0));
+		mapped.unload();
+		BOOST_CHECK(fs::exists(segment));
+	}
+	BOOST_CHECK(!fs::exists(segment));
+
+	// a process which exits while it maps the segment does not keep the segment alive
+	{
+		dag_t const creator("data/egihash.dag", dag_progress);
+		creator.unload();
+		pid_t const child = ::fork();
+		BOOST_REQUIRE(child >= 0);
+		if (child == 0)
+		{
+			dag_t const mapped("data/egihash.dag");
+			::_exit((mapped.data().data() != creator.data().data()) ? 0 : 1);
+		}
+		int status = 0;
+		BOOST_REQUIRE(::waitpid(child, &status, 0) == child);
+		BOOST_CHECK(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+		BOOST_CHECK(fs::exists(segment));
+	}
+	BOOST_CHECK(!fs::exists(segment));
+	dag_t::set_shared_memory_prefix("");
+}
+
+// test NUMA replication and interleaving of a DAG on a fake two node topology
+BOOST_AUTO_TEST_CASE(numa_placement)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(dag_t::get_numa_policy().mode == numa_local);
+	BOOST_CHECK(dag_t::get_numa_node_count() >= 1);
+
+	for (auto const mode : { numa_replicate, numa_interleave })
+	{
+		dag_t::set_numa_policy({ mode, 2 });
+		BOOST_CHECK(dag_t::get_numa_node_count() == 2);
+		{
+			dag_t const d("data/egihash.dag", dag_progress);
+			BOOST_CHECK(d.replica_count() == ((mode == numa_replicate) ? 2u : 1u));
+
+			check_epoch0_vector(full::hash(d, epoch0_header_hash(), 0));
+			d.unload();
+		}
+	}
+	dag_t::set_numa_policy({ numa_local, 0 });
+}
+
+// test locking DAGs and caches in memory and querying their residency
+BOOST_AUTO_TEST_CASE(memory_lock_residency)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	BOOST_ASSERT(!cache_t::is_loaded(0));
+	BOOST_ASSERT(dag_t::get_lock_mode() == lock_none);
+	BOOST_ASSERT(cache_t::get_lock_mode() == lock_none);
+
+	dag_t::set_lock_mode(lock_preferred);
+	cache_t::set_lock_mode(lock_preferred);
+	{
+		dag_t const d("data/egihash.dag", dag_progress);
+		residency_t const dag_residency = d.residency();
+		residency_t const cache_residency = d.get_cache().residency();
+		BOOST_TEST_MESSAGE("DAG locked: " << dag_residency.locked << ", cache locked: " << cache_residency.locked);
+		BOOST_CHECK(dag_residency.total_bytes == d.size());
+		BOOST_CHECK(cache_residency.total_bytes == cache_t::get_cache_size(0));
+
+		// everything was just written, and locked pages can not have been reclaimed since
+		BOOST_CHECK(dag_residency.resident_bytes > 0);
+		BOOST_CHECK(cache_residency.resident_bytes > 0);
+		BOOST_CHECK(!dag_residency.locked || (dag_residency.resident_bytes == dag_residency.total_bytes));
+		BOOST_CHECK(!cache_residency.locked || (cache_residency.resident_bytes == cache_residency.total_bytes));
+		d.unload();
+	}
+	dag_t::set_lock_mode(lock_none);
+	cache_t::set_lock_mode(lock_none);
+}
+
+// test discovery, quota pruning and warm restart of a dag_store
+BOOST_AUTO_TEST_CASE(dag_store_directory)
+{
+	using namespace std;
+	using namespace egihash;
+
+	fs::path const storePath = fs::current_path() / "data" / "store";
+	fs::remove_all(storePath);
+
+	size_t const cacheFileSize0 = constants::CACHE_FILE_HEADER_SIZE + cache_t::get_cache_size(0);
+	size_t const cacheFileSize1 = constants::CACHE_FILE_HEADER_SIZE + cache_t::get_cache_size(constants::EPOCH_LENGTH);
+	{
+		dag_store store(storePath.string());
+		BOOST_ASSERT(store.entries().empty());
+		cache_t c0 = store.get_cache(0, dag_progress);
+		cache_t c1 = store.get_cache(1, dag_progress);
+		BOOST_ASSERT(store.contains(dag_store::cache_file, 0));
+		BOOST_ASSERT(store.contains(dag_store::cache_file, 1));
+		BOOST_ASSERT(!store.contains(dag_store::dag_file, 0));
+		BOOST_ASSERT(store.usage() == (cacheFileSize0 + cacheFileSize1));
+		BOOST_ASSERT(fs::exists(store.path(dag_store::cache_file, 1)));
+		store.record_resident();
+		c0.unload();
+		c1.unload();
+	}
+
+	// files which are not part of the store, including some of epochs too far out to be checked, and an abandoned partial write
+	ofstream(( storePath / "unrelated.cache" ).string()).put('x');
+	ofstream(( storePath / "egihash-0-0000000000000000.cache" ).string()).put('x');
+	ofstream(( storePath / "egihash-2000000-0000000000000000.cache" ).string()).put('x');
+	ofstream(( storePath / "egihash-99999999999-0000000000000000.dag" ).string()).put('x');
+	ofstream(( storePath / ".egihash-2-0000000000000000.cache.999999999.tmp" ).string()).put('x');
+
+	// a new store discovers existing files and warms the resident epochs
+	dag_store store(storePath.string());
+	auto const entries = store.entries();
+	BOOST_REQUIRE(entries.size() == 2);
+	BOOST_ASSERT((entries[0].epoch == 0) && (entries[1].epoch == 1));
+	BOOST_ASSERT(!fs::exists(storePath / ".egihash-2-0000000000000000.cache.999999999.tmp"));
+	BOOST_ASSERT((store.resident(dag_store::cache_file) == vector<uint64_t>{0, 1}));
+
+	BOOST_ASSERT(!cache_t::is_loaded(0) && !cache_t::is_loaded(1));
+	store.warm().get();
+	BOOST_ASSERT(cache_t::is_loaded(0) && cache_t::is_loaded(1));
+
+	// enforcing a quota prunes the oldest epoch
+	store.set_quota(cacheFileSize1);
+	BOOST_ASSERT(!store.contains(dag_store::cache_file, 0));
+	BOOST_ASSERT(store.contains(dag_store::cache_file, 1));
+	BOOST_ASSERT(!fs::exists(store.path(dag_store::cache_file, 0)));
+
+	// newer epochs are not pruned to make room for an older one
+	BOOST_CHECK(!store.store(cache_t(0)));
+	BOOST_ASSERT(!store.contains(dag_store::cache_file, 0));
+	BOOST_ASSERT(!fs::exists(store.path(dag_store::cache_file, 0)));
+	BOOST_ASSERT(store.contains(dag_store::cache_file, 1));
+
+	// a save which is cancelled leaves the store as it was
+	size_t const cacheFileSize2 = constants::CACHE_FILE_HEADER_SIZE + cache_t::get_cache_size(2 * constants::EPOCH_LENGTH);
+	store.set_quota(cacheFileSize2);
+	cache_t const c2(2 * constants::EPOCH_LENGTH);
+	BOOST_CHECK_THROW(store.store(c2, [](::std::size_t, ::std::size_t, int) { return false; }), hash_exception);
+	BOOST_ASSERT(!store.contains(dag_store::cache_file, 2));
+	BOOST_ASSERT(store.contains(dag_store::cache_file, 1));
+	BOOST_ASSERT(fs::exists(store.path(dag_store::cache_file, 1)));
+
+	// storing a newer epoch prunes older ones once it has been written
+	BOOST_CHECK(store.store(c2));
+	BOOST_ASSERT(store.contains(dag_store::cache_file, 2));
+	BOOST_ASSERT(!store.contains(dag_store::cache_file, 1));
+	BOOST_ASSERT(!fs::exists(store.path(dag_store::cache_file, 1)));
+	BOOST_ASSERT(store.usage() <= store.quota());
+
+	cache_t(0).unload();
+	cache_t(constants::EPOCH_LENGTH).unload();
+	c2.unload();
+	fs::remove_all(storePath);
+}
+
+// test the multi-threaded nonce search against single nonce hashes
+BOOST_AUTO_TEST_CASE(full_search)
+{
+	using namespace std;
+	using namespace egihash;
+
+	h256_t const low = HashFromHex("00000000000000000000000000000000ffffffffffffffffffffffffffffffff");
+	h256_t const high = HashFromHex("0000000000000001000000000000000000000000000000000000000000000000");
+	BOOST_ASSERT(meets_boundary(low, high));
+	BOOST_ASSERT(!meets_boundary(high, low));
+	BOOST_ASSERT(meets_boundary(high, high));
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	dag_t dag("data/egihash.dag", dag_progress);
+
+	// roughly one in eight nonces meets this boundary
+	h256_t const header_hash = epoch0_header_hash();
+	h256_t const boundary = HashFromHex("1fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+	uint64_t const start_nonce = 1000;
+	uint64_t const count = 1500;
+
+	vector<uint64_t> expected;
+	for (uint64_t nonce = start_nonce; nonce < (start_nonce + count); nonce++)
+	{
+		if (meets_boundary(full::hash(dag, header_hash, nonce).value, boundary))
+		{
+			expected.push_back(nonce);
+		}
+	}
+	BOOST_REQUIRE(!expected.empty());
+
+	auto const solutions = full::search(dag, header_hash, start_nonce, count, boundary, 4);
+	BOOST_REQUIRE(solutions.size() == expected.size());
+	for (size_t i = 0; i < solutions.size(); i++)
+	{
+		BOOST_CHECK(solutions[i].nonce == expected[i]);
+		BOOST_CHECK(solutions[i].header_hash == header_hash);
+		BOOST_CHECK(solutions[i].result == full::hash(dag, header_hash, solutions[i].nonce));
+	}
+
+	// a new job replaces one which is still running
+	full::search_t engine(dag, 2);
+	BOOST_ASSERT(engine.threads() == 2);
+	engine.set_job(header_hash, 0, numeric_limits<uint64_t>::max(), boundary);
+	engine.set_job(header_hash, start_nonce, count, HashFromHex("0000000000000000000000000000000000000000000000000000000000000000"));
+	engine.wait();
+	full::solution_t solution;
+	while (engine.pop(solution))
+	{
+		// only the replaced job can have found solutions
+		BOOST_CHECK(meets_boundary(solution.result.value, boundary));
+	}
+	BOOST_CHECK(engine.hash_count() >= count);
+
+	// an unbounded job keeps running, and its hashes are counted before any chunk of it is finished
+	uint64_t const hashed = engine.hash_count();
+	engine.set_job(header_hash, 0, numeric_limits<uint64_t>::max(), boundary);
+	BOOST_CHECK(!engine.wait_for(chrono::milliseconds(200)));
+	for (size_t i = 0; (i < 100) && (engine.hash_count() == hashed); i++)
+	{
+		this_thread::sleep_for(chrono::milliseconds(50));
+	}
+	BOOST_CHECK(engine.hash_count() > hashed);
+	BOOST_CHECK(!engine.wait_for(chrono::milliseconds(0)));
+	engine.stop();
+	engine.wait();
+	dag.unload();
+}
+
+// test that work is shared out across a thread pool
+BOOST_AUTO_TEST_CASE(thread_pool_tasks)
+{
+	using namespace std;
+	using namespace egihash;
+
+	thread_pool_t pool(thread_pool_options_t{ 3, 1, {}, smt_all });
+	BOOST_ASSERT(pool.size() == 3);
+
+	vector<uint64_t> values(1000, 0);
+	pool.parallel_for(values.size(), [&values](size_t i) { values[i] = i * i; });
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		BOOST_CHECK(values[i] == i * i);
+	}
+
+	BOOST_CHECK_THROW(pool.parallel_for(100, [](size_t i) { if (i == 42) throw hash_exception("task failed"); }), hash_exception);
+
+	// tasks may share out their own work on the pool they run on, and background tasks run alongside
+	atomic<size_t> nested(0);
+	atomic<bool> background(false);
+	mutex done_mutex;
+	condition_variable done;
+	size_t finished = 0;
+	auto const finish = [&]()
+	{
+		lock_guard<mutex> lock(done_mutex);
+		finished++;
+		done.notify_all();
+	};
+	pool.submit([&]()
+	{
+		pool.parallel_for(64, [&nested](size_t) { nested++; });
+		finish();
+	});
+	pool.submit([&]()
+	{
+		background = true;
+		finish();
+	}, priority_background);
+	{
+		unique_lock<mutex> lock(done_mutex);
+		done.wait(lock, [&finished]() { return finished == 2; });
+	}
+	BOOST_CHECK(nested == 64);
+	BOOST_CHECK(background);
+
+	thread_pool_t const cores(thread_pool_options_t{ 0, 0, {}, smt_one_per_core });
+	BOOST_CHECK(cores.size() >= 1);
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	dag_t dag("data/egihash.dag", dag_progress);
+	h256_t const header_hash = epoch0_header_hash();
+	h256_t const boundary = HashFromHex("1fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+	auto const expected = full::search(dag, header_hash, 0, 500, boundary, 1);
+	auto const solutions = full::search(dag, header_hash, 0, 500, boundary, 0, cores);
+	BOOST_REQUIRE(solutions.size() == expected.size());
+	for (size_t i = 0; i < solutions.size(); i++)
+	{
+		BOOST_CHECK(solutions[i].nonce == expected[i].nonce);
+	}
+	dag.unload();
+
+	// progressive DAGs are built by a background task of the pool they are given
+	thread::id background_thread;
+	pool.submit([&]()
+	{
+		background_thread = this_thread::get_id();
+		finish();
+	}, priority_background);
+	{
+		unique_lock<mutex> lock(done_mutex);
+		done.wait(lock, [&finished]() { return finished == 3; });
+	}
+	thread::id build_thread;
+	progressive_dag_t const loading("data/egihash.dag", [&build_thread](size_t, size_t, int)
+	{
+		build_thread = this_thread::get_id();
+		return true;
+	}, pool);
+	loading.wait().unload();
+	BOOST_CHECK(build_thread == background_thread);
+}
+
+// test that batched full hashes match single full hashes
+BOOST_AUTO_TEST_CASE(full_hash_batch)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	dag_t dag("data/egihash.dag", dag_progress);
+
+	// not a multiple of the number of lanes, so the last batch is partially filled
+	h256_t const header_hash = epoch0_header_hash();
+	vector<uint64_t> nonces;
+	for (uint64_t i = 0; i < ((constants::HASH_BATCH_LANES * 2) + 5); i++)
+	{
+		nonces.push_back((i * 0x9e3779b97f4a7c15ULL) ^ i);
+	}
+
+	vector<result_t> results(nonces.size());
+	full::hash_batch(dag, header_hash, nonces.data(), nonces.size(), results.data());
+	for (size_t i = 0; i < nonces.size(); i++)
+	{
+		BOOST_CHECK(results[i] == full::hash(dag, header_hash, nonces[i]));
+	}
+
+	uint64_t const nonce = 0;
+	result_t result;
+	full::hash_batch(dag, header_hash, &nonce, 1, &result);
+	check_epoch0_vector(result);
+
+	dag.unload();
+}
+
+// test batch verification with the full DAG and with the light cache
+BOOST_AUTO_TEST_CASE(verify_batch_submissions)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+
+	h256_t const header_hash = epoch0_header_hash();
+	h256_t const zero = HashFromHex("0000000000000000000000000000000000000000000000000000000000000000");
+	cache_t const cache1(constants::EPOCH_LENGTH, dag_progress);
+
+	// epoch 0 and epoch 1 submissions interleaved, each either valid, with a wrong mixhash or missing its boundary
+	vector<submission_t> submissions;
+	vector<bool> expected;
+	for (uint64_t i = 0; i < 60; i++)
+	{
+		submission_t submission;
+		submission.block_number = ((i % 2) == 0) ? 17 : (constants::EPOCH_LENGTH + 5);
+		submission.header_hash = header_hash;
+		submission.nonce = i * 7919;
+		result_t const actual = ((i % 2) == 0) ? light::hash(cache_t(0), header_hash, submission.nonce) : light::hash(cache1, header_hash, submission.nonce);
+		submission.mixhash = ((i % 3) == 1) ? zero : actual.mixhash;
+		submission.boundary = ((i % 3) == 2) ? zero : actual.value;
+		submissions.push_back(submission);
+		expected.push_back((i % 3) == 0);
+	}
+
+	auto check = [&](vector<verification_t> const & verifications)
+	{
+		BOOST_REQUIRE(verifications.size() == submissions.size());
+		for (size_t i = 0; i < submissions.size(); i++)
+		{
+			BOOST_CHECK(verifications[i].valid == expected[i]);
+			if (expected[i])
+			{
+				BOOST_CHECK(verifications[i].computed);
+				BOOST_CHECK(verifications[i].result.value == submissions[i].boundary);
+			}
+
+			// a zero boundary fails the quick check, so the hash is never computed
+			if ((i % 3) == 2)
+			{
+				BOOST_CHECK(!verifications[i].computed);
+			}
+		}
+	};
+
+	// no DAG is loaded, so every epoch is checked with its cache
+	BOOST_ASSERT(!dag_t::is_loaded(0));
+	check(verify_batch(submissions.data(), submissions.size(), 3));
+
+	// epoch 0 is checked with the full DAG once it is loaded
+	dag_t dag("data/egihash.dag", dag_progress);
+	check(verify_batch(submissions.data(), submissions.size(), 3));
+	check(verify_batch(submissions.data(), submissions.size()));
+	BOOST_CHECK(verify_batch(submissions.data(), 0).empty());
+
+	dag.unload();
+	cache1.unload();
+}
+
+// test the quick check of a claimed mixhash against a boundary
+BOOST_AUTO_TEST_CASE(quick_check_boundary)
+{
+	using namespace std;
+	using namespace egihash;
+
+	h256_t const header_hash = epoch0_header_hash();
+	h256_t const value = HashFromHex("fbf6ec7e3b9d667583f260d7c6b1eaf46092438c5e67533d612e045e3b7a294a");
+	h256_t const mixhash = HashFromHex("57560655785659264cd68c6835c6e8faa5e7c134f4fe18ae869c22b37707b04f");
+	h256_t const below = HashFromHex("fbf6ec7e3b9d667583f260d7c6b1eaf46092438c5e67533d612e045e3b7a2949");
+	h256_t const zero = HashFromHex("0000000000000000000000000000000000000000000000000000000000000000");
+
+	BOOST_CHECK(quick_check(header_hash, 0, mixhash, value));
+	BOOST_CHECK(!quick_check(header_hash, 0, mixhash, below));
+	BOOST_CHECK(!quick_check(header_hash, 0, zero, zero));
+
+	// a submission that misses its boundary is rejected with the value implied by its mixhash
+	submission_t submission;
+	submission.block_number = 0;
+	submission.header_hash = header_hash;
+	submission.nonce = 0;
+	submission.mixhash = mixhash;
+	submission.boundary = below;
+	auto const verifications = verify_batch(&submission, 1);
+	BOOST_REQUIRE(verifications.size() == 1);
+	BOOST_CHECK(!verifications[0].valid);
+	BOOST_CHECK(!verifications[0].computed);
+	BOOST_CHECK(verifications[0].result.value == value);
+	BOOST_CHECK(verifications[0].result.mixhash == mixhash);
+}
+
+// test memoizing hashes by epoch, header hash and nonce
+BOOST_AUTO_TEST_CASE(hash_result_cache)
+{
+	using namespace std;
+	using namespace egihash;
+
+	BOOST_REQUIRE_MESSAGE(boost::filesystem::exists("data/egihash.dag"), "DAG file not generated yet. Please re-run test case.");
+	BOOST_ASSERT(get_result_cache_stats().capacity == 0);
+
+	h256_t const header_hash = epoch0_header_hash();
+	cache_t const cache(0, dag_progress);
+	result_t const expected = light::hash(cache, header_hash, 0);
+
+	set_result_cache_size(32);
+	result_cache_stats_t stats = get_result_cache_stats();
+	BOOST_CHECK(stats.capacity == 32);
+	BOOST_CHECK((stats.hits == 0) && (stats.misses == 0) && (stats.size == 0));
+	BOOST_CHECK(light::hash(cache, header_hash, 0) == expected);
+	BOOST_CHECK(light::hash(cache, header_hash, 0) == expected);
+	stats = get_result_cache_stats();
+	BOOST_CHECK((stats.hits == 1) && (stats.misses == 1) && (stats.size == 1));
+
+	// full hashes and batches of the same epoch share the results
+	dag_t const dag("data/egihash.dag", dag_progress);
+	BOOST_CHECK(full::hash(dag, header_hash, 0) == expected);
+	submission_t submission;
+	submission.block_number = 0;
+	submission.header_hash = header_hash;
+	submission.nonce = 0;
+	submission.mixhash = expected.mixhash;
+	submission.boundary = expected.value;
+	auto const verifications = verify_batch(&submission, 1);
+	BOOST_REQUIRE(verifications.size() == 1);
+	BOOST_CHECK(verifications[0].valid);
+	BOOST_CHECK(verifications[0].computed);
+	BOOST_CHECK(verifications[0].result == expected);
+	BOOST_CHECK(get_result_cache_stats().hits == 3);
+
+	// the result cache holds no more than its capacity
+	for (uint64_t nonce = 1; nonce <= 100; nonce++)
+	{
+		BOOST_CHECK(full::hash(dag, header_hash, nonce) == full::hash(dag, header_hash, nonce));
+	}
+	stats = get_result_cache_stats();
+	BOOST_CHECK(stats.size <= stats.capacity);
+	BOOST_CHECK(stats.hits >= 103);
+
+	// capacities smaller than the number of shards are not rounded up
+	set_result_cache_size(1);
+	for (uint64_t nonce = 1; nonce <= 20; nonce++)
+	{
+		full::hash(dag, header_hash, nonce);
+	}
+	stats = get_result_cache_stats();
+	BOOST_CHECK(stats.capacity == 1);
+	BOOST_CHECK(stats.size == 1);
+
+	set_result_cache_size(0);
+	stats = get_result_cache_stats();
+	BOOST_CHECK((stats.hits == 0) && (stats.misses == 0) && (stats.size == 0) && (stats.capacity == 0));
+
+	// hashes may key unordered containers
+	unordered_set<h256_t> const hashes = { expected.value, expected.mixhash, expected.value };
+	BOOST_CHECK(hashes.size() == 2);
+	dag.unload();
+}
+
+// test memoizing DAG items for light hashes
+BOOST_AUTO_TEST_CASE(light_item_cache)
+{
+	using namespace std;
+	using namespace egihash;
+
+	cache_t const cache(0, dag_progress);
+	BOOST_ASSERT(cache.get_item_cache_stats().capacity == 0);
+
+	h256_t const header_hash = epoch0_header_hash();
+	auto check = [&]()
+	{
+		check_epoch0_vector(light::hash(cache, header_hash, 0));
+	};
+
+	cache.set_item_cache_size(4);
+	auto stats = cache.get_item_cache_stats();
+	BOOST_ASSERT(stats.capacity > 0);
+	BOOST_ASSERT((stats.hits == 0) && (stats.misses == 0));
+
+	uint64_t const items_per_hash = (constants::ACCESSES * constants::MIX_BYTES) / constants::HASH_BYTES;
+	check();
+	stats = cache.get_item_cache_stats();
+	BOOST_CHECK((stats.hits + stats.misses) == items_per_hash);
+
+	// a repeated hash finds its items, apart from any which collided with each other
+	check();
+	stats = cache.get_item_cache_stats();
+	BOOST_CHECK((stats.hits + stats.misses) == (2 * items_per_hash));
+	BOOST_CHECK(stats.hits >= (items_per_hash - 16));
+
+	// a memoized item is identical to a computed one
+	node computed[constants::HASH_WORDS], memoized[constants::HASH_WORDS];
+	cache.set_item_cache_size(0);
+	cache.dataset_item(12345, computed);
+	cache.set_item_cache_size(1);
+	cache.dataset_item(12345, memoized);
+	cache.dataset_item(12345, memoized);
+	BOOST_CHECK(cache.get_item_cache_stats().hits == 1);
+	BOOST_CHECK(memcmp(computed, memoized, sizeof(computed)) == 0);
+
+	cache.set_item_cache_size(0);
+	BOOST_ASSERT(cache.get_item_cache_stats().capacity == 0);
+	check();
+	cache.unload();
+}
+
+BOOST_AUTO_TEST_CASE(lazy_dag_budget)
+{
+	using namespace std;
+	using namespace egihash;
+
+	lazy_dag_t const dag(0, 1024 * 1024, dag_progress);
+	BOOST_ASSERT(dag.epoch() == 0);
+	BOOST_ASSERT(dag.size() == dag_t::get_full_size(0));
+	auto stats = dag.get_stats();
+	BOOST_ASSERT((stats.hits == 0) && (stats.misses == 0) && (stats.resident_bytes == 0));
+	BOOST_ASSERT(stats.budget_bytes == (1024 * 1024));
+
+	h256_t const header_hash = epoch0_header_hash();
+	auto check = [&]()
+	{
+		check_epoch0_vector(full::hash(dag, header_hash, 0));
+	};
+
+	uint64_t const items_per_hash = (constants::ACCESSES * constants::MIX_BYTES) / constants::HASH_BYTES;
+	check();
+	stats = dag.get_stats();
+	BOOST_CHECK((stats.hits + stats.misses) == items_per_hash);
+	BOOST_CHECK(stats.resident_bytes > 0);
+
+	// a repeated hash finds all of its items resident
+	check();
+	stats = dag.get_stats();
+	BOOST_CHECK(stats.hits >= items_per_hash);
+	BOOST_CHECK(stats.evictions == 0);
+
+	// hashing more than fits in the budget releases pages, without changing any results
+	cache_t const cache = dag.get_cache();
+	for (uint64_t nonce = 1; nonce < 32; nonce++)
+	{
+		BOOST_CHECK(full::hash(dag, header_hash, nonce) == light::hash(cache, header_hash, nonce));
+	}
+	stats = dag.get_stats();
+	BOOST_CHECK(stats.evictions > 0);
+	BOOST_CHECK(stats.resident_bytes <= stats.budget_bytes);
+
+	// a resident item is identical to a computed one
+	node computed[constants::HASH_WORDS], resident[constants::HASH_WORDS];
+	cache.dataset_item(12345, computed);
+	dag.dataset_item(12345, resident);
+	dag.dataset_item(12345, resident);
+	BOOST_CHECK(memcmp(computed, resident, sizeof(computed)) == 0);
+
+	// shrinking the budget releases pages straight away
+	dag.set_budget(0);
+	stats = dag.get_stats();
+	BOOST_CHECK(stats.resident_bytes <= stats.budget_bytes);
+	check();
+	cache.unload();
+}
+
+// test remainders by a fixed divisor against the division they replace, with and without 128-bit integers
+BOOST_AUTO_TEST_CASE(fast_divisor_remainders)
+{
+	using namespace std;
+	using namespace egihash;
+
+	uint32_t const max_dividend = numeric_limits<uint32_t>::max();
+	vector<uint32_t> const divisors = { 1, 2, 3, 7, 1024, 65537, 262139, 8388593, 2147483647u, 2147483648u, 4294967279u, 4294967291u, max_dividend };
+	mt19937 random(42);
+	for (auto const d : divisors)
+	{
+		fast_divisor_t const divisor(d);
+		BOOST_CHECK(divisor.value() == d);
+
+		vector<uint32_t> dividends = { 0, 1, d - 1, d, max_dividend - 1, max_dividend };
+		if (d != max_dividend)
+		{
+			dividends.push_back(d + 1);
+		}
+		for (int i = 0; i < 1000; i++)
+		{
+			dividends.push_back(static_cast<uint32_t>(random()));
+		}
+		for (auto const n : dividends)
+		{
+			BOOST_CHECK_MESSAGE(divisor.mod(n) == (n % d), n << " % " << d);
+			BOOST_CHECK_MESSAGE(divisor.mod_split(n) == (n % d), n << " % " << d);
+		}
+	}
+}
+
+// sizes from the epoch size table and sizes computed beyond it agree with the definition
+BOOST_AUTO_TEST_CASE(epoch_sizes)
+{
+	using namespace std;
+	using namespace egihash;
+
+	auto is_prime = [](uint64_t x)
+	{
+		for (uint64_t i = 2; (i * i) <= x; i++)
+		{
+			if ((x % i) == 0) return false;
+		}
+		return x >= 2;
+	};
+
+	for (uint64_t const epoch : { 0, 1, 100, 1000, 2047, 2048, 2049, 5000, 100000 })
+	{
+		uint64_t const block_number = epoch * constants::EPOCH_LENGTH;
+
+		uint64_t cache_size = (constants::CACHE_BYTES_INIT + (constants::CACHE_BYTES_GROWTH * epoch)) - constants::HASH_BYTES;
+		while (!is_prime(cache_size / constants::HASH_BYTES))
+		{
+			cache_size -= (2 * constants::HASH_BYTES);
+		}
+		BOOST_CHECK_MESSAGE(cache_t::get_cache_size(block_number) == cache_size, "\nepoch=" << epoch);
+
+		uint64_t full_size = (constants::DATASET_BYTES_INIT + (constants::DATASET_BYTES_GROWTH * epoch)) - constants::MIX_BYTES;
+		while (!is_prime(full_size / constants::MIX_BYTES))
+		{
+			full_size -= (2 * constants::MIX_BYTES);
+		}
+		BOOST_CHECK_MESSAGE(dag_t::get_full_size(block_number) == full_size, "\nepoch=" << epoch);
+	}
+
+	cache_t const cache(0, dag_progress);
+	BOOST_CHECK(cache.full_size() == dag_t::get_full_size(0));
+	cache.unload();
+}
+
+// seedhashes are remembered, and can be mapped back to their epoch
+BOOST_AUTO_TEST_CASE(seedhash_epochs)
+{
+	using namespace std;
+	using namespace egihash;
+
+	h256_t seedhash;
+	memcpy(&seedhash.b[0], epoch0_seedhash, size_epoch0_seedhash);
+	for (uint64_t epoch = 0; epoch < 64; epoch++)
+	{
+		BOOST_CHECK(cache_t::get_seedhash((epoch * constants::EPOCH_LENGTH) + (epoch % 7)) == seedhash);
+		BOOST_CHECK(cache_t::get_epoch(seedhash) == epoch);
+		seedhash = h256_t(&seedhash.b[0], seedhash.hash_size);
+	}
+
+	// epochs not seen yet are searched for
+	h256_t const last = cache_t::get_seedhash((constants::SEEDHASH_SEARCH_EPOCHS - 1) * constants::EPOCH_LENGTH);
+	BOOST_CHECK(cache_t::get_epoch(last) == (constants::SEEDHASH_SEARCH_EPOCHS - 1));
+	BOOST_CHECK_THROW(cache_t::get_epoch(HashFromHex("9fa68736cb13eb975356e1f9abd403219557b3b9ec5b3d483130c12ced9efd82")), hash_exception);
+
+	cache_t::precompute_seedhashes(constants::SEEDHASH_SEARCH_EPOCHS + 16);
+	h256_t const beyond = cache_t::get_seedhash((constants::SEEDHASH_SEARCH_EPOCHS + 8) * constants::EPOCH_LENGTH);
+	BOOST_CHECK(cache_t::get_epoch(beyond) == (constants::SEEDHASH_SEARCH_EPOCHS + 8));
+
+	// hashing forward to an epoch far beyond the remembered ones does not hold up lookups of other epochs
+	chrono::steady_clock::duration walk_time{};
+	thread walker([&walk_time]()
+	{
+		auto const start = chrono::steady_clock::now();
+		cache_t::get_seedhash(uint64_t(2000000) * constants::EPOCH_LENGTH);
+		walk_time = chrono::steady_clock::now() - start;
+	});
+	this_thread::sleep_for(chrono::milliseconds(200));
+	auto const start = chrono::steady_clock::now();
+	BOOST_CHECK(cache_t::get_seedhash(constants::EPOCH_LENGTH) == cache_t::get_seedhash(constants::EPOCH_LENGTH + 1));
+	BOOST_CHECK(cache_t::get_epoch(last) == (constants::SEEDHASH_SEARCH_EPOCHS - 1));
+	auto const lookup_time = chrono::steady_clock::now() - start;
+	walker.join();
+	BOOST_CHECK(lookup_time < (walk_time / 2));
+}
+
 BOOST_AUTO_TEST_SUITE_END();